@@ -39,6 +39,7 @@
 #include <wx/config.h>
 #include <wx/utils.h>
 #include <wx/stdpaths.h>
+#include <wx/thread.h>
 
 #include <pgm_base.h>
 
@@ -68,6 +69,23 @@ std::atomic<unsigned int> LOCALE_IO::m_c_count(0);
 
 LOCALE_IO::LOCALE_IO()
 {
+    m_thread_only = !wxThread::IsMain();
+
+    if( m_thread_only )
+    {
+        // setlocale() is process wide: calling it from a worker thread would change
+        // the number format of the GUI thread at any time.  Switch only this thread.
+#if defined( _WIN32 )
+        m_thread_config = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
+        m_user_locale = setlocale( LC_ALL, 0 );
+        setlocale( LC_ALL, "C" );
+#else
+        m_c_locale = newlocale( LC_ALL_MASK, "C", (locale_t) 0 );
+        m_prev_locale = uselocale( m_c_locale );
+#endif
+        return;
+    }
+
     // use thread safe, atomic operation
     if( m_c_count++ == 0 )
     {
@@ -80,6 +98,18 @@ LOCALE_IO::LOCALE_IO()
 
 LOCALE_IO::~LOCALE_IO()
 {
+    if( m_thread_only )
+    {
+#if defined( _WIN32 )
+        setlocale( LC_ALL, m_user_locale.c_str() );
+        _configthreadlocale( m_thread_config );
+#else
+        uselocale( m_prev_locale );
+        freelocale( m_c_locale );
+#endif
+        return;
+    }
+
     // use thread safe, atomic operation
     if( --m_c_count == 0 )
     {
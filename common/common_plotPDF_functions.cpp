@@ -432,6 +432,20 @@ void PDF_PLOTTER::closePdfObject()
  * content.
  */
 int PDF_PLOTTER::startPdfStream(int handle)
+{
+    handle = startPdfStreamObject( handle );
+
+    // Open a temporary file to accumulate the stream
+    openWorkFile( filename + wxT(".tmp") );
+    return handle;
+}
+
+
+/**
+ * Writes the header of a stream object, whose length is deferred to the
+ * next object. Returns the object handle opened
+ */
+int PDF_PLOTTER::startPdfStreamObject( int handle )
 {
     wxASSERT( outputFile );
     wxASSERT( !workFile );
@@ -444,18 +458,46 @@ int PDF_PLOTTER::startPdfStream(int handle)
              "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
              "stream\n", handle + 1 );
 
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
+    return handle;
+}
+
+
+PDF_PLOTTER::~PDF_PLOTTER()
+{
+    // Emergency cleanup, the stream is usually closed (and its temporary file
+    // removed) by compressWorkFile()
+    if( workFile )
+    {
+        fclose( workFile );
+        ::wxRemoveFile( workFilename );
+    }
+}
+
+
+/**
+ * Open the temporary file used to accumulate the page stream, after
+ * computing the paper size of the page
+ */
+void PDF_PLOTTER::openWorkFile( const wxString& aWorkFilename )
+{
+    wxASSERT( !workFile );
+
+    // Compute the paper size in IUs
+    paperSize = pageInfo.GetSizeMils();
+    paperSize.x *= 10.0 / iuPerDeviceUnit;
+    paperSize.y *= 10.0 / iuPerDeviceUnit;
+
+    workFilename = aWorkFilename;
     workFile = wxFopen( workFilename, wxT( "w+b" ));
     wxASSERT( workFile );
-    return handle;
 }
 
 
 /**
- * Finish the current PDF stream (writes the deferred length, too)
+ * Close the temporary file of the current stream, and returns its content
+ * DEFLATEd
  */
-void PDF_PLOTTER::closePdfStream()
+std::string PDF_PLOTTER::compressWorkFile()
 {
     wxASSERT( workFile );
 
@@ -464,7 +506,7 @@ void PDF_PLOTTER::closePdfStream()
     if( stream_len < 0 )
     {
         wxASSERT( false );
-        return;
+        return std::string();
     }
 
     // Rewind the file, read in the page stream and DEFLATE it
@@ -501,9 +543,28 @@ void PDF_PLOTTER::closePdfStream()
 
     wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
 
-    unsigned out_count = sb->Tell();
+    return std::string( (const char*) sb->GetBufferStart(), sb->Tell() );
+}
+
+
+/**
+ * Finish the current PDF stream (writes the deferred length, too)
+ */
+void PDF_PLOTTER::closePdfStream()
+{
+    closePdfStreamObject( compressWorkFile() );
+}
+
+
+/**
+ * Write the DEFLATEd data of the stream opened by startPdfStreamObject,
+ * close it and write its deferred length
+ */
+void PDF_PLOTTER::closePdfStreamObject( const std::string& aStream )
+{
+    unsigned out_count = aStream.size();
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
+    fwrite( aStream.data(), 1, out_count, outputFile );
 
     fputs( "endstream\n", outputFile );
     closePdfObject();
@@ -522,18 +583,20 @@ void PDF_PLOTTER::StartPage()
     wxASSERT( outputFile );
     wxASSERT( !workFile );
 
-    // Compute the paper size in IUs
-    paperSize = pageInfo.GetSizeMils();
-    paperSize.x *= 10.0 / iuPerDeviceUnit;
-    paperSize.y *= 10.0 / iuPerDeviceUnit;
-
     // Open the content stream; the page object will go later
     pageStreamHandle = startPdfStream();
 
     /* Now, until ClosePage *everything* must be wrote in workFile, to be
        compressed later in closePdfStream */
+    startPageContent();
+}
 
-    // Default graphic settings (coordinate system, default color and line style)
+/**
+ * Write the default graphic settings (coordinate system, default color
+ * and line style) at the start of the page content
+ */
+void PDF_PLOTTER::startPageContent()
+{
     fprintf( workFile,
              "%g 0 0 %g 0 0 cm 1 J 1 j 0 0 0 rg 0 0 0 RG %g w\n",
              0.0072 * plotScaleAdjX, 0.0072 * plotScaleAdjY,
@@ -550,7 +613,15 @@ void PDF_PLOTTER::ClosePage()
     // Close the page stream (and compress it)
     closePdfStream();
 
-    // Emit the page object and put it in the page list for later
+    emitPageObject();
+}
+
+/**
+ * Emit the page object of the current page stream and put it in the page
+ * list for later
+ */
+void PDF_PLOTTER::emitPageObject()
+{
     pageHandles.push_back( startPdfObject() );
 
     /* Page size is in 1/72 of inch (default user space units)
@@ -583,12 +654,49 @@ void PDF_PLOTTER::ClosePage()
     pageStreamHandle = 0;
 }
 
+
+void PDF_PLOTTER::StartPageStream( const wxString& aWorkFilename )
+{
+    wxASSERT( !outputFile );
+
+    openWorkFile( aWorkFilename );
+    startPageContent();
+}
+
+
+std::string PDF_PLOTTER::ClosePageStream()
+{
+    return compressWorkFile();
+}
+
+
+void PDF_PLOTTER::AddPage( const std::string& aPageStream )
+{
+    wxASSERT( !workFile );
+
+    pageStreamHandle = startPdfStreamObject();
+    closePdfStreamObject( aPageStream );
+    emitPageObject();
+}
+
 /**
  * The PDF engine supports multiple pages; the first one is opened
  * 'for free' the following are to be closed and reopened. Between
  * each page parameters can be set
  */
 bool PDF_PLOTTER::StartPlot()
+{
+    StartDocument();
+
+    /* Now, the PDF is read from the end, (more or less)... so we start
+       with the page stream for page 1. Other more important stuff is written
+       at the end */
+    StartPage();
+    return true;
+}
+
+
+bool PDF_PLOTTER::StartDocument()
 {
     wxASSERT( outputFile );
 
@@ -609,10 +717,6 @@ bool PDF_PLOTTER::StartPlot()
        (it *could* be inherited via the Pages tree */
     fontResDictHandle = allocPdfObject();
 
-    /* Now, the PDF is read from the end, (more or less)... so we start
-       with the page stream for page 1. Other more important stuff is written
-       at the end */
-    StartPage();
     return true;
 }
 
@@ -621,8 +725,9 @@ bool PDF_PLOTTER::EndPlot()
 {
     wxASSERT( outputFile );
 
-    // Close the current page (often the only one)
-    ClosePage();
+    // Close the current page (often the only one), unless the pages were added
+    if( workFile )
+        ClosePage();
 
     /* We need to declare the resources we're using (fonts in particular)
        The useful standard one is the Helvetica family. Adding external fonts
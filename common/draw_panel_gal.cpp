@@ -59,6 +59,7 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     m_painter    = NULL;
     m_eventDispatcher = NULL;
     m_lostFocus  = false;
+    m_showRenderStats = false;
 
     SetLayoutDirection( wxLayout_LeftToRight );
 
@@ -79,6 +80,11 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     m_view->SetPainter( m_painter );
     m_view->SetGAL( m_gal );
 
+    // Big boards take several frames to redraw, the canvas stays responsive meanwhile.
+    // The frames show the previous image scaled, for the layers not redrawn yet, so this
+    // needs a GAL able to preview it.
+    m_view->SetProgressiveRedraw( m_gal->IsTargetPreviewSupported() );
+
     Connect( wxEVT_SIZE, wxSizeEventHandler( EDA_DRAW_PANEL_GAL::onSize ), NULL, this );
     Connect( wxEVT_ENTER_WINDOW, wxEventHandler( EDA_DRAW_PANEL_GAL::onEnter ), NULL, this );
     Connect( wxEVT_KILL_FOCUS, wxFocusEventHandler( EDA_DRAW_PANEL_GAL::onLostFocus ), NULL, this );
@@ -167,6 +173,13 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 
     m_drawing = true;
     KIGFX::PCB_RENDER_SETTINGS* settings = static_cast<KIGFX::PCB_RENDER_SETTINGS*>( m_painter->GetSettings() );
+    KIGFX::RENDER_STATS& stats = m_view->GetRenderStats();
+
+    stats.BeginFrame();
+
+    // The statistics change with every frame, so the overlay they are drawn on is refreshed too
+    if( m_showRenderStats )
+        m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
 
 // Scrollbars broken in GAL on OSX
 #ifndef __WXMAC__
@@ -192,8 +205,15 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
                 m_gal->DrawGrid();
 
             m_view->Redraw();
+
+            // The remaining layers are drawn by the next paint events, so input is not blocked
+            if( m_view->IsRedrawPending() )
+                Refresh();
         }
 
+        if( m_showRenderStats )
+            drawRenderStats();
+
         m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
         m_gal->EndDrawing();
     }
@@ -215,11 +235,53 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     wxLogDebug( "EDA_DRAW_PANEL_GAL::onPaint(): %.1f ms", totalRealTime.msecs() );
 #endif /* PROFILE */
 
+    stats.EndFrame( m_gal->GetUploadedBytes() );
+
     m_lastRefresh = wxGetLocalTimeMillis();
     m_drawing = false;
 }
 
 
+void EDA_DRAW_PANEL_GAL::ShowRenderStats( bool aShow )
+{
+    m_showRenderStats = aShow;
+    m_view->GetRenderStats().SetEnabled( aShow );
+    m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+    Refresh();
+}
+
+
+void EDA_DRAW_PANEL_GAL::drawRenderStats()
+{
+    const double TEXT_SIZE = 12.0;      // in pixels
+    const double MARGIN = 10.0;         // in pixels
+
+    wxString text = m_view->GetRenderStats().FormatSummary();
+
+    if( text.IsEmpty() )
+        return;
+
+    double pixel = std::fabs( m_view->ToWorld( 1.0 ) );
+    KIGFX::RENDER_TARGET oldTarget = m_gal->GetTarget();
+
+    m_gal->SetTarget( KIGFX::TARGET_OVERLAY );
+    m_gal->SetLayerDepth( m_gal->GetMinDepth() );
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( KIGFX::COLOR4D( 1.0, 1.0, 0.0, 0.9 ) );
+    m_gal->SetLineWidth( 1.5 * pixel );
+    m_gal->SetGlyphSize( VECTOR2D( TEXT_SIZE * pixel, TEXT_SIZE * pixel ) );
+    m_gal->SetFontBold( false );
+    m_gal->SetFontItalic( false );
+    m_gal->SetTextMirrored( m_view->IsMirroredX() );
+    m_gal->SetHorizontalJustify( GR_TEXT_HJUSTIFY_LEFT );
+    m_gal->SetVerticalJustify( GR_TEXT_VJUSTIFY_TOP );
+    m_gal->StrokeText( text, m_view->ToWorld( VECTOR2D( MARGIN, MARGIN ) ), 0.0 );
+
+    m_gal->SetTarget( oldTarget );
+}
+
+
 void EDA_DRAW_PANEL_GAL::onSize( wxSizeEvent& aEvent )
 {
     m_gal->ResizeScreen( aEvent.GetSize().x, aEvent.GetSize().y );
@@ -392,7 +454,10 @@ bool EDA_DRAW_PANEL_GAL::SwitchBackend( GAL_TYPE aGalType )
         m_painter->SetGAL( m_gal );
 
     if( m_view )
+    {
         m_view->SetGAL( m_gal );
+        m_view->SetProgressiveRedraw( m_gal->IsTargetPreviewSupported() );
+    }
 
     m_backend = aGalType;
     LoadGalSettings();
@@ -0,0 +1,213 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <eda_search_index.h>
+
+#include <algorithm>
+#include <cwchar>
+#include <cwctype>
+#include <iterator>
+
+
+// The length of the indexed substrings.  Patterns requiring no string that long cannot
+// be narrowed.
+static const size_t kGramLength = 3;
+
+
+// Key of the trigram starting at aPos in aText.
+static uint64_t trigramKey( const std::wstring& aText, size_t aPos )
+{
+    return ( uint64_t( aText[aPos] & 0x1FFFFF ) << 42 )
+         | ( uint64_t( aText[aPos + 1] & 0x1FFFFF ) << 21 )
+         | uint64_t( aText[aPos + 2] & 0x1FFFFF );
+}
+
+
+void EDA_SEARCH_INDEX::AddText( unsigned aItem, const wxString& aText )
+{
+    const std::wstring text = aText.ToStdWstring();
+
+    for( size_t ii = 0; ii + kGramLength <= text.length(); ++ii )
+    {
+        std::vector<unsigned>& list = m_postings[ trigramKey( text, ii ) ];
+
+        // Items come in increasing order, so the lists stay sorted and hold an item once.
+        if( list.empty() || list.back() != aItem )
+            list.push_back( aItem );
+    }
+}
+
+
+bool EDA_SEARCH_INDEX::FindCandidates( const wxString& aPattern, MATCH_TYPE aType,
+                                       std::vector<unsigned>& aCandidates ) const
+{
+    std::vector<std::wstring> required;
+    std::vector<const std::vector<unsigned>*> lists;
+    bool narrowed = false;
+
+    aCandidates.clear();
+    RequiredStrings( aPattern, aType, required );
+
+    for( const std::wstring& str : required )
+    {
+        for( size_t ii = 0; ii + kGramLength <= str.length(); ++ii )
+        {
+            auto it = m_postings.find( trigramKey( str, ii ) );
+
+            if( it == m_postings.end() )
+                return true;        // No item has this trigram.
+
+            lists.push_back( &it->second );
+            narrowed = true;
+        }
+    }
+
+    if( !narrowed )
+        return false;
+
+    // Intersect from the shortest list, so the intermediate results stay small.
+    std::sort( lists.begin(), lists.end(),
+               []( const std::vector<unsigned>* a, const std::vector<unsigned>* b )
+               {
+                   return a->size() < b->size();
+               } );
+
+    std::vector<unsigned> next;
+
+    aCandidates = *lists[0];
+
+    for( size_t ii = 1; ii < lists.size() && !aCandidates.empty(); ++ii )
+    {
+        next.clear();
+        std::set_intersection( aCandidates.begin(), aCandidates.end(),
+                               lists[ii]->begin(), lists[ii]->end(),
+                               std::back_inserter( next ) );
+        aCandidates.swap( next );
+    }
+
+    return true;
+}
+
+
+void EDA_SEARCH_INDEX::RequiredStrings( const wxString& aPattern, MATCH_TYPE aType,
+                                        std::vector<std::wstring>& aStrings )
+{
+    const std::wstring pattern = aPattern.ToStdWstring();
+    std::wstring       run;
+
+    aStrings.clear();
+
+    auto endRun = [&]()
+    {
+        if( !run.empty() )
+            aStrings.push_back( run );
+
+        run.clear();
+    };
+
+    switch( aType )
+    {
+    case MATCH_SUBSTR:
+        aStrings.push_back( pattern );
+        break;
+
+    case MATCH_WILDCARD:
+        // Everything but the wildcards themselves is taken literally.
+        for( wchar_t c : pattern )
+        {
+            if( c == '*' || c == '?' )
+                endRun();
+            else
+                run += c;
+        }
+
+        endRun();
+        break;
+
+    case MATCH_REGEX:
+        // Only the plain runs of simple regexs are taken.  Alternatives and groups can make
+        // anything optional, and escapes of letters are classes or character codes.
+        if( pattern.find_first_of( L"|()[" ) != std::wstring::npos
+            || pattern.compare( 0, 3, L"***" ) == 0 )
+            return;
+
+        for( size_t ii = 0; ii < pattern.length(); ++ii )
+        {
+            wchar_t c = pattern[ii];
+
+            switch( c )
+            {
+            case '\\':
+                if( ii + 1 >= pattern.length() || std::iswalnum( pattern[ii + 1] ) )
+                {
+                    aStrings.clear();
+                    return;
+                }
+
+                run += pattern[++ii];
+                break;
+
+            case '.':
+            case '^':
+            case '$':
+                endRun();
+                break;
+
+            case '*':
+            case '?':
+            case '{':
+                // The previous character is optional.
+                if( !run.empty() )
+                    run.pop_back();
+
+                endRun();
+
+                if( c == '{' )
+                {
+                    ii = pattern.find( '}', ii );
+
+                    if( ii == std::wstring::npos )
+                        return;
+                }
+
+                break;
+
+            case '+':
+                // The previous character stays, unless another quantifier follows.
+                if( ii + 1 < pattern.length() && wcschr( L"*?{", pattern[ii + 1] )
+                    && !run.empty() )
+                    run.pop_back();
+
+                endRun();
+                break;
+
+            default:
+                run += c;
+                break;
+            }
+        }
+
+        endRun();
+        break;
+    }
+}
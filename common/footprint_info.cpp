@@ -191,6 +191,8 @@ bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* a
     m_error_count = 0;
     m_errors.clear();
     m_list.clear();
+    m_name_index.Clear();
+    m_name_index_valid = false;
 
     if( aNickname )
         // single footprint
@@ -261,6 +263,22 @@ bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* a
 }
 
 
+const EDA_SEARCH_INDEX& FOOTPRINT_LIST::GetNameIndex()
+{
+    if( !m_name_index_valid )
+    {
+        m_name_index.Clear();
+
+        for( unsigned ii = 0; ii < m_list.size(); ++ii )
+            m_name_index.AddText( ii, m_list[ii].GetFootprintName().Lower() );
+
+        m_name_index_valid = true;
+    }
+
+    return m_name_index;
+}
+
+
 FOOTPRINT_INFO* FOOTPRINT_LIST::GetModuleInfo( const wxString& aFootprintName )
 {
     if( aFootprintName.IsEmpty() )
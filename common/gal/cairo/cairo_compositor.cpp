@@ -31,6 +31,10 @@
 #include <gal/cairo/cairo_compositor.h>
 #include <wx/log.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 using namespace KIGFX;
 
 CAIRO_COMPOSITOR::CAIRO_COMPOSITOR( cairo_t** aMainContext ) :
@@ -66,7 +70,10 @@ void CAIRO_COMPOSITOR::Resize( unsigned int aWidth, unsigned int aHeight )
     m_height = aHeight;
 
     m_stride     = cairo_format_stride_for_width( CAIRO_FORMAT_ARGB32, m_width );
-    m_bufferSize = m_stride * m_height;
+
+    // The stride is a multiple of 4 bytes, the buffers are allocated as 32 bit pixels.
+    // stride * height is computed in size_t, as an int it overflows for large buffers.
+    m_bufferSize = (size_t) m_stride * m_height / sizeof( unsigned int );
 }
 
 
@@ -75,7 +82,7 @@ unsigned int CAIRO_COMPOSITOR::CreateBuffer()
     // Pixel storage
     BitmapPtr bitmap( new unsigned int[m_bufferSize] );
 
-    memset( bitmap.get(), 0x00, m_bufferSize * sizeof(int) );
+    memset( bitmap.get(), 0x00, m_bufferSize * sizeof( unsigned int ) );
 
     // Create the Cairo surface
     cairo_surface_t* surface = cairo_image_surface_create_for_data(
@@ -126,7 +133,7 @@ void CAIRO_COMPOSITOR::Begin()
 void CAIRO_COMPOSITOR::ClearBuffer()
 {
     // Clear the pixel storage
-    memset( m_buffers[m_current].bitmap.get(), 0x00, m_bufferSize * sizeof(int) );
+    memset( m_buffers[m_current].bitmap.get(), 0x00, m_bufferSize * sizeof( unsigned int ) );
 }
 
 
@@ -151,6 +158,90 @@ void CAIRO_COMPOSITOR::Present()
 {
 }
 
+
+void CAIRO_COMPOSITOR::ScrollBuffer( unsigned int aBufferHandle, int aDx, int aDy )
+{
+    wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
+
+    CAIRO_BUFFER&  buffer = m_buffers[aBufferHandle - 1];
+    unsigned char* pixels = (unsigned char*) buffer.bitmap.get();
+    const int      width  = m_width;
+    const int      height = m_height;
+    const int      bpp    = 4;      // CAIRO_FORMAT_ARGB32
+
+    cairo_surface_flush( buffer.surface );
+
+    if( std::abs( aDx ) >= width || std::abs( aDy ) >= height )
+    {
+        memset( pixels, 0x00, (size_t) m_stride * height );
+    }
+    else
+    {
+        const int rowBytes = ( width - std::abs( aDx ) ) * bpp;
+        const int srcX     = std::max( -aDx, 0 ) * bpp;
+        const int dstX     = std::max( aDx, 0 ) * bpp;
+
+        // Rows are copied in the direction of the move, so no row is overwritten before it is read
+        for( int i = 0; i < height - std::abs( aDy ); ++i )
+        {
+            int dstY = aDy > 0 ? height - 1 - i : i;
+            int srcY = dstY - aDy;
+            unsigned char* row = pixels + (size_t) dstY * m_stride;
+
+            memmove( row + dstX, pixels + (size_t) srcY * m_stride + srcX, rowBytes );
+
+            // Clear the uncovered columns
+            if( aDx > 0 )
+                memset( row, 0x00, dstX );
+            else if( aDx < 0 )
+                memset( row + rowBytes, 0x00, -aDx * bpp );
+        }
+
+        // Clear the uncovered rows
+        if( aDy > 0 )
+            memset( pixels, 0x00, (size_t) m_stride * aDy );
+        else if( aDy < 0 )
+            memset( pixels + (size_t) ( height + aDy ) * m_stride, 0x00, (size_t) m_stride * -aDy );
+    }
+
+    cairo_surface_mark_dirty( buffer.surface );
+}
+
+
+void CAIRO_COMPOSITOR::CopyBuffer( unsigned int aSourceHandle, unsigned int aDestHandle )
+{
+    wxASSERT_MSG( aSourceHandle <= usedBuffers() && aDestHandle <= usedBuffers(),
+                  wxT( "Tried to use a not existing buffer" ) );
+
+    CAIRO_BUFFER& source = m_buffers[aSourceHandle - 1];
+    CAIRO_BUFFER& dest   = m_buffers[aDestHandle - 1];
+
+    cairo_surface_flush( source.surface );
+    cairo_surface_flush( dest.surface );
+    memcpy( dest.bitmap.get(), source.bitmap.get(), m_bufferSize * sizeof( unsigned int ) );
+    cairo_surface_mark_dirty( dest.surface );
+}
+
+
+void CAIRO_COMPOSITOR::DrawScaledBuffer( unsigned int aBufferHandle, double aScale,
+                                         double aOffsetX, double aOffsetY )
+{
+    wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
+
+    cairo_get_matrix( m_mainContext, &m_matrix );
+    cairo_identity_matrix( m_mainContext );
+    cairo_translate( m_mainContext, aOffsetX, aOffsetY );
+    cairo_scale( m_mainContext, aScale, aScale );
+
+    // The scaled buffer is only shown until it is redrawn, so speed matters more than quality
+    cairo_set_source_surface( m_mainContext, m_buffers[aBufferHandle - 1].surface, 0.0, 0.0 );
+    cairo_pattern_set_filter( cairo_get_source( m_mainContext ), CAIRO_FILTER_FAST );
+    cairo_paint( m_mainContext );
+
+    cairo_set_matrix( m_mainContext, &m_matrix );
+}
+
+
 void CAIRO_COMPOSITOR::clean()
 {
     CAIRO_BUFFERS::const_iterator it;
@@ -33,8 +33,10 @@
 #include <gal/cairo/cairo_compositor.h>
 #include <gal/definitions.h>
 #include <geometry/shape_poly_set.h>
+#include <macros.h>
 
 #include <limits>
+#include <thread>
 
 #include <pixman.h>
 
@@ -42,68 +44,38 @@ using namespace KIGFX;
 
 
 
-CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
-        wxEvtHandler* aPaintListener, const wxString& aName ) :
-    wxWindow( aParent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxEXPAND, aName )
+CAIRO_GAL_BASE::CAIRO_GAL_BASE()
 {
-    parentWindow  = aParent;
-    mouseListener = aMouseListener;
-    paintListener = aPaintListener;
-
     // Initialize the flags
     isGrouping          = false;
     isInitialized       = false;
     isDeleteSavedPixels = false;
     validCompositor     = false;
+    isPartialRedraw     = false;
+    isPreviewShown      = false;
+    previewScale        = 1.0;
     groupCounter        = 0;
 
-    // Connecting the event handlers
-    Connect( wxEVT_PAINT,       wxPaintEventHandler( CAIRO_GAL::onPaint ) );
-
-    // Mouse events are skipped to the parent
-    Connect( wxEVT_MOTION,          wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_LEFT_DOWN,       wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_LEFT_UP,         wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_LEFT_DCLICK,     wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_MIDDLE_DOWN,     wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_MIDDLE_UP,       wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_MIDDLE_DCLICK,   wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_RIGHT_DOWN,      wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_RIGHT_UP,        wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_RIGHT_DCLICK,    wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-    Connect( wxEVT_MOUSEWHEEL,      wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-#if defined _WIN32 || defined _WIN64
-    Connect( wxEVT_ENTER_WINDOW,    wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
-#endif
-
-    SetSize( aParent->GetSize() );
-    screenSize = VECTOR2I( aParent->GetSize() );
-
-    cursorPixels = NULL;
-    cursorPixelsSaved = NULL;
-    initCursor();
+    bitmapBuffer        = NULL;
+    bitmapBufferBackup  = NULL;
+    useBackupBuffer     = true;
 
     // Grid color settings are different in Cairo and OpenGL
     SetGridColor( COLOR4D( 0.1, 0.1, 0.1, 0.8 ) );
-
-    // Allocate memory for pixel storage
-    allocateBitmaps();
 }
 
 
-CAIRO_GAL::~CAIRO_GAL()
+CAIRO_GAL_BASE::~CAIRO_GAL_BASE()
 {
     deinitSurface();
     deleteBitmaps();
-
-    delete cursorPixels;
-    delete cursorPixelsSaved;
+    deleteLayerSurfaces();
 
     ClearCache();
 }
 
 
-void CAIRO_GAL::BeginDrawing()
+void CAIRO_GAL_BASE::BeginDrawing()
 {
     initSurface();
 
@@ -115,43 +87,26 @@ void CAIRO_GAL::BeginDrawing()
 }
 
 
-void CAIRO_GAL::EndDrawing()
+void CAIRO_GAL_BASE::EndDrawing()
 {
     // Force remaining objects to be drawn
     Flush();
 
     // Merge buffers on the screen
-    compositor->DrawBuffer( mainBuffer );
-    compositor->DrawBuffer( overlayBuffer );
-
-    // Now translate the raw context data from the format stored
-    // by cairo into a format understood by wxImage.
-    pixman_image_t* dstImg = pixman_image_create_bits(PIXMAN_r8g8b8,
-            screenSize.x, screenSize.y, (uint32_t*)wxOutput, wxBufferWidth * 3 );
-    pixman_image_t* srcImg = pixman_image_create_bits(PIXMAN_a8b8g8r8,
-            screenSize.x, screenSize.y, (uint32_t*)bitmapBuffer, wxBufferWidth * 4 );
-
-    pixman_image_composite (PIXMAN_OP_SRC, srcImg, NULL, dstImg,
-            0, 0, 0, 0, 0, 0, screenSize.x, screenSize.y );
-
-    // Free allocated memory
-    pixman_image_unref( srcImg );
-    pixman_image_unref( dstImg );
-
-    wxImage img( wxBufferWidth, screenSize.y, (unsigned char*) wxOutput, true );
-    wxBitmap bmp( img );
-    wxMemoryDC mdc( bmp );
-    wxClientDC clientDC( this );
+    if( isPreviewShown )
+        compositor->DrawScaledBuffer( previewBuffer, previewScale,
+                                      previewOffset.x, previewOffset.y );
+    else
+        compositor->DrawBuffer( mainBuffer );
 
-    // Now it is the time to blit the mouse cursor
-    blitCursor( mdc );
-    clientDC.Blit( 0, 0, screenSize.x, screenSize.y, &mdc, 0, 0, wxCOPY );
+    compositor->DrawBuffer( overlayBuffer );
 
+    // The composited image stays in bitmapBuffer after the surface is gone
     deinitSurface();
 }
 
 
-void CAIRO_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void CAIRO_GAL_BASE::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
     cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
@@ -160,8 +115,8 @@ void CAIRO_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint
 }
 
 
-void CAIRO_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
-                             double aWidth )
+void CAIRO_GAL_BASE::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                                  double aWidth )
 {
     if( isFillEnabled )
     {
@@ -202,7 +157,7 @@ void CAIRO_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPo
 }
 
 
-void CAIRO_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+void CAIRO_GAL_BASE::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
 {
     cairo_new_sub_path( currentContext );
     cairo_arc( currentContext, aCenterPoint.x, aCenterPoint.y, aRadius, 0.0, 2 * M_PI );
@@ -211,8 +166,8 @@ void CAIRO_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
 }
 
 
-void CAIRO_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
-                         double aEndAngle )
+void CAIRO_GAL_BASE::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                              double aEndAngle )
 {
     SWAP( aStartAngle, >, aEndAngle );
 
@@ -238,7 +193,7 @@ void CAIRO_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aS
 }
 
 
-void CAIRO_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void CAIRO_GAL_BASE::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     // Calculate the diagonal points
     VECTOR2D diagonalPointA( aEndPoint.x,  aStartPoint.y );
@@ -256,15 +211,52 @@ void CAIRO_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 }
 
 
-void CAIRO_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+void CAIRO_GAL_BASE::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
 {
     for( int i = 0; i < aPolySet.OutlineCount(); ++i )
         drawPoly( aPolySet.COutline( i ) );
 }
 
 
-void CAIRO_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
-                           const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
+void CAIRO_GAL_BASE::DrawGlyphs( const GLYPH_RUN& aGlyphs )
+{
+    // Filling is done separately for every stroke
+    if( isFillEnabled )
+    {
+        GAL::DrawGlyphs( aGlyphs );
+        return;
+    }
+
+    // Collect all the strokes in a single path, so it is stroked only once
+    bool empty = true;
+
+    for( const std::pair<const GLYPH*, VECTOR2D>& glyph : aGlyphs )
+    {
+        const VECTOR2D& offset = glyph.second;
+
+        for( const std::deque<VECTOR2D>& stroke : *glyph.first )
+        {
+            std::deque<VECTOR2D>::const_iterator it = stroke.begin();
+
+            cairo_move_to( currentContext, it->x + offset.x, it->y + offset.y );
+
+            for( ++it; it != stroke.end(); ++it )
+                cairo_line_to( currentContext, it->x + offset.x, it->y + offset.y );
+
+            empty = false;
+        }
+    }
+
+    if( empty )
+        return;
+
+    flushPath();
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                                const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
 {
     cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
     cairo_curve_to( currentContext, aControlPointA.x, aControlPointA.y, aControlPointB.x,
@@ -276,41 +268,29 @@ void CAIRO_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControl
 }
 
 
-void CAIRO_GAL::ResizeScreen( int aWidth, int aHeight )
+void CAIRO_GAL_BASE::ResizeScreen( int aWidth, int aHeight )
 {
     screenSize = VECTOR2I( aWidth, aHeight );
 
     // Recreate the bitmaps
     deleteBitmaps();
     allocateBitmaps();
+    deleteLayerSurfaces();
 
     if( validCompositor )
         compositor->Resize( aWidth, aHeight );
 
     validCompositor = false;
-
-    SetSize( wxSize( aWidth, aHeight ) );
 }
 
 
-bool CAIRO_GAL::Show( bool aShow )
-{
-    bool s = wxWindow::Show( aShow );
-
-    if( aShow )
-        wxWindow::Raise();
-
-    return s;
-}
-
-
-void CAIRO_GAL::Flush()
+void CAIRO_GAL_BASE::Flush()
 {
     storePath();
 }
 
 
-void CAIRO_GAL::ClearScreen( const COLOR4D& aColor )
+void CAIRO_GAL_BASE::ClearScreen( const COLOR4D& aColor )
 {
     backgroundColor = aColor;
     cairo_set_source_rgb( currentContext, aColor.r, aColor.g, aColor.b );
@@ -319,7 +299,7 @@ void CAIRO_GAL::ClearScreen( const COLOR4D& aColor )
 }
 
 
-void CAIRO_GAL::SetIsFill( bool aIsFillEnabled )
+void CAIRO_GAL_BASE::SetIsFill( bool aIsFillEnabled )
 {
     storePath();
     isFillEnabled = aIsFillEnabled;
@@ -334,7 +314,7 @@ void CAIRO_GAL::SetIsFill( bool aIsFillEnabled )
 }
 
 
-void CAIRO_GAL::SetIsStroke( bool aIsStrokeEnabled )
+void CAIRO_GAL_BASE::SetIsStroke( bool aIsStrokeEnabled )
 {
     storePath();
     isStrokeEnabled = aIsStrokeEnabled;
@@ -349,7 +329,7 @@ void CAIRO_GAL::SetIsStroke( bool aIsStrokeEnabled )
 }
 
 
-void CAIRO_GAL::SetStrokeColor( const COLOR4D& aColor )
+void CAIRO_GAL_BASE::SetStrokeColor( const COLOR4D& aColor )
 {
     storePath();
     strokeColor = aColor;
@@ -367,7 +347,7 @@ void CAIRO_GAL::SetStrokeColor( const COLOR4D& aColor )
 }
 
 
-void CAIRO_GAL::SetFillColor( const COLOR4D& aColor )
+void CAIRO_GAL_BASE::SetFillColor( const COLOR4D& aColor )
 {
     storePath();
     fillColor = aColor;
@@ -385,7 +365,7 @@ void CAIRO_GAL::SetFillColor( const COLOR4D& aColor )
 }
 
 
-void CAIRO_GAL::SetLineWidth( double aLineWidth )
+void CAIRO_GAL_BASE::SetLineWidth( double aLineWidth )
 {
     storePath();
 
@@ -409,7 +389,7 @@ void CAIRO_GAL::SetLineWidth( double aLineWidth )
 }
 
 
-void CAIRO_GAL::SetLayerDepth( double aLayerDepth )
+void CAIRO_GAL_BASE::SetLayerDepth( double aLayerDepth )
 {
     super::SetLayerDepth( aLayerDepth );
 
@@ -418,7 +398,7 @@ void CAIRO_GAL::SetLayerDepth( double aLayerDepth )
 }
 
 
-void CAIRO_GAL::Transform( const MATRIX3x3D& aTransformation )
+void CAIRO_GAL_BASE::Transform( const MATRIX3x3D& aTransformation )
 {
     cairo_matrix_t cairoTransformation;
 
@@ -434,7 +414,7 @@ void CAIRO_GAL::Transform( const MATRIX3x3D& aTransformation )
 }
 
 
-void CAIRO_GAL::Rotate( double aAngle )
+void CAIRO_GAL_BASE::Rotate( double aAngle )
 {
     storePath();
 
@@ -452,7 +432,7 @@ void CAIRO_GAL::Rotate( double aAngle )
 }
 
 
-void CAIRO_GAL::Translate( const VECTOR2D& aTranslation )
+void CAIRO_GAL_BASE::Translate( const VECTOR2D& aTranslation )
 {
     storePath();
 
@@ -471,7 +451,7 @@ void CAIRO_GAL::Translate( const VECTOR2D& aTranslation )
 }
 
 
-void CAIRO_GAL::Scale( const VECTOR2D& aScale )
+void CAIRO_GAL_BASE::Scale( const VECTOR2D& aScale )
 {
     storePath();
 
@@ -490,7 +470,7 @@ void CAIRO_GAL::Scale( const VECTOR2D& aScale )
 }
 
 
-void CAIRO_GAL::Save()
+void CAIRO_GAL_BASE::Save()
 {
     storePath();
 
@@ -507,7 +487,7 @@ void CAIRO_GAL::Save()
 }
 
 
-void CAIRO_GAL::Restore()
+void CAIRO_GAL_BASE::Restore()
 {
     storePath();
 
@@ -524,7 +504,7 @@ void CAIRO_GAL::Restore()
 }
 
 
-int CAIRO_GAL::BeginGroup()
+int CAIRO_GAL_BASE::BeginGroup()
 {
     initSurface();
 
@@ -542,7 +522,7 @@ int CAIRO_GAL::BeginGroup()
 }
 
 
-void CAIRO_GAL::EndGroup()
+void CAIRO_GAL_BASE::EndGroup()
 {
     storePath();
     isGrouping = false;
@@ -551,57 +531,75 @@ void CAIRO_GAL::EndGroup()
 }
 
 
-void CAIRO_GAL::DrawGroup( int aGroupNumber )
+void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
+{
+    storePath();
+
+    GROUP_STATE state = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+
+    drawGroup( currentContext, aGroupNumber, state );
+
+    isFillEnabled   = state.isFillEnabled;
+    isStrokeEnabled = state.isStrokeEnabled;
+    fillColor       = state.fillColor;
+    strokeColor     = state.strokeColor;
+}
+
+
+void CAIRO_GAL_BASE::drawGroup( cairo_t* aContext, int aGroupNumber, GROUP_STATE& aState ) const
 {
     // This method implements a small Virtual Machine - all stored commands
     // are executed; nested calling is also possible
+    std::map<int, GROUP>::const_iterator group = groups.find( aGroupNumber );
 
-    storePath();
+    if( group == groups.end() )
+        return;
 
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
+    for( GROUP::const_iterator it = group->second.begin(); it != group->second.end(); ++it )
     {
         switch( it->command )
         {
         case CMD_SET_FILL:
-            isFillEnabled = it->argument.boolArg;
+            aState.isFillEnabled = it->argument.boolArg;
             break;
 
         case CMD_SET_STROKE:
-            isStrokeEnabled = it->argument.boolArg;
+            aState.isStrokeEnabled = it->argument.boolArg;
             break;
 
         case CMD_SET_FILLCOLOR:
-            fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
-                                 it->argument.dblArg[3] );
+            aState.fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1],
+                                        it->argument.dblArg[2], it->argument.dblArg[3] );
             break;
 
         case CMD_SET_STROKECOLOR:
-            strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
-                                   it->argument.dblArg[3] );
+            aState.strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1],
+                                          it->argument.dblArg[2], it->argument.dblArg[3] );
             break;
 
         case CMD_SET_LINE_WIDTH:
             {
                 // Make lines appear at least 1 pixel wide, no matter of zoom
                 double x = 1.0, y = 1.0;
-                cairo_device_to_user_distance( currentContext, &x, &y );
+                cairo_device_to_user_distance( aContext, &x, &y );
                 double minWidth = std::min( fabs( x ), fabs( y ) );
-                cairo_set_line_width( currentContext, std::max( it->argument.dblArg[0], minWidth ) );
+                cairo_set_line_width( aContext, std::max( it->argument.dblArg[0], minWidth ) );
             }
             break;
 
 
         case CMD_STROKE_PATH:
-            cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g, strokeColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
+            cairo_set_source_rgb( aContext, aState.strokeColor.r, aState.strokeColor.g,
+                                  aState.strokeColor.b );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_stroke( aContext );
             break;
 
         case CMD_FILL_PATH:
-            cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
+            cairo_set_source_rgb( aContext, aState.fillColor.r, aState.fillColor.g,
+                                  aState.fillColor.b );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_fill( aContext );
             break;
 
             /*
@@ -609,39 +607,39 @@ void CAIRO_GAL::DrawGroup( int aGroupNumber )
             cairo_matrix_t matrix;
             cairo_matrix_init( &matrix, it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
                                it->argument.dblArg[3], it->argument.dblArg[4], it->argument.dblArg[5] );
-            cairo_transform( currentContext, &matrix );
+            cairo_transform( aContext, &matrix );
             break;
             */
 
         case CMD_ROTATE:
-            cairo_rotate( currentContext, it->argument.dblArg[0] );
+            cairo_rotate( aContext, it->argument.dblArg[0] );
             break;
 
         case CMD_TRANSLATE:
-            cairo_translate( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            cairo_translate( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
             break;
 
         case CMD_SCALE:
-            cairo_scale( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            cairo_scale( aContext, it->argument.dblArg[0], it->argument.dblArg[1] );
             break;
 
         case CMD_SAVE:
-            cairo_save( currentContext );
+            cairo_save( aContext );
             break;
 
         case CMD_RESTORE:
-            cairo_restore( currentContext );
+            cairo_restore( aContext );
             break;
 
         case CMD_CALL_GROUP:
-            DrawGroup( it->argument.intArg );
+            drawGroup( aContext, it->argument.intArg, aState );
             break;
         }
     }
 }
 
 
-void CAIRO_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
+void CAIRO_GAL_BASE::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     storePath();
 
@@ -659,14 +657,14 @@ void CAIRO_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 }
 
 
-void CAIRO_GAL::ChangeGroupDepth( int aGroupNumber, int aDepth )
+void CAIRO_GAL_BASE::ChangeGroupDepth( int aGroupNumber, int aDepth )
 {
     // Cairo does not have any possibilities to change the depth coordinate of stored items,
     // it depends only on the order of drawing
 }
 
 
-void CAIRO_GAL::DeleteGroup( int aGroupNumber )
+void CAIRO_GAL_BASE::DeleteGroup( int aGroupNumber )
 {
     storePath();
 
@@ -686,7 +684,7 @@ void CAIRO_GAL::DeleteGroup( int aGroupNumber )
 }
 
 
-void CAIRO_GAL::ClearCache()
+void CAIRO_GAL_BASE::ClearCache()
 {
     for( int i = groups.size() - 1; i >= 0; --i )
     {
@@ -695,8 +693,11 @@ void CAIRO_GAL::ClearCache()
 }
 
 
-void CAIRO_GAL::SaveScreen()
+void CAIRO_GAL_BASE::SaveScreen()
 {
+    if( !bitmapBufferBackup )
+        return;
+
     // Copy the current bitmap to the backup buffer
     int offset = 0;
 
@@ -711,8 +712,11 @@ void CAIRO_GAL::SaveScreen()
 }
 
 
-void CAIRO_GAL::RestoreScreen()
+void CAIRO_GAL_BASE::RestoreScreen()
 {
+    if( !bitmapBufferBackup )
+        return;
+
     int offset = 0;
 
     for( int j = 0; j < screenSize.y; j++ )
@@ -726,7 +730,7 @@ void CAIRO_GAL::RestoreScreen()
 }
 
 
-void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
+void CAIRO_GAL_BASE::SetTarget( RENDER_TARGET aTarget )
 {
     // If the compositor is not set, that means that there is a recaching process going on
     // and we do not need the compositor now
@@ -754,13 +758,13 @@ void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
 }
 
 
-RENDER_TARGET CAIRO_GAL::GetTarget() const
+RENDER_TARGET CAIRO_GAL_BASE::GetTarget() const
 {
     return currentTarget;
 }
 
 
-void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
+void CAIRO_GAL_BASE::ClearTarget( RENDER_TARGET aTarget )
 {
     // Save the current state
     unsigned int currentBuffer = compositor->GetBuffer();
@@ -786,20 +790,222 @@ void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 }
 
 
-void CAIRO_GAL::SetCursorSize( unsigned int aCursorSize )
+void CAIRO_GAL_BASE::BeginPartialRedraw( const BOX2I& aArea )
 {
-    GAL::SetCursorSize( aCursorSize );
-    initCursor();
+    SetTarget( TARGET_NONCACHED );
+
+    // The clip region is given in screen pixels, so the world transformation is suspended
+    cairo_matrix_t matrix;
+
+    cairo_save( currentContext );
+    cairo_get_matrix( currentContext, &matrix );
+    cairo_identity_matrix( currentContext );
+
+    cairo_rectangle( currentContext, aArea.GetX(), aArea.GetY(),
+                     aArea.GetWidth(), aArea.GetHeight() );
+    cairo_clip( currentContext );
+
+    // Clear the area, the background is painted under the buffers while compositing
+    cairo_set_operator( currentContext, CAIRO_OPERATOR_CLEAR );
+    cairo_paint( currentContext );
+    cairo_set_operator( currentContext, CAIRO_OPERATOR_OVER );
+
+    cairo_set_matrix( currentContext, &matrix );
+
+    partialRedrawArea = aArea;
+    isPartialRedraw   = true;
+}
+
+
+void CAIRO_GAL_BASE::EndPartialRedraw()
+{
+    SetTarget( TARGET_NONCACHED );
+    storePath();
+
+    cairo_restore( currentContext );
+    isPartialRedraw = false;
+
+    // Restoring the context brought back the line width from before the redraw
+    SetLineWidth( lineWidth );
+}
+
+
+bool CAIRO_GAL_BASE::ScrollTarget( RENDER_TARGET aTarget, const VECTOR2I& aDelta )
+{
+    // Only the main buffer is kept, the overlay is always drawn from scratch
+    if( !validCompositor || aTarget == TARGET_OVERLAY )
+        return false;
+
+    compositor->ScrollBuffer( mainBuffer, aDelta.x, aDelta.y );
+
+    return true;
+}
+
+
+bool CAIRO_GAL_BASE::ShowTargetPreview( RENDER_TARGET aTarget, double aScale,
+                                        const VECTOR2D& aOffset )
+{
+    if( !validCompositor || aTarget == TARGET_OVERLAY )
+        return false;
+
+    // Keep the image from before the first call, the main buffer is going to be redrawn
+    if( !isPreviewShown )
+        compositor->CopyBuffer( mainBuffer, previewBuffer );
+
+    isPreviewShown = true;
+    previewScale   = aScale;
+    previewOffset  = aOffset;
+
+    return true;
+}
+
+
+void CAIRO_GAL_BASE::HideTargetPreview()
+{
+    isPreviewShown = false;
 }
 
 
-void CAIRO_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
+bool CAIRO_GAL_BASE::IsTargetPreviewSupported() const
+{
+    return true;
+}
+
+
+bool CAIRO_GAL_BASE::IsParallelRenderingSupported() const
+{
+    return std::thread::hardware_concurrency() > 1;
+}
+
+
+void CAIRO_GAL_BASE::DrawLayerBatches( const std::vector<LAYER_BATCH>& aBatches )
+{
+    // Split the layers into consecutive runs of similar size, one per thread. Drawing the runs
+    // to separate surfaces and compositing them in order gives the same image as drawing
+    // the layers one after another.
+    size_t total = 0;
+
+    for( const LAYER_BATCH& batch : aBatches )
+        total += batch.groups.size() + batch.rects.size();
+
+    unsigned int threadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                 aBatches.size() );
+
+    if( threadCount < 2 || total < 256 || !validCompositor )
+    {
+        super::DrawLayerBatches( aBatches );
+        return;
+    }
+
+    std::vector< std::pair<size_t, size_t> > runs;     // [first, last) batch indices
+    size_t first = 0, runSize = 0;
+
+    for( size_t i = 0; i < aBatches.size(); ++i )
+    {
+        runSize += aBatches[i].groups.size() + aBatches[i].rects.size();
+
+        if( runSize * threadCount >= total * ( runs.size() + 1 ) || i == aBatches.size() - 1 )
+        {
+            runs.push_back( std::make_pair( first, i + 1 ) );
+            first = i + 1;
+        }
+    }
+
+    // Surfaces are kept between the frames, they are recreated only when the screen is resized
+    while( layerSurfaces.size() < runs.size() )
+        layerSurfaces.push_back( cairo_image_surface_create( CAIRO_FORMAT_ARGB32,
+                                                             screenSize.x, screenSize.y ) );
+
+    storePath();
+
+    BOX2I area = isPartialRedraw ? partialRedrawArea
+                                 : BOX2I( VECTOR2I( 0, 0 ), VECTOR2I( screenSize ) );
+    cairo_matrix_t matrix;
+    cairo_get_matrix( currentContext, &matrix );
+
+    GROUP_STATE initialState = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+    double lineWidthCairo = cairo_get_line_width( currentContext );
+    std::vector<GROUP_STATE> finalStates( runs.size(), initialState );
+
+    auto worker = [&]( size_t aRun )
+    {
+        cairo_t* ctx = cairo_create( layerSurfaces[aRun] );
+
+        // Clear and limit drawing to the area being redrawn
+        cairo_rectangle( ctx, area.GetX(), area.GetY(), area.GetWidth(), area.GetHeight() );
+        cairo_clip( ctx );
+        cairo_set_operator( ctx, CAIRO_OPERATOR_CLEAR );
+        cairo_paint( ctx );
+        cairo_set_operator( ctx, CAIRO_OPERATOR_OVER );
+
+        // Use the same settings as the main buffer
+        cairo_set_antialias( ctx, CAIRO_ANTIALIAS_NONE );
+        cairo_set_line_join( ctx, CAIRO_LINE_JOIN_ROUND );
+        cairo_set_line_cap( ctx, CAIRO_LINE_CAP_ROUND );
+        cairo_set_line_width( ctx, lineWidthCairo );
+        cairo_set_matrix( ctx, &matrix );
+
+        GROUP_STATE& state = finalStates[aRun];
+
+        for( size_t i = runs[aRun].first; i < runs[aRun].second; ++i )
+        {
+            for( int group : aBatches[i].groups )
+                drawGroup( ctx, group, state );
+
+            for( const std::pair<BOX2D, COLOR4D>& rect : aBatches[i].rects )
+            {
+                const COLOR4D& color = rect.second;
+                const BOX2D&   box   = rect.first;
+
+                cairo_set_source_rgb( ctx, color.r, color.g, color.b );
+                cairo_rectangle( ctx, box.GetX(), box.GetY(), box.GetWidth(), box.GetHeight() );
+                cairo_fill( ctx );
+            }
+        }
+
+        cairo_destroy( ctx );
+        cairo_surface_flush( layerSurfaces[aRun] );
+    };
+
+    std::vector<std::thread> threads;
+
+    for( size_t run = 1; run < runs.size(); ++run )
+        threads.push_back( std::thread( worker, run ) );
+
+    worker( 0 );    // this thread renders the first run
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    // Composite the runs in order, using screen coordinates
+    cairo_save( currentContext );
+    cairo_identity_matrix( currentContext );
+
+    for( size_t run = 0; run < runs.size(); ++run )
+    {
+        cairo_set_source_surface( currentContext, layerSurfaces[run], 0.0, 0.0 );
+        cairo_rectangle( currentContext, area.GetX(), area.GetY(),
+                         area.GetWidth(), area.GetHeight() );
+        cairo_fill( currentContext );
+    }
+
+    cairo_restore( currentContext );
+
+    // Leave the drawing state as if the layers were drawn on this thread
+    isFillEnabled   = finalStates.back().isFillEnabled;
+    isStrokeEnabled = finalStates.back().isStrokeEnabled;
+    fillColor       = finalStates.back().fillColor;
+    strokeColor     = finalStates.back().strokeColor;
+}
+
+
+void CAIRO_GAL_BASE::DrawCursor( const VECTOR2D& aCursorPosition )
 {
     cursorPosition = aCursorPosition;
 }
 
 
-void CAIRO_GAL::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void CAIRO_GAL_BASE::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
     cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
@@ -808,7 +1014,7 @@ void CAIRO_GAL::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndP
 }
 
 
-void CAIRO_GAL::flushPath()
+void CAIRO_GAL_BASE::flushPath()
 {
         if( isFillEnabled )
         {
@@ -830,7 +1036,7 @@ void CAIRO_GAL::flushPath()
 }
 
 
-void CAIRO_GAL::storePath()
+void CAIRO_GAL_BASE::storePath()
 {
     if( isElementAdded )
     {
@@ -878,90 +1084,45 @@ void CAIRO_GAL::storePath()
 }
 
 
-void CAIRO_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
-{
-    PostPaint();
-}
-
-
-void CAIRO_GAL::skipMouseEvent( wxMouseEvent& aEvent )
-{
-    // Post the mouse event to the event listener registered in constructor, if any
-    if( mouseListener )
-        wxPostEvent( mouseListener, aEvent );
-}
-
-
-void CAIRO_GAL::initCursor()
-{
-    if( cursorPixels )
-        delete cursorPixels;
-
-    if( cursorPixelsSaved )
-        delete cursorPixelsSaved;
-
-    cursorPixels      = new wxBitmap( cursorSize, cursorSize );
-    cursorPixelsSaved = new wxBitmap( cursorSize, cursorSize );
-
-    wxMemoryDC cursorShape( *cursorPixels );
-
-    cursorShape.SetBackground( *wxTRANSPARENT_BRUSH );
-    wxColour color( cursorColor.r * cursorColor.a * 255, cursorColor.g * cursorColor.a * 255,
-                    cursorColor.b * cursorColor.a * 255, 255 );
-    wxPen pen = wxPen( color );
-    cursorShape.SetPen( pen );
-    cursorShape.Clear();
-
-    cursorShape.DrawLine( 0, cursorSize / 2, cursorSize, cursorSize / 2 );
-    cursorShape.DrawLine( cursorSize / 2, 0, cursorSize / 2, cursorSize );
-}
-
-
-void CAIRO_GAL::blitCursor( wxMemoryDC& clientDC )
+void CAIRO_GAL_BASE::allocateBitmaps()
 {
-    if( !isCursorEnabled )
-        return;
-
-    auto p = ToScreen( cursorPosition );
-
-    clientDC.SetPen( *wxWHITE_PEN );
-    clientDC.DrawLine( p.x - cursorSize / 2, p.y, p.x + cursorSize / 2, p.y );
-    clientDC.DrawLine( p.x, p.y - cursorSize / 2, p.x, p.y + cursorSize / 2 );
+    // Rows of the 24 bit wxImage buffer have to be aligned to 4 bytes
+    bufferWidth = screenSize.x;
+    while( ( ( bufferWidth * 3 ) % 4 ) != 0 ) bufferWidth++;
 
-}
+    // Create buffer, use the system independent Cairo context backend
+    stride     = cairo_format_stride_for_width( GAL_FORMAT, bufferWidth );
 
+    // The stride is a multiple of 4 bytes, the buffers are allocated as 32 bit pixels.
+    // stride * height is computed in size_t, as an int it overflows for large images.
+    bufferSize = (size_t) stride * screenSize.y / sizeof( unsigned int );
 
-void CAIRO_GAL::allocateBitmaps()
-{
-    wxBufferWidth = screenSize.x;
-    while( ( ( wxBufferWidth * 3 ) % 4 ) != 0 ) wxBufferWidth++;
+    bitmapBuffer = new unsigned int[bufferSize];
 
-    // Create buffer, use the system independent Cairo context backend
-    stride     = cairo_format_stride_for_width( GAL_FORMAT, wxBufferWidth );
-    bufferSize = stride * screenSize.y;
-
-    bitmapBuffer        = new unsigned int[bufferSize];
-    bitmapBufferBackup  = new unsigned int[bufferSize];
-    wxOutput            = new unsigned char[wxBufferWidth * 3 * screenSize.y];
+    // Only SaveScreen() and RestoreScreen() use the backup
+    if( useBackupBuffer )
+        bitmapBufferBackup = new unsigned int[bufferSize];
 }
 
 
-void CAIRO_GAL::deleteBitmaps()
+void CAIRO_GAL_BASE::deleteBitmaps()
 {
     delete[] bitmapBuffer;
     delete[] bitmapBufferBackup;
-    delete[] wxOutput;
+
+    bitmapBuffer        = NULL;
+    bitmapBufferBackup  = NULL;
 }
 
 
-void CAIRO_GAL::initSurface()
+void CAIRO_GAL_BASE::initSurface()
 {
     if( isInitialized )
         return;
 
     // Create the Cairo surface
     surface = cairo_image_surface_create_for_data( (unsigned char*) bitmapBuffer, GAL_FORMAT,
-                                                   wxBufferWidth, screenSize.y, stride );
+                                                   bufferWidth, screenSize.y, stride );
     context = cairo_create( surface );
 #ifdef __WXDEBUG__
     cairo_status_t status = cairo_status( context );
@@ -998,7 +1159,7 @@ void CAIRO_GAL::initSurface()
 }
 
 
-void CAIRO_GAL::deinitSurface()
+void CAIRO_GAL_BASE::deinitSurface()
 {
     if( !isInitialized )
         return;
@@ -1011,7 +1172,16 @@ void CAIRO_GAL::deinitSurface()
 }
 
 
-void CAIRO_GAL::setCompositor()
+void CAIRO_GAL_BASE::deleteLayerSurfaces()
+{
+    for( cairo_surface_t* layerSurface : layerSurfaces )
+        cairo_surface_destroy( layerSurface );
+
+    layerSurfaces.clear();
+}
+
+
+void CAIRO_GAL_BASE::setCompositor()
 {
     // Recreate the compositor with the new Cairo context
     compositor.reset( new CAIRO_COMPOSITOR( &currentContext ) );
@@ -1020,12 +1190,15 @@ void CAIRO_GAL::setCompositor()
     // Prepare buffers
     mainBuffer = compositor->CreateBuffer();
     overlayBuffer = compositor->CreateBuffer();
+    previewBuffer = compositor->CreateBuffer();
 
+    // The saved image is gone together with the old buffers
+    isPreviewShown = false;
     validCompositor = true;
 }
 
 
-void CAIRO_GAL::drawPoly( const std::deque<VECTOR2D>& aPointList )
+void CAIRO_GAL_BASE::drawPoly( const std::deque<VECTOR2D>& aPointList )
 {
     // Iterate over the point list and draw the segments
     std::deque<VECTOR2D>::const_iterator it = aPointList.begin();
@@ -1042,7 +1215,7 @@ void CAIRO_GAL::drawPoly( const std::deque<VECTOR2D>& aPointList )
 }
 
 
-void CAIRO_GAL::drawPoly( const VECTOR2D aPointList[], int aListSize )
+void CAIRO_GAL_BASE::drawPoly( const VECTOR2D aPointList[], int aListSize )
 {
     // Iterate over the point list and draw the segments
     const VECTOR2D* ptr = aPointList;
@@ -1060,7 +1233,7 @@ void CAIRO_GAL::drawPoly( const VECTOR2D aPointList[], int aListSize )
 }
 
 
-void CAIRO_GAL::drawPoly( const SHAPE_LINE_CHAIN& aLineChain )
+void CAIRO_GAL_BASE::drawPoly( const SHAPE_LINE_CHAIN& aLineChain )
 {
     if( aLineChain.PointCount() < 2 )
         return;
@@ -1079,7 +1252,7 @@ void CAIRO_GAL::drawPoly( const SHAPE_LINE_CHAIN& aLineChain )
 }
 
 
-unsigned int CAIRO_GAL::getNewGroupNumber()
+unsigned int CAIRO_GAL_BASE::getNewGroupNumber()
 {
     wxASSERT_MSG( groups.size() < std::numeric_limits<unsigned int>::max(),
                   wxT( "There are no free slots to store a group" ) );
@@ -1089,3 +1262,191 @@ unsigned int CAIRO_GAL::getNewGroupNumber()
 
     return groupCounter++;
 }
+
+
+CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
+        wxEvtHandler* aPaintListener, const wxString& aName ) :
+    wxWindow( aParent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxEXPAND, aName )
+{
+    parentWindow  = aParent;
+    mouseListener = aMouseListener;
+    paintListener = aPaintListener;
+
+    // Connecting the event handlers
+    Connect( wxEVT_PAINT,       wxPaintEventHandler( CAIRO_GAL::onPaint ) );
+
+    // Mouse events are skipped to the parent
+    Connect( wxEVT_MOTION,          wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_LEFT_DOWN,       wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_LEFT_UP,         wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_LEFT_DCLICK,     wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_MIDDLE_DOWN,     wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_MIDDLE_UP,       wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_MIDDLE_DCLICK,   wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_RIGHT_DOWN,      wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_RIGHT_UP,        wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_RIGHT_DCLICK,    wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+    Connect( wxEVT_MOUSEWHEEL,      wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+#if defined _WIN32 || defined _WIN64
+    Connect( wxEVT_ENTER_WINDOW,    wxMouseEventHandler( CAIRO_GAL::skipMouseEvent ) );
+#endif
+
+    SetSize( aParent->GetSize() );
+    screenSize = VECTOR2I( aParent->GetSize() );
+
+    cursorPixels = NULL;
+    cursorPixelsSaved = NULL;
+    initCursor();
+
+    // Allocate memory for pixel storage
+    allocateBitmaps();
+    wxOutput = new unsigned char[bufferWidth * 3 * screenSize.y];
+}
+
+
+CAIRO_GAL::~CAIRO_GAL()
+{
+    delete[] wxOutput;
+
+    delete cursorPixels;
+    delete cursorPixelsSaved;
+}
+
+
+void CAIRO_GAL::EndDrawing()
+{
+    CAIRO_GAL_BASE::EndDrawing();
+
+    // Now translate the raw context data from the format stored
+    // by cairo into a format understood by wxImage.
+    pixman_image_t* dstImg = pixman_image_create_bits(PIXMAN_r8g8b8,
+            screenSize.x, screenSize.y, (uint32_t*)wxOutput, bufferWidth * 3 );
+    pixman_image_t* srcImg = pixman_image_create_bits(PIXMAN_a8b8g8r8,
+            screenSize.x, screenSize.y, (uint32_t*)bitmapBuffer, bufferWidth * 4 );
+
+    pixman_image_composite (PIXMAN_OP_SRC, srcImg, NULL, dstImg,
+            0, 0, 0, 0, 0, 0, screenSize.x, screenSize.y );
+
+    // Free allocated memory
+    pixman_image_unref( srcImg );
+    pixman_image_unref( dstImg );
+
+    wxImage img( bufferWidth, screenSize.y, (unsigned char*) wxOutput, true );
+    wxBitmap bmp( img );
+    wxMemoryDC mdc( bmp );
+    wxClientDC clientDC( this );
+
+    // Now it is the time to blit the mouse cursor
+    blitCursor( mdc );
+    clientDC.Blit( 0, 0, screenSize.x, screenSize.y, &mdc, 0, 0, wxCOPY );
+}
+
+
+void CAIRO_GAL::ResizeScreen( int aWidth, int aHeight )
+{
+    CAIRO_GAL_BASE::ResizeScreen( aWidth, aHeight );
+
+    delete[] wxOutput;
+    wxOutput = new unsigned char[bufferWidth * 3 * screenSize.y];
+
+    SetSize( wxSize( aWidth, aHeight ) );
+}
+
+
+bool CAIRO_GAL::Show( bool aShow )
+{
+    bool s = wxWindow::Show( aShow );
+
+    if( aShow )
+        wxWindow::Raise();
+
+    return s;
+}
+
+
+void CAIRO_GAL::SetCursorSize( unsigned int aCursorSize )
+{
+    GAL::SetCursorSize( aCursorSize );
+    initCursor();
+}
+
+
+void CAIRO_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
+{
+    PostPaint();
+}
+
+
+void CAIRO_GAL::skipMouseEvent( wxMouseEvent& aEvent )
+{
+    // Post the mouse event to the event listener registered in constructor, if any
+    if( mouseListener )
+        wxPostEvent( mouseListener, aEvent );
+}
+
+
+void CAIRO_GAL::initCursor()
+{
+    if( cursorPixels )
+        delete cursorPixels;
+
+    if( cursorPixelsSaved )
+        delete cursorPixelsSaved;
+
+    cursorPixels      = new wxBitmap( cursorSize, cursorSize );
+    cursorPixelsSaved = new wxBitmap( cursorSize, cursorSize );
+
+    wxMemoryDC cursorShape( *cursorPixels );
+
+    cursorShape.SetBackground( *wxTRANSPARENT_BRUSH );
+    wxColour color( cursorColor.r * cursorColor.a * 255, cursorColor.g * cursorColor.a * 255,
+                    cursorColor.b * cursorColor.a * 255, 255 );
+    wxPen pen = wxPen( color );
+    cursorShape.SetPen( pen );
+    cursorShape.Clear();
+
+    cursorShape.DrawLine( 0, cursorSize / 2, cursorSize, cursorSize / 2 );
+    cursorShape.DrawLine( cursorSize / 2, 0, cursorSize / 2, cursorSize );
+}
+
+
+void CAIRO_GAL::blitCursor( wxMemoryDC& clientDC )
+{
+    if( !isCursorEnabled )
+        return;
+
+    auto p = ToScreen( cursorPosition );
+
+    clientDC.SetPen( *wxWHITE_PEN );
+    clientDC.DrawLine( p.x - cursorSize / 2, p.y, p.x + cursorSize / 2, p.y );
+    clientDC.DrawLine( p.x, p.y - cursorSize / 2, p.x, p.y + cursorSize / 2 );
+
+}
+
+
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( int aWidth, int aHeight )
+{
+    screenSize = VECTOR2I( aWidth, aHeight );
+
+    // There is no window to show a cursor in
+    SetCursorEnabled( false );
+
+    // Nothing saves nor restores the screen of an image, do not double its memory
+    useBackupBuffer = false;
+
+    allocateBitmaps();
+}
+
+
+bool CAIRO_IMAGE_GAL::SaveImage( const wxString& aFileName ) const
+{
+    // The buffer rows may be padded, so the surface covers only the visible part of them
+    cairo_surface_t* image = cairo_image_surface_create_for_data( (unsigned char*) bitmapBuffer,
+                                    GAL_FORMAT, screenSize.x, screenSize.y, stride );
+
+    // fn_str() is a wide string on Windows, cairo takes the file name as UTF-8
+    cairo_status_t status = cairo_surface_write_to_png( image, TO_UTF8( aFileName ) );
+    cairo_surface_destroy( image );
+
+    return status == CAIRO_STATUS_SUCCESS;
+}
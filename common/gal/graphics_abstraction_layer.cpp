@@ -124,6 +124,49 @@ void GAL::ComputeWorldScreenMatrix()
 }
 
 
+void GAL::DrawGlyphs( const GLYPH_RUN& aGlyphs )
+{
+    std::deque<VECTOR2D> pointList;
+
+    for( const std::pair<const GLYPH*, VECTOR2D>& glyph : aGlyphs )
+    {
+        for( const std::deque<VECTOR2D>& stroke : *glyph.first )
+        {
+            pointList.clear();
+
+            for( const VECTOR2D& point : stroke )
+                pointList.push_back( point + glyph.second );
+
+            DrawPolyline( pointList );
+        }
+    }
+}
+
+
+void GAL::DrawLayerBatches( const std::vector<LAYER_BATCH>& aBatches )
+{
+    for( const LAYER_BATCH& batch : aBatches )
+    {
+        SetLayerDepth( batch.depth );
+
+        for( int group : batch.groups )
+            DrawGroup( group );
+
+        if( batch.rects.empty() )
+            continue;
+
+        SetIsFill( true );
+        SetIsStroke( false );
+
+        for( const std::pair<BOX2D, COLOR4D>& rect : batch.rects )
+        {
+            SetFillColor( rect.second );
+            DrawRectangle( rect.first.GetOrigin(), rect.first.GetEnd() );
+        }
+    }
+}
+
+
 void GAL::DrawGrid()
 {
     if( !gridVisibility )
@@ -36,12 +36,11 @@
 #include <gal/opengl/utils.h>
 
 #include <confirm.h>
-#include <list>
+#include <profile.h>
 #include <cassert>
 
 #ifdef __WXDEBUG__
 #include <wx/log.h>
-#include <profile.h>
 #endif /* __WXDEBUG__ */
 
 using namespace KIGFX;
@@ -49,10 +48,11 @@ using namespace KIGFX;
 CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
     VERTEX_CONTAINER( aSize ), m_item( NULL ),
     m_chunkSize( 0 ), m_chunkOffset( 0 ), m_isMapped( false ),
-    m_isInitialized( false ), m_glBufferHandle( -1 )
+    m_isInitialized( false ), m_glBufferHandle( -1 ),
+    m_resizeCount( 0 ), m_compactCount( 0 ), m_compactTime( 0.0 ), m_written( 0 )
 {
     // In the beginning there is only free space
-    m_freeChunks.insert( std::make_pair( aSize, 0 ) );
+    m_freeChunks.Add( 0, aSize );
 }
 
 
@@ -100,7 +100,6 @@ void CACHED_CONTAINER::FinishItem()
 
         // Add the not used memory back to the pool
         addFreeChunk( itemOffset + itemSize, m_chunkSize - itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
     }
 
     if( itemSize > 0 )
@@ -145,6 +144,7 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
 
     // The content has to be updated
     m_dirty = true;
+    m_written += aSize;
 
 #if CACHED_CONTAINER_TEST > 0
     test();
@@ -218,8 +218,8 @@ void CACHED_CONTAINER::Clear()
     m_items.clear();
 
     // Now there is only free space left
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, 0 ) );
+    m_freeChunks.Clear();
+    m_freeChunks.Add( 0, m_freeSpace );
 }
 
 
@@ -275,16 +275,23 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     wxLogDebug( wxT( "Resize %p from %d to %d" ), m_item, itemSize, aSize );
 #endif
 
-    // Find a free space chunk >= aSize
-    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
+    // Parameters of the allocated chunk
+    unsigned int newChunkSize   = 0;
+    unsigned int newChunkOffset = 0;
 
-    // Is there enough space to store vertices?
-    if( newChunk == m_freeChunks.end() )
+    // Find a free space chunk >= aSize
+    if( !m_freeChunks.Take( aSize, newChunkOffset, newChunkSize ) )
     {
         bool result;
 
+        // Free chunks are merged as they are released, so if there is still plenty of free
+        // space, then it is only scattered: compact the items instead of growing the buffer
+        if( m_freeSpace >= aSize + m_currentSize / 4 )
+        {
+            result = defragmentResize( m_currentSize );
+        }
         // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
+        else if( aSize < m_freeSpace + m_currentSize )
         {
             // Yes: exponential growing
             result = defragmentResize( m_currentSize * 2 );
@@ -298,14 +305,10 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
         if( !result )
             return false;
 
-        newChunk = m_freeChunks.lower_bound( aSize );
-        assert( newChunk != m_freeChunks.end() );
+        result = m_freeChunks.Take( aSize, newChunkOffset, newChunkSize );
+        assert( result );
     }
 
-    // Parameters of the allocated chunk
-    unsigned int newChunkSize   = getChunkSize( *newChunk );
-    unsigned int newChunkOffset = getChunkOffset( *newChunk );
-
     assert( newChunkSize >= aSize );
     assert( newChunkOffset < m_currentSize );
 
@@ -323,8 +326,7 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
         addFreeChunk( m_chunkOffset, m_chunkSize );
     }
 
-    // Remove the new allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
+    // The new allocated chunk has been removed from the free space pool
     m_freeSpace -= newChunkSize;
 
     m_chunkSize = newChunkSize;
@@ -336,65 +338,6 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
 }
 
 
-void CACHED_CONTAINER::mergeFreeChunks()
-{
-    if( m_freeChunks.size() <= 1 ) // There are no chunks that can be merged
-        return;
-
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
-
-    // Reversed free chunks map - this one stores chunk size with its offset as the key
-    std::list<CHUNK> freeChunks;
-
-    FREE_CHUNK_MAP::const_iterator it, it_end;
-
-    for( it = m_freeChunks.begin(), it_end = m_freeChunks.end(); it != it_end; ++it )
-    {
-        freeChunks.push_back( std::make_pair( it->second, it->first ) );
-    }
-
-    m_freeChunks.clear();
-    freeChunks.sort();
-
-    std::list<CHUNK>::const_iterator itf, itf_end;
-    unsigned int offset = freeChunks.front().first;
-    unsigned int size   = freeChunks.front().second;
-    freeChunks.pop_front();
-
-    for( itf = freeChunks.begin(), itf_end = freeChunks.end(); itf != itf_end; ++itf )
-    {
-        if( itf->first == offset + size )
-        {
-            // These chunks can be merged, so just increase the current chunk size and go on
-            size += itf->second;
-        }
-        else
-        {
-            // These chunks cannot be merged
-            // So store the previous one
-            m_freeChunks.insert( std::make_pair( size, offset ) );
-            // and let's check the next chunk
-            offset = itf->first;
-            size   = itf->second;
-
-        }
-    }
-
-    // Add the last one
-    m_freeChunks.insert( std::make_pair( size, offset ) );
-
-#ifdef __WXDEBUG__
-    totalTime.Stop();
-    wxLogDebug( "Merged free chunks / %.1f ms", totalTime.msecs() );
-#endif /* __WXDEBUG__ */
-#if CACHED_CONTAINER_TEST > 0
-    test();
-#endif
-}
-
-
 bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
 {
     if( !m_useCopyBuffer )
@@ -409,9 +352,7 @@ bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
     if( usedSpace() > aNewSize )
         return false;
 
-#ifdef __WXDEBUG__
     PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
 
     GLuint newBuffer;
 
@@ -477,20 +418,27 @@ bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
     Map();
     checkGlError( "switching buffers during defragmentation" );
 
-#ifdef __WXDEBUG__
     totalTime.Stop();
 
     wxLogTrace( "GAL_CACHED_CONTAINER",
                 "Defragmented container storing %d vertices / %.1f ms",
                 m_currentSize - m_freeSpace, totalTime.msecs() );
-#endif /* __WXDEBUG__ */
+
+    if( aNewSize > m_currentSize )
+        m_resizeCount++;
+    else
+        m_compactCount++;
+
+    m_compactTime += totalTime.msecs();
 
     m_freeSpace += ( aNewSize - m_currentSize );
     m_currentSize = aNewSize;
 
     // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    m_freeChunks.Clear();
+
+    if( m_freeSpace > 0 )
+        m_freeChunks.Add( m_currentSize - m_freeSpace, m_freeSpace );
 
     return true;
 }
@@ -508,9 +456,7 @@ bool CACHED_CONTAINER::defragmentResizeMemcpy( unsigned int aNewSize )
     if( usedSpace() > aNewSize )
         return false;
 
-#ifdef __WXDEBUG__
     PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
 
     GLuint newBuffer;
     VERTEX* newBufferMem;
@@ -570,20 +516,27 @@ bool CACHED_CONTAINER::defragmentResizeMemcpy( unsigned int aNewSize )
     Map();
     checkGlError( "switching buffers during defragmentation" );
 
-#ifdef __WXDEBUG__
     totalTime.Stop();
 
     wxLogTrace( "GAL_CACHED_CONTAINER",
                 "Defragmented container storing %d vertices / %.1f ms",
                 m_currentSize - m_freeSpace, totalTime.msecs() );
-#endif /* __WXDEBUG__ */
+
+    if( aNewSize > m_currentSize )
+        m_resizeCount++;
+    else
+        m_compactCount++;
+
+    m_compactTime += totalTime.msecs();
 
     m_freeSpace += ( aNewSize - m_currentSize );
     m_currentSize = aNewSize;
 
     // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    m_freeChunks.Clear();
+
+    if( m_freeSpace > 0 )
+        m_freeChunks.Add( m_currentSize - m_freeSpace, m_freeSpace );
 
     return true;
 }
@@ -594,27 +547,35 @@ void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
     assert( aOffset + aSize <= m_currentSize );
     assert( aSize > 0 );
 
-    m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
+    m_freeChunks.Add( aOffset, aSize );
     m_freeSpace += aSize;
 }
 
 
-void CACHED_CONTAINER::showFreeChunks()
+CACHED_CONTAINER_STATS CACHED_CONTAINER::GetStats() const
 {
-#ifdef __WXDEBUG__
-    FREE_CHUNK_MAP::iterator it;
+    CACHED_CONTAINER_STATS stats;
+
+    stats.size              = m_currentSize;
+    stats.used              = usedSpace();
+    stats.freeChunks        = m_freeChunks.GetChunkCount();
+    stats.largestFreeChunk  = m_freeChunks.GetLargestChunk();
+    stats.fragmentation     = m_freeChunks.GetFragmentation();
+    stats.resizeCount       = m_resizeCount;
+    stats.compactCount      = m_compactCount;
+    stats.compactTime       = m_compactTime;
+    stats.written           = m_written;
+
+    return stats;
+}
 
-    wxLogDebug( wxT( "Free chunks:" ) );
 
-    for( it = m_freeChunks.begin(); it != m_freeChunks.end(); ++it )
-    {
-        unsigned int offset = getChunkOffset( *it );
-        unsigned int size   = getChunkSize( *it );
-        assert( size > 0 );
-
-        wxLogDebug( wxT( "[0x%08x-0x%08x] (size %d)" ),
-                    offset, offset + size - 1, size );
-    }
+void CACHED_CONTAINER::showFreeChunks()
+{
+#ifdef __WXDEBUG__
+    wxLogDebug( wxT( "Free chunks: %d (largest %d, total %d)" ),
+                m_freeChunks.GetChunkCount(), m_freeChunks.GetLargestChunk(),
+                m_freeChunks.GetFreeSpace() );
 #endif /* __WXDEBUG__ */
 }
 
@@ -644,13 +605,8 @@ void CACHED_CONTAINER::test()
 {
 #ifdef __WXDEBUG__
     // Free space check
-    unsigned int freeSpace = 0;
-    FREE_CHUNK_MAP::iterator itf;
-
-    for( itf = m_freeChunks.begin(); itf != m_freeChunks.end(); ++itf )
-        freeSpace += getChunkSize( *itf );
-
-    assert( freeSpace == m_freeSpace );
+    assert( m_freeChunks.Check() );
+    assert( m_freeChunks.GetFreeSpace() == m_freeSpace );
 
     // Used space check
     unsigned int usedSpace = 0;
@@ -665,8 +621,6 @@ void CACHED_CONTAINER::test()
     usedSpace += m_chunkSize;
 
     assert( ( m_freeSpace + usedSpace ) == m_currentSize );
-
-    // Overlapping check TODO
 #endif /* __WXDEBUG__ */
 }
 
@@ -0,0 +1,120 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/free_chunk_list.h>
+
+#include <cassert>
+#include <iterator>
+
+using namespace KIGFX;
+
+void FREE_CHUNK_LIST::Clear()
+{
+    m_chunksByOffset.clear();
+    m_chunksBySize.clear();
+    m_freeSpace = 0;
+}
+
+
+void FREE_CHUNK_LIST::Add( unsigned int aOffset, unsigned int aSize )
+{
+    assert( aSize > 0 );
+
+    m_freeSpace += aSize;
+
+    // Merge with the following chunk
+    auto next = m_chunksByOffset.lower_bound( aOffset );
+
+    assert( next == m_chunksByOffset.end() || next->first >= aOffset + aSize );
+
+    if( next != m_chunksByOffset.end() && next->first == aOffset + aSize )
+    {
+        aSize += next->second;
+        m_chunksBySize.erase( std::make_pair( next->second, next->first ) );
+        next = m_chunksByOffset.erase( next );
+    }
+
+    // Merge with the preceding chunk
+    if( next != m_chunksByOffset.begin() )
+    {
+        auto prev = std::prev( next );
+
+        assert( prev->first + prev->second <= aOffset );
+
+        if( prev->first + prev->second == aOffset )
+        {
+            m_chunksBySize.erase( std::make_pair( prev->second, prev->first ) );
+            prev->second += aSize;
+            m_chunksBySize.insert( std::make_pair( prev->second, prev->first ) );
+            return;
+        }
+    }
+
+    m_chunksByOffset.insert( next, std::make_pair( aOffset, aSize ) );
+    m_chunksBySize.insert( std::make_pair( aSize, aOffset ) );
+}
+
+
+bool FREE_CHUNK_LIST::Take( unsigned int aSize, unsigned int& aOffset, unsigned int& aChunkSize )
+{
+    auto it = m_chunksBySize.lower_bound( std::make_pair( aSize, 0u ) );
+
+    if( it == m_chunksBySize.end() )
+        return false;
+
+    aChunkSize = it->first;
+    aOffset = it->second;
+
+    m_chunksBySize.erase( it );
+    m_chunksByOffset.erase( aOffset );
+    m_freeSpace -= aChunkSize;
+
+    return true;
+}
+
+
+bool FREE_CHUNK_LIST::Check() const
+{
+    if( m_chunksByOffset.size() != m_chunksBySize.size() )
+        return false;
+
+    unsigned int freeSpace = 0;
+    unsigned int end = 0;
+    bool first = true;
+
+    for( const auto& chunk : m_chunksByOffset )
+    {
+        // Chunks must not overlap nor touch each other (touching ones are merged)
+        if( chunk.second == 0 || ( !first && chunk.first <= end ) )
+            return false;
+
+        if( m_chunksBySize.count( std::make_pair( chunk.second, chunk.first ) ) == 0 )
+            return false;
+
+        freeSpace += chunk.second;
+        end = chunk.first + chunk.second;
+        first = false;
+    }
+
+    return freeSpace == m_freeSpace;
+}
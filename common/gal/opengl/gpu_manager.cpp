@@ -56,7 +56,8 @@ GPU_MANAGER* GPU_MANAGER::MakeManager( VERTEX_CONTAINER* aContainer )
 
 
 GPU_MANAGER::GPU_MANAGER( VERTEX_CONTAINER* aContainer ) :
-    m_isDrawing( false ), m_container( aContainer ), m_shader( NULL ), m_shaderAttrib( 0 )
+    m_isDrawing( false ), m_container( aContainer ), m_shader( NULL ), m_shaderAttrib( 0 ),
+    m_uploadedBytes( 0 )
 {
 }
 
@@ -181,6 +182,7 @@ void GPU_CACHED_MANAGER::EndDrawing()
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
             (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+    m_uploadedBytes += m_indicesSize * sizeof(int);
 
     glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
 
@@ -279,6 +281,9 @@ void GPU_NONCACHED_MANAGER::EndDrawing()
 
     glDrawArrays( GL_TRIANGLES, 0, m_container->GetSize() );
 
+    // Client side arrays are transferred on every draw call
+    m_uploadedBytes += (uint64_t) m_container->GetSize() * VertexSize;
+
 #ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", wxT( "Noncached manager size: %d" ), m_container->GetSize() );
 #endif /* __WXDEBUG__ */
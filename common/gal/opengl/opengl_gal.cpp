@@ -636,6 +636,19 @@ void OPENGL_GAL::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
 }
 
 
+void OPENGL_GAL::DrawGlyphs( const GLYPH_RUN& aGlyphs )
+{
+    // Offset the cached glyph points on the fly instead of copying them
+    for( const std::pair<const GLYPH*, VECTOR2D>& glyph : aGlyphs )
+    {
+        const VECTOR2D& offset = glyph.second;
+
+        for( const std::deque<VECTOR2D>& stroke : *glyph.first )
+            drawPolyline( [&](int idx) { return stroke[idx] + offset; }, stroke.size() );
+    }
+}
+
+
 void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 {
     auto points = std::unique_ptr<GLdouble[]>( new GLdouble[3 * aPointList.size()] );
@@ -1085,6 +1098,13 @@ void OPENGL_GAL::ClearCache()
 }
 
 
+uint64_t OPENGL_GAL::GetUploadedBytes() const
+{
+    return cachedManager->GetUploadedBytes() + nonCachedManager->GetUploadedBytes()
+           + overlayManager->GetUploadedBytes();
+}
+
+
 void OPENGL_GAL::SaveScreen()
 {
     wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
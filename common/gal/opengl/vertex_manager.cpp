@@ -251,6 +251,20 @@ void VERTEX_MANAGER::EndDrawing() const
 }
 
 
+uint64_t VERTEX_MANAGER::GetUploadedBytes() const
+{
+    uint64_t bytes = m_gpu->GetUploadedBytes();
+
+    // Cached vertices are written directly to the mapped GPU buffer
+    const CACHED_CONTAINER* cached = dynamic_cast<const CACHED_CONTAINER*>( m_container.get() );
+
+    if( cached )
+        bytes += cached->GetStats().written * VertexSize;
+
+    return bytes;
+}
+
+
 void VERTEX_MANAGER::putVertex( VERTEX& aTarget, GLfloat aX, GLfloat aY, GLfloat aZ ) const
 {
     // Modify the vertex according to the currently used transformations
@@ -30,26 +30,70 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <wx/string.h>
 
+#include <mutex>
+
 using namespace KIGFX;
 
 const double STROKE_FONT::INTERLINE_PITCH_RATIO = 1.5;
+const unsigned int STROKE_FONT::GLYPH_CACHE_SIZE = 64;
 const double STROKE_FONT::OVERBAR_POSITION_FACTOR = 1.22;
 const double STROKE_FONT::BOLD_FACTOR = 1.3;
 const double STROKE_FONT::STROKE_FONT_SCALE = 1.0 / 21.0;
 const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
 
+/**
+ * Fonts parsed by STROKE_FONT::LoadNewStrokeFont(), by font data.  They are never modified
+ * once parsed, so the STROKE_FONTs of all the threads can read them.
+ */
+struct PARSED_STROKE_FONT
+{
+    GLYPH_LIST          m_Glyphs;
+    std::vector<BOX2D>  m_BoundingBoxes;
+};
+
+typedef std::map<const char* const*, PARSED_STROKE_FONT> PARSED_STROKE_FONTS;
+
+// A function static, as GALs may be built while the static objects are initialized
+static PARSED_STROKE_FONTS& parsedFonts()
+{
+    static PARSED_STROKE_FONTS fonts;
+
+    return fonts;
+}
+
+static std::mutex               s_parsedFontsLock;
+
+static const GLYPH_LIST         s_noGlyphs;
+static const std::vector<BOX2D> s_noBoundingBoxes;
+
+
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
-    m_gal( aGal )
+    m_gal( aGal ),
+    m_glyphs( &s_noGlyphs ),
+    m_glyphBoundingBoxes( &s_noBoundingBoxes )
 {
 }
 
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
-    m_glyphs.clear();
-    m_glyphBoundingBoxes.clear();
-    m_glyphs.resize( aNewStrokeFontSize );
-    m_glyphBoundingBoxes.resize( aNewStrokeFontSize );
+    std::lock_guard<std::mutex> lock( s_parsedFontsLock );
+
+    m_glyphCache.clear();
+
+    PARSED_STROKE_FONTS::iterator it = parsedFonts().find( aNewStrokeFont );
+
+    if( it != parsedFonts().end() )
+    {
+        m_glyphs = &it->second.m_Glyphs;
+        m_glyphBoundingBoxes = &it->second.m_BoundingBoxes;
+        return true;
+    }
+
+    PARSED_STROKE_FONT& font = parsedFonts()[aNewStrokeFont];
+
+    font.m_Glyphs.resize( aNewStrokeFontSize );
+    font.m_BoundingBoxes.resize( aNewStrokeFontSize );
 
     for( int j = 0; j < aNewStrokeFontSize; j++ )
     {
@@ -112,12 +156,15 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
         if( pointList.size() > 0 )
             glyph.push_back( pointList );
 
-        m_glyphs[j] = glyph;
+        font.m_Glyphs[j] = glyph;
 
         // Compute the bounding box of the glyph
-        m_glyphBoundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
+        font.m_BoundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
     }
 
+    m_glyphs = &font.m_Glyphs;
+    m_glyphBoundingBoxes = &font.m_BoundingBoxes;
+
     return true;
 }
 
@@ -304,6 +351,15 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
     // overlap.
     bool last_had_overbar = false;
 
+    // Glyphs are taken already scaled and slanted from the cache, and sent to the GAL
+    // in a single call once the whole line is laid out
+    bool        italic = m_gal->IsFontItalic();
+    bool        mirrored = m_gal->IsTextMirrored();
+    GLYPH_CACHE& cache = getGlyphCache( glyphSize, italic, mirrored );
+    GLYPH_RUN   run;
+
+    run.reserve( aText.size() );
+
     for( UTF8::uni_iter chIt = aText.ubegin(), end = aText.uend(); chIt < end; ++chIt )
     {
         // Toggle overbar
@@ -320,11 +376,10 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 
         int dd = *chIt - ' ';
 
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+        if( dd >= (int) m_glyphBoundingBoxes->size() || dd < 0 )
             dd = '?' - ' ';
 
-        GLYPH& glyph = m_glyphs[dd];
-        BOX2D& bbox  = m_glyphBoundingBoxes[dd];
+        const BOX2D& bbox = (*m_glyphBoundingBoxes)[dd];
 
         if( overbar )
         {
@@ -349,36 +404,75 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             last_had_overbar = false;
         }
 
-        for( GLYPH::iterator pointListIt = glyph.begin(); pointListIt != glyph.end();
-             ++pointListIt )
+        run.push_back( std::make_pair( &getCachedGlyph( cache, dd, glyphSize, italic, mirrored ),
+                                       VECTOR2D( xOffset, 0.0 ) ) );
+
+        xOffset += glyphSize.x * bbox.GetEnd().x;
+    }
+
+    m_gal->DrawGlyphs( run );
+    m_gal->Restore();
+}
+
+
+STROKE_FONT::GLYPH_CACHE& STROKE_FONT::getGlyphCache( const VECTOR2D& aGlyphSize, bool aItalic,
+                                                      bool aMirrored )
+{
+    GLYPH_CACHE_KEY key = { aGlyphSize, aItalic, aMirrored };
+    auto it = m_glyphCache.find( key );
+
+    if( it != m_glyphCache.end() )
+        return it->second;
+
+    // Texts usually come in a handful of sizes, so simply start over if there are too many
+    if( m_glyphCache.size() >= GLYPH_CACHE_SIZE )
+        m_glyphCache.clear();
+
+    return m_glyphCache[key];
+}
+
+
+const GLYPH& STROKE_FONT::getCachedGlyph( GLYPH_CACHE& aCache, int aIndex,
+                                          const VECTOR2D& aGlyphSize, bool aItalic,
+                                          bool aMirrored ) const
+{
+    GLYPH_CACHE::iterator it = aCache.find( aIndex );
+
+    if( it != aCache.end() )
+        return it->second;
+
+    // References to the elements of an unordered_map stay valid when it grows, so the glyphs
+    // of a run can be collected before drawing them.
+    GLYPH&       cached = aCache[aIndex];
+    const GLYPH& glyph = (*m_glyphs)[aIndex];
+
+    for( GLYPH::const_iterator pointListIt = glyph.begin(); pointListIt != glyph.end();
+         ++pointListIt )
+    {
+        std::deque<VECTOR2D> pointListScaled;
+
+        for( std::deque<VECTOR2D>::const_iterator pointIt = pointListIt->begin();
+             pointIt != pointListIt->end(); ++pointIt )
         {
-            std::deque<VECTOR2D> pointListScaled;
+            VECTOR2D pointPos( pointIt->x * aGlyphSize.x, pointIt->y * aGlyphSize.y );
 
-            for( std::deque<VECTOR2D>::iterator pointIt = pointListIt->begin();
-                 pointIt != pointListIt->end(); ++pointIt )
+            if( aItalic )
             {
-                VECTOR2D pointPos( pointIt->x * glyphSize.x + xOffset, pointIt->y * glyphSize.y );
-
-                if( m_gal->IsFontItalic() )
-                {
-                    // FIXME should be done other way - referring to the lowest Y value of point
-                    // because now italic fonts are translated a bit
-                    if( m_gal->IsTextMirrored() )
-                        pointPos.x += pointPos.y * STROKE_FONT::ITALIC_TILT;
-                    else
-                        pointPos.x -= pointPos.y * STROKE_FONT::ITALIC_TILT;
-                }
-
-                pointListScaled.push_back( pointPos );
+                // FIXME should be done other way - referring to the lowest Y value of point
+                // because now italic fonts are translated a bit
+                if( aMirrored )
+                    pointPos.x += pointPos.y * STROKE_FONT::ITALIC_TILT;
+                else
+                    pointPos.x -= pointPos.y * STROKE_FONT::ITALIC_TILT;
             }
 
-            m_gal->DrawPolyline( pointListScaled );
+            pointListScaled.push_back( pointPos );
         }
 
-        xOffset += glyphSize.x * bbox.GetEnd().x;
+        cached.push_back( pointListScaled );
     }
 
-    m_gal->Restore();
+    return cached;
 }
 
 
@@ -429,10 +523,10 @@ VECTOR2D STROKE_FONT::ComputeStringBoundaryLimits( const UTF8& aText, VECTOR2D a
         // Index in the bounding boxes table
         int dd = *it - ' ';
 
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+        if( dd >= (int) m_glyphBoundingBoxes->size() || dd < 0 )
             dd = '?' - ' ';
 
-        const BOX2D& box = m_glyphBoundingBoxes[dd];
+        const BOX2D& box = (*m_glyphBoundingBoxes)[dd];
 
         string_bbox.x += box.GetEnd().x;
 
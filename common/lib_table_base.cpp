@@ -377,6 +377,7 @@ void LIB_TABLE::Save( const wxString& aFileName ) const
 {
     FILE_OUTPUTFORMATTER sf( aFileName );
     Format( &sf, 0 );
+    sf.Finish();
 }
 
 
@@ -389,7 +389,7 @@ const wxString PGM_BASE::AskUserForPreferredEditor( const wxString& aDefaultEdit
 }
 
 
-bool PGM_BASE::InitPgm()
+bool PGM_BASE::InitPgm( bool aSingleInstance )
 {
     wxFileName pgm_name( App().argv[0] );
 
@@ -397,10 +397,13 @@ bool PGM_BASE::InitPgm()
 
     wxInitAllImageHandlers();
 
-    m_pgm_checker = new wxSingleInstanceChecker( pgm_name.GetName().Lower() + wxT( "-" ) +
-                                                 wxGetUserId(), GetKicadLockFilePath() );
+    if( aSingleInstance )
+    {
+        m_pgm_checker = new wxSingleInstanceChecker( pgm_name.GetName().Lower() + wxT( "-" ) +
+                                                     wxGetUserId(), GetKicadLockFilePath() );
+    }
 
-    if( m_pgm_checker->IsAnotherRunning() )
+    if( m_pgm_checker && m_pgm_checker->IsAnotherRunning() )
     {
         wxString quiz = wxString::Format(
             _( "%s is already running, Continue?" ),
@@ -25,6 +25,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cstdio>
 #include <macros.h>
 #include <reporter.h>
 #include <wx_html_report_panel.h>
@@ -68,6 +69,15 @@ REPORTER& NULL_REPORTER::Report( const wxString& aText, SEVERITY aSeverity )
     return *this;
 }
 
+REPORTER& STDIO_REPORTER::Report( const wxString& aText, SEVERITY aSeverity )
+{
+    FILE* stream = ( aSeverity & ( RPT_WARNING | RPT_ERROR ) ) ? stderr : stdout;
+
+    fputs( TO_UTF8( aText ), stream );
+    fflush( stream );
+    return *this;
+}
+
 REPORTER& NULL_REPORTER::GetInstance()
 {
     static REPORTER* s_nullReporter = NULL;
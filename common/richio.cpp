@@ -367,8 +367,126 @@ const char* OUTPUTFORMATTER::GetQuoteChar( const char* wrapee )
     return GetQuoteChar( wrapee, quoteChar );
 }
 
+/**
+ * Function isSimpleFormat
+ * tells if \a fmt only has the conversions handled by OUTPUTFORMATTER::vprintSimple(),
+ * i.e. no flags, width, precision or length modifiers.
+ */
+static bool isSimpleFormat( const char* fmt )
+{
+    for( const char* p = fmt;  *p;  ++p )
+    {
+        if( *p == '%' )
+        {
+            ++p;
+
+            if( *p != 's' && *p != 'd' && *p != 'c' && *p != '%' )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Function formatInt
+ * writes the decimal representation of \a aValue to \a aBuf, which must hold at
+ * least 11 bytes.  No terminating nul is written.
+ * @return the number of bytes written.
+ */
+static int formatInt( char* aBuf, int aValue )
+{
+    char        tmp[12];
+    char*       end = tmp + sizeof( tmp );
+    char*       p = end;
+    unsigned    value = aValue < 0 ? 0u - (unsigned) aValue : (unsigned) aValue;
+
+    do
+    {
+        *--p = '0' + value % 10;
+        value /= 10;
+    } while( value );
+
+    if( aValue < 0 )
+        *--p = '-';
+
+    memcpy( aBuf, p, end - p );
+
+    return end - p;
+}
+
+
+int OUTPUTFORMATTER::vprintSimple( const char* fmt,  va_list ap )  throw( IO_ERROR )
+{
+    size_t  len = 0;
+
+    for( const char* p = fmt;  *p;  ++p )
+    {
+        char        num[12];
+        const char* text = num;
+        size_t      count;
+
+        if( *p != '%' )
+        {
+            // copy the literal text up to the next conversion in one go
+            const char* end = strchr( p, '%' );
+
+            if( !end )
+                end = p + strlen( p );
+
+            text  = p;
+            count = end - p;
+            p     = end - 1;
+        }
+        else
+        {
+            switch( *++p )
+            {
+            case 's':
+                text = va_arg( ap, const char* );
+
+                if( !text )
+                    text = "(null)";
+
+                count = strlen( text );
+                break;
+
+            case 'd':
+                count = formatInt( num, va_arg( ap, int ) );
+                break;
+
+            case 'c':
+                num[0] = (char) va_arg( ap, int );
+                count = 1;
+                break;
+
+            default:    // "%%"
+                num[0] = '%';
+                count = 1;
+                break;
+            }
+        }
+
+        if( len + count > buffer.size() )
+            buffer.resize( len + count + 1000 );
+
+        memcpy( &buffer[len], text, count );
+        len += count;
+    }
+
+    if( len > 0 )
+        write( &buffer[0], len );
+
+    return len;
+}
+
+
 int OUTPUTFORMATTER::vprint( const char* fmt,  va_list ap )  throw( IO_ERROR )
 {
+    if( isSimpleFormat( fmt ) )
+        return vprintSimple( fmt, ap );
+
     // This function can call vsnprintf twice.
     // But internally, vsnprintf retrieves arguments from the va_list identified by arg as if
     // va_arg was used on it, and thus the state of the va_list is likely to be altered by the call.
@@ -419,9 +537,9 @@ int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... ) throw( IO_ERRO
     for( int i=0; i<nestLevel;  ++i )
     {
         // no error checking needed, an exception indicates an error.
-        result = sprint( "%*c", NESTWIDTH, ' ' );
+        write( "  ", NESTWIDTH );
 
-        total += result;
+        total += NESTWIDTH;
     }
 
     // no error checking needed, an exception indicates an error.
@@ -523,6 +641,8 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName,
     OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
     m_filename( aFileName )
 {
+    m_outbuf.reserve( FILE_OUTPUTFMTBUFZ );
+
     m_fp = wxFopen( aFileName, aMode );
 
     if( !m_fp )
@@ -538,13 +658,47 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName,
 FILE_OUTPUTFORMATTER::~FILE_OUTPUTFORMATTER()
 {
     if( m_fp )
+    {
+        // A destructor cannot report errors, use Finish() for that.
+        if( !m_outbuf.empty() )
+            fwrite( &m_outbuf[0], m_outbuf.size(), 1, m_fp );
+
         fclose( m_fp );
+    }
 }
 
 
-void FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount ) throw( IO_ERROR )
+void FILE_OUTPUTFORMATTER::Finish() throw( IO_ERROR )
+{
+    if( !m_fp )
+        return;
+
+    flush();
+
+    FILE* fp = m_fp;
+    m_fp = NULL;
+
+    if( fclose( fp ) != 0 )
+    {
+        wxString msg = wxString::Format(
+                            _( "error writing to file '%s'" ),
+                            m_filename.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+}
+
+
+void FILE_OUTPUTFORMATTER::flush() throw( IO_ERROR )
 {
-    if( 1 != fwrite( aOutBuf, aCount, 1, m_fp ) )
+    if( m_outbuf.empty() )
+        return;
+
+    bool ok = 1 == fwrite( &m_outbuf[0], m_outbuf.size(), 1, m_fp );
+
+    // A failed block is dropped so the destructor does not attempt it again.
+    m_outbuf.clear();
+
+    if( !ok )
     {
         wxString msg = wxString::Format(
                             _( "error writing to file '%s'" ),
@@ -554,6 +708,30 @@ void FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount ) throw( IO_ER
 }
 
 
+void FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount ) throw( IO_ERROR )
+{
+    wxASSERT( m_fp );
+
+    if( m_outbuf.size() + aCount > m_outbuf.capacity() )
+        flush();
+
+    if( (size_t) aCount >= m_outbuf.capacity() )
+    {
+        if( 1 != fwrite( aOutBuf, aCount, 1, m_fp ) )
+        {
+            wxString msg = wxString::Format(
+                                _( "error writing to file '%s'" ),
+                                m_filename.GetData() );
+            THROW_IO_ERROR( msg );
+        }
+    }
+    else
+    {
+        m_outbuf.insert( m_outbuf.end(), aOutBuf, aOutBuf + aCount );
+    }
+}
+
+
 //-----<STREAM_OUTPUTFORMATTER>--------------------------------------
 
 void STREAM_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount ) throw( IO_ERROR )
@@ -33,6 +33,7 @@
 
 #include <class_draw_panel_gal.h>
 #include <pcbnew_id.h>
+#include <profile.h>
 
 #include <boost/optional.hpp>
 
@@ -242,6 +243,13 @@ bool TOOL_DISPATCHER::handleMouseButton( wxEvent& aEvent, int aIndex, bool aMoti
 
 void TOOL_DISPATCHER::DispatchWxEvent( wxEvent& aEvent )
 {
+    KIGFX::VIEW* view = m_toolMgr->GetView();
+    boost::optional<PROF_COUNTER> latency;
+
+    // Time the event only when the render statistics are collected
+    if( view && view->GetRenderStats().IsEnabled() )
+        latency = PROF_COUNTER();
+
     bool motion = false, buttonEvents = false;
     boost::optional<TOOL_EVENT> evt;
 
@@ -336,6 +344,15 @@ void TOOL_DISPATCHER::DispatchWxEvent( wxEvent& aEvent )
 #endif
 
     updateUI();
+
+    if( latency )
+    {
+        latency->Stop();
+
+        // The handlers may have replaced the view
+        if( ( view = m_toolMgr->GetView() ) )
+            view->GetRenderStats().AddEventLatency( latency->msecs() );
+    }
 }
 
 
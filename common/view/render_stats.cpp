@@ -0,0 +1,187 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <view/render_stats.h>
+#include <richio.h>
+#include <common.h>
+
+#include <algorithm>
+
+using namespace KIGFX;
+
+const unsigned int RENDER_STATS::HISTORY_SIZE = 1000;
+
+RENDER_STATS::RENDER_STATS() :
+    m_enabled( false ), m_inFrame( false ), m_frameCount( 0 ), m_lastUploadedBytes( 0 ),
+    m_pendingLatency( 0.0 ), m_frameTimer( "frame", false )
+{
+}
+
+
+void RENDER_STATS::SetEnabled( bool aEnabled )
+{
+    m_enabled = aEnabled;
+    m_inFrame = false;
+}
+
+
+void RENDER_STATS::Clear()
+{
+    m_history.clear();
+    m_layers.clear();
+    m_pendingLatency = 0.0;
+    m_inFrame = false;
+}
+
+
+void RENDER_STATS::BeginFrame()
+{
+    if( !m_enabled )
+        return;
+
+    m_current = FRAME_STATS();
+    m_layers.clear();
+    m_inFrame = true;
+    m_frameTimer.Start();
+}
+
+
+void RENDER_STATS::EndFrame( uint64_t aUploadedBytes )
+{
+    // The first frame after enabling only sets the reference for the uploaded data
+    uint64_t uploaded = aUploadedBytes - m_lastUploadedBytes;
+    m_lastUploadedBytes = aUploadedBytes;
+
+    if( !m_enabled || !m_inFrame )
+        return;
+
+    m_frameTimer.Stop();
+    m_inFrame = false;
+
+    m_current.number        = m_frameCount++;
+    m_current.time          = m_frameTimer.msecs();
+    m_current.uploadedBytes = uploaded;
+    m_current.eventLatency  = m_pendingLatency;
+    m_pendingLatency = 0.0;
+
+    for( const auto& layer : m_layers )
+    {
+        const LAYER_STATS& stats = layer.second;
+
+        m_current.total.time        += stats.time;
+        m_current.total.drawn       += stats.drawn;
+        m_current.total.culled      += stats.culled;
+        m_current.total.cacheHits   += stats.cacheHits;
+        m_current.total.cacheMisses += stats.cacheMisses;
+
+        m_current.layers.push_back( layer );
+    }
+
+    m_history.push_back( std::move( m_current ) );
+
+    if( m_history.size() > HISTORY_SIZE )
+        m_history.pop_front();
+}
+
+
+void RENDER_STATS::AddEventLatency( double aMsecs )
+{
+    if( m_enabled )
+        m_pendingLatency = std::max( m_pendingLatency, aMsecs );
+}
+
+
+wxString RENDER_STATS::FormatSummary() const
+{
+    if( m_history.empty() )
+        return wxEmptyString;
+
+    const FRAME_STATS& last = m_history.back();
+    double maxTime = 0.0, sumTime = 0.0;
+    double maxLatency = 0.0;
+    unsigned int count = std::min<unsigned int>( m_history.size(), 60 );
+
+    for( auto it = m_history.rbegin(); it != m_history.rbegin() + count; ++it )
+    {
+        sumTime += it->time;
+        maxTime = std::max( maxTime, it->time );
+        maxLatency = std::max( maxLatency, it->eventLatency );
+    }
+
+    // The slowest layers of the last frame
+    std::vector< std::pair<int, LAYER_STATS> > layers( last.layers );
+
+    std::sort( layers.begin(), layers.end(),
+            []( const std::pair<int, LAYER_STATS>& aA, const std::pair<int, LAYER_STATS>& aB )
+            {
+                return aA.second.time > aB.second.time;
+            } );
+
+    wxString text;
+
+    text << wxString::Format( wxT( "frame %.1f ms (avg %.1f, max %.1f), redraw %.1f ms\n" ),
+                              last.time, sumTime / count, maxTime, last.redrawTime );
+    text << wxString::Format( wxT( "items %u drawn, %u culled, cache %u hits, %u misses\n" ),
+                              last.total.drawn, last.total.culled,
+                              last.total.cacheHits, last.total.cacheMisses );
+    text << wxString::Format( wxT( "upload %.1f kB, event latency max %.1f ms" ),
+                              last.uploadedBytes / 1024.0, maxLatency );
+
+    for( unsigned int i = 0; i < std::min<unsigned int>( layers.size(), 5 ); ++i )
+    {
+        text << wxString::Format( wxT( "\nlayer %d: %.2f ms, %u items" ), layers[i].first,
+                                  layers[i].second.time, layers[i].second.drawn );
+    }
+
+    return text;
+}
+
+
+void RENDER_STATS::ExportCSV( const wxString& aFileName ) const
+{
+    LOCALE_IO toggle;   // use '.' as the decimal separator
+    FILE_OUTPUTFORMATTER out( aFileName );
+
+    out.Print( 0, "frame,layer,time_ms,redraw_ms,drawn,culled,cache_hits,cache_misses,"
+                  "uploaded_bytes,event_latency_ms\n" );
+
+    for( const FRAME_STATS& frame : m_history )
+    {
+        out.Print( 0, "%u,all,%.3f,%.3f,%u,%u,%u,%u,%llu,%.3f\n",
+                   frame.number, frame.time, frame.redrawTime,
+                   frame.total.drawn, frame.total.culled,
+                   frame.total.cacheHits, frame.total.cacheMisses,
+                   (unsigned long long) frame.uploadedBytes, frame.eventLatency );
+
+        for( const auto& layer : frame.layers )
+        {
+            const LAYER_STATS& stats = layer.second;
+
+            out.Print( 0, "%u,%d,%.3f,,%u,%u,%u,%u,,\n",
+                       frame.number, layer.first, stats.time,
+                       stats.drawn, stats.culled, stats.cacheHits, stats.cacheMisses );
+        }
+    }
+
+    out.Finish();
+}
@@ -24,6 +24,11 @@
  */
 
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
 #include <base_struct.h>
 #include <layers_id_colors_and_visibility.h>
 
@@ -34,10 +39,7 @@
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
-
-#ifdef __WXDEBUG__
 #include <profile.h>
-#endif /* __WXDEBUG__  */
 
 namespace KIGFX {
 
@@ -89,6 +91,7 @@ private:
     VIEW*   m_view;             ///< Current dynamic view the item is assigned to.
     int     m_flags;            ///< Visibility flags
     int     m_requiredUpdate;   ///< Flag required for updating
+    BOX2I   m_bbox;             ///< Bounding box the item was indexed with
 
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
@@ -242,6 +245,42 @@ private:
 };
 
 
+/**
+ * Calls aFunc( i ) for every i in [0, aCount). The range is split into chunks that are
+ * processed by as many threads as there are cores.
+ */
+template <typename FUNC>
+static void parallelFor( unsigned aCount, FUNC aFunc )
+{
+    const unsigned          chunkSize = 256;
+    std::atomic<unsigned>   nextChunk( 0 );
+
+    auto worker = [&]()
+    {
+        for( unsigned first = nextChunk++ * chunkSize;  first < aCount;
+                first = nextChunk++ * chunkSize )
+        {
+            unsigned last = std::min<unsigned>( first + chunkSize, aCount );
+
+            for( unsigned i = first;  i < last;  ++i )
+                aFunc( i );
+        }
+    };
+
+    unsigned threadCount = std::min<unsigned>( std::thread::hardware_concurrency(),
+                                               ( aCount + chunkSize - 1 ) / chunkSize );
+    std::vector<std::thread> threads;
+
+    for( unsigned ii = 1; ii < threadCount; ii++ )
+        threads.push_back( std::thread( worker ) );
+
+    worker();   // this thread is one of the workers
+
+    for( unsigned ii = 0; ii < threads.size(); ii++ )
+        threads[ii].join();
+}
+
+
 void VIEW::OnDestroy( VIEW_ITEM* aItem )
 {
     auto data = aItem->viewPrivData();
@@ -258,6 +297,13 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_scale( 4.0 ),
     m_minScale( 4.0 ), m_maxScale( 15000 ),
     m_mirrorX( false ), m_mirrorY( false ),
+    m_lodThreshold( 1.0 ),
+    m_parallelRendering( true ),
+    m_progressiveRedraw( false ),
+    m_redrawBudget( 30.0 ),
+    m_redrawPending( false ),
+    m_redrawLayer( 0 ),
+    m_imageValid( false ),
     m_painter( NULL ),
     m_gal( NULL ),
     m_dynamic( aIsDynamic )
@@ -279,6 +325,17 @@ VIEW::VIEW( bool aIsDynamic ) :
 
 VIEW::~VIEW()
 {
+    // Items may outlive the view (e.g. a board rendered by a temporary view), so they must not
+    // keep pointing to it
+    for( VIEW_ITEM* item : m_allItems )
+    {
+        if( item->m_viewPrivData && item->m_viewPrivData->m_view == this )
+        {
+            delete item->m_viewPrivData;
+            item->m_viewPrivData = nullptr;
+        }
+    }
+
     for( LAYER_MAP::value_type& l : m_layers )
         delete l.second.items;
 }
@@ -310,14 +367,15 @@ void VIEW::Add( VIEW_ITEM* aItem )
 
     aItem->ViewGetLayers( layers, layers_count );
     aItem->viewPrivData()->saveLayers( layers, layers_count );
+    aItem->viewPrivData()->m_bbox = aItem->ViewBBox();
 
     m_allItems.push_back( aItem );
 
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Insert( aItem, aItem->viewPrivData()->m_bbox );
+        markAreaDirty( l.target, aItem->viewPrivData()->m_bbox );
     }
 
     SetVisible( aItem, true );
@@ -325,6 +383,57 @@ void VIEW::Add( VIEW_ITEM* aItem )
 }
 
 
+void VIEW::AddItems( const std::vector<VIEW_ITEM*>& aItems )
+{
+    if( aItems.empty() )
+        return;
+
+    int layers[VIEW_MAX_LAYERS], layers_count;
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        item->m_viewPrivData = new VIEW_ITEM_DATA;
+        item->m_viewPrivData->m_view = this;
+
+        item->ViewGetLayers( layers, layers_count );
+        item->viewPrivData()->saveLayers( layers, layers_count );
+    }
+
+    std::vector<BOX2I> bboxes( aItems.size() );
+
+    parallelFor( aItems.size(), [&]( unsigned i )
+    {
+        bboxes[i] = aItems[i]->ViewBBox();
+    } );
+
+    // Sort the items by layer, so every R-tree is loaded in one go
+    std::unordered_map< int, std::vector< std::pair<VIEW_ITEM*, BOX2I> > > layerItems;
+
+    for( unsigned i = 0; i < aItems.size(); ++i )
+    {
+        auto viewData = aItems[i]->viewPrivData();
+        viewData->m_bbox = bboxes[i];
+        viewData->getLayers( layers, layers_count );
+
+        for( int j = 0; j < layers_count; ++j )
+            layerItems[layers[j]].push_back( std::make_pair( aItems[i], bboxes[i] ) );
+    }
+
+    for( auto& l : layerItems )
+        m_layers[l.first].items->BulkLoad( l.second );
+
+    m_allItems.insert( m_allItems.end(), aItems.begin(), aItems.end() );
+
+    // The R-trees and the bounding boxes are already up to date, only the cached geometry
+    // is missing.  It has to be built by UpdateItems(): the GAL may accept new groups only
+    // between BeginUpdate() and EndUpdate(), which draw() does not call.
+    for( VIEW_ITEM* item : aItems )
+        Update( item, KIGFX::REPAINT );
+
+    MarkDirty();
+}
+
+
 void VIEW::Remove( VIEW_ITEM* aItem )
 {
     if( !aItem )
@@ -349,8 +458,8 @@ void VIEW::Remove( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Remove( aItem, viewData->m_bbox );
+        markAreaDirty( l.target, viewData->m_bbox );
 
         // Clear the GAL cache
         int prevGroup = viewData->getGroup( layers[i] );
@@ -473,6 +582,11 @@ void VIEW::SetGAL( GAL* aGal )
     // clear group numbers, so everything is going to be recached
     clearGroupCache();
 
+    // the new GAL has neither the previous image nor a half-done redraw
+    m_redrawPending = false;
+    m_redrawLayer   = 0;
+    m_imageValid    = false;
+
     // every target has to be refreshed
     MarkDirty();
 
@@ -539,15 +653,17 @@ void VIEW::SetScale( double aScale, const VECTOR2D& aAnchor )
 
     VECTOR2D delta = ToWorld( a ) - aAnchor;
 
-    SetCenter( m_center - delta );
-
     // Redraw everything after the viewport has changed
     MarkDirty();
+
+    SetCenter( m_center - delta );
 }
 
 
 void VIEW::SetCenter( const VECTOR2D& aCenter )
 {
+    VECTOR2D origin = ToScreen( VECTOR2D( 0, 0 ) );
+
     m_center = aCenter;
 
     if( !m_boundary.Contains( aCenter ) )
@@ -566,6 +682,48 @@ void VIEW::SetCenter( const VECTOR2D& aCenter )
     m_gal->SetLookAtPoint( m_center );
     m_gal->ComputeWorldScreenMatrix();
 
+    // Panning does not change the rendered image, it only moves it. If the GAL keeps the image,
+    // it is scrolled and only the uncovered strips are drawn.
+    if( m_gal->IsPartialRedrawSupported() && !m_redrawPending
+            && !IsTargetDirty( TARGET_CACHED ) && !IsTargetDirty( TARGET_NONCACHED ) )
+    {
+        VECTOR2D screenSize = m_gal->GetScreenPixelSize();
+        VECTOR2D delta      = ToScreen( VECTOR2D( 0, 0 ) ) - origin;
+        VECTOR2D snapped( std::round( delta.x ), std::round( delta.y ) );
+
+        // Scroll by whole pixels only, so the moved image matches the newly drawn strips
+        m_center -= ToWorld( snapped - delta, false );
+        m_gal->SetLookAtPoint( m_center );
+        m_gal->ComputeWorldScreenMatrix();
+
+        if( std::fabs( snapped.x ) < screenSize.x && std::fabs( snapped.y ) < screenSize.y
+                && m_gal->ScrollTarget( TARGET_CACHED, VECTOR2I( snapped ) ) )
+        {
+            BOX2D strip;
+
+            if( snapped.x > 0 )
+                strip = BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( snapped.x, screenSize.y ) );
+            else if( snapped.x < 0 )
+                strip = BOX2D( VECTOR2D( screenSize.x + snapped.x, 0 ),
+                               VECTOR2D( -snapped.x, screenSize.y ) );
+
+            if( snapped.x != 0 )
+                markScreenAreaDirty( strip );
+
+            if( snapped.y > 0 )
+                strip = BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( screenSize.x, snapped.y ) );
+            else if( snapped.y < 0 )
+                strip = BOX2D( VECTOR2D( 0, screenSize.y + snapped.y ),
+                               VECTOR2D( screenSize.x, -snapped.y ) );
+
+            if( snapped.y != 0 )
+                markScreenAreaDirty( strip );
+
+            MarkTargetDirty( TARGET_OVERLAY );
+            return;
+        }
+    }
+
     // Redraw everything after the viewport has changed
     MarkDirty();
 }
@@ -812,9 +970,13 @@ void VIEW::UpdateAllLayersOrder()
 
 struct VIEW::drawItem
 {
-    drawItem( VIEW* aView, int aLayer ) :
-        view( aView ), layer( aLayer )
+    drawItem( VIEW* aView, int aLayer, const BOX2I& aRect, double aLodSize,
+              LAYER_BATCH* aBatch = nullptr ) :
+        view( aView ), layer( aLayer ), origin( aRect.GetOrigin() ), lodSize( aLodSize ),
+        batch( aBatch ), complete( true ), stats( nullptr )
     {
+        if( aView->m_renderStats.IsEnabled() )
+            stats = &aView->m_renderStats.Layer( aLayer );
     }
 
     bool operator()( VIEW_ITEM* aItem )
@@ -825,31 +987,399 @@ struct VIEW::drawItem
         bool drawCondition = aItem->viewPrivData()->isRenderable() &&
                              aItem->ViewGetLOD( layer, view ) < view->m_scale;
         if( !drawCondition )
+        {
+            if( stats )
+                stats->culled++;
+
+            return true;
+        }
+
+        const BOX2I& bbox = aItem->viewPrivData()->m_bbox;
+
+        // Items smaller than the LOD threshold are not worth drawing in detail,
+        // they are merged into a single filled cell per screen area instead.
+        if( std::abs( bbox.GetWidth() ) < lodSize && std::abs( bbox.GetHeight() ) < lodSize )
+        {
+            if( stats )
+                stats->culled++;
+
+            addProxy( aItem, bbox );
             return true;
+        }
+
+        if( batch )
+        {
+            int group = aItem->viewPrivData()->getGroup( layer );
+
+            // An item that is not cached yet cannot be batched, the whole layer
+            // has to be drawn the usual way
+            if( group < 0 )
+            {
+                complete = false;
+                return false;
+            }
+
+            batch->groups.push_back( group );
+
+            if( stats )
+            {
+                stats->drawn++;
+                stats->cacheHits++;
+            }
+
+            return true;
+        }
+
+        if( stats )
+            stats->drawn++;
 
         view->draw( aItem, layer );
 
         return true;
     }
 
+    void addProxy( VIEW_ITEM* aItem, const BOX2I& aBBox )
+    {
+        const VECTOR2I center = aBBox.Centre();
+        int64_t col = (int64_t) std::floor( ( center.x - origin.x ) / lodSize );
+        int64_t row = (int64_t) std::floor( ( center.y - origin.y ) / lodSize );
+        uint64_t cell = ( (uint64_t) row << 32 ) | (uint32_t) col;
+
+        proxies.push_back( LOD_PROXY( cell, aItem ) );
+    }
+
+    /**
+     * Function getProxies()
+     * Returns one filled cell for every screen area that contained items below the LOD
+     * threshold. The cell takes the color of the first item found in it.
+     */
+    void getProxies( std::vector< std::pair<BOX2D, COLOR4D> >& aRects )
+    {
+        if( proxies.empty() )
+            return;
+
+        std::stable_sort( proxies.begin(), proxies.end(),
+                []( const LOD_PROXY& aA, const LOD_PROXY& aB ) { return aA.first < aB.first; } );
+
+        RENDER_SETTINGS* settings = view->GetPainter()->GetSettings();
+
+        for( unsigned i = 0; i < proxies.size(); ++i )
+        {
+            if( i > 0 && proxies[i].first == proxies[i - 1].first )
+                continue;
+
+            uint64_t cell = proxies[i].first;
+            int32_t col = (int32_t) ( cell & 0xffffffff );
+            int32_t row = (int32_t) ( cell >> 32 );
+            VECTOR2D start( origin.x + col * lodSize, origin.y + row * lodSize );
+
+            aRects.push_back( std::make_pair( BOX2D( start, VECTOR2D( lodSize, lodSize ) ),
+                                              settings->GetColor( proxies[i].second, layer ) ) );
+        }
+    }
+
+    /// Draws the cells returned by getProxies()
+    void drawProxies( GAL* aGal, RENDER_TARGET aTarget )
+    {
+        std::vector< std::pair<BOX2D, COLOR4D> > rects;
+
+        getProxies( rects );
+
+        if( rects.empty() )
+            return;
+
+        // Proxies are recomputed on every redraw, so they must not end up in the cache
+        aGal->SetTarget( TARGET_NONCACHED );
+        aGal->SetIsFill( true );
+        aGal->SetIsStroke( false );
+
+        for( const std::pair<BOX2D, COLOR4D>& rect : rects )
+        {
+            aGal->SetFillColor( rect.second );
+            aGal->DrawRectangle( rect.first.GetOrigin(), rect.first.GetEnd() );
+        }
+
+        aGal->SetTarget( aTarget );
+    }
+
+    ///> Screen cell (row in upper, column in lower half) and the item that fell into it.
+    typedef std::pair<uint64_t, VIEW_ITEM*> LOD_PROXY;
+
     VIEW* view;
     int layer, layers[VIEW_MAX_LAYERS];
+    VECTOR2D origin;
+    double lodSize;
+    std::vector<LOD_PROXY> proxies;
+    LAYER_BATCH* batch;     ///< if set, groups are collected here instead of being drawn
+    bool complete;          ///< false if an item could not be added to the batch
+    RENDER_STATS::LAYER_STATS* stats;   ///< counters of the layer, if statistics are enabled
 };
 
 
-void VIEW::redrawRect( const BOX2I& aRect )
+unsigned int VIEW::redrawRect( const BOX2I& aRect, bool aDirtyArea, unsigned int aFirstLayer,
+                               double aTimeBudget )
 {
-    for( VIEW_LAYER* l : m_orderedLayers )
+    // World size of an item that covers m_lodThreshold pixels on the screen
+    double lodSize = m_lodThreshold > 0.0 ? std::fabs( ToWorld( m_lodThreshold ) ) : 0.0;
+
+    // Consecutive cached layers are collected and handed over to the GAL at once,
+    // so it may rasterize them in parallel
+    bool parallel = m_parallelRendering && m_gal->IsParallelRenderingSupported();
+    std::vector<LAYER_BATCH> batches;
+    std::vector<int> batchedLayers;
+    bool collectStats = m_renderStats.IsEnabled();
+
+    // Rasterization of the batched layers is shared equally between them in the statistics
+    auto flushBatches = [&]()
+    {
+        PROF_COUNTER batchTime;
+
+        m_gal->SetTarget( TARGET_CACHED );
+        m_gal->DrawLayerBatches( batches );
+        batches.clear();
+
+        if( collectStats )
+        {
+            batchTime.Stop();
+
+            for( int layer : batchedLayers )
+                m_renderStats.Layer( layer ).time += batchTime.msecs() / batchedLayers.size();
+        }
+
+        batchedLayers.clear();
+    };
+
+    // Overlay layers are always drawn, the others are drawn until the time budget is used up.
+    // Batches are flushed often enough for their rasterization time to count too.
+    PROF_COUNTER budgetTime;
+    unsigned int nextLayer = m_orderedLayers.size();
+    unsigned int maxBatches = std::max( 1u, std::thread::hardware_concurrency() );
+
+    auto checkBudget = [&]( unsigned int aLayerIdx )
+    {
+        if( aTimeBudget <= 0.0 )
+            return;
+
+        if( batches.size() >= maxBatches )
+            flushBatches();
+
+        if( budgetTime.msecs() >= aTimeBudget )
+            nextLayer = aLayerIdx + 1;
+    };
+
+    for( unsigned int i = 0; i < m_orderedLayers.size(); ++i )
+    {
+        VIEW_LAYER* l = m_orderedLayers[i];
+        bool redraw;
+
+        if( l->target == TARGET_OVERLAY )
+            redraw = !aDirtyArea && IsTargetDirty( l->target );
+        else
+            redraw = i >= aFirstLayer && i < nextLayer
+                     && ( aDirtyArea || m_redrawPending || IsTargetDirty( l->target ) );
+
+        if( !l->visible || !redraw || !areRequiredLayersEnabled( l->id ) )
+            continue;
+
+        PROF_COUNTER layerTime;
+
+        if( parallel && l->target == TARGET_CACHED )
+        {
+            RENDER_STATS::LAYER_STATS savedStats;
+
+            if( collectStats )
+                savedStats = m_renderStats.Layer( l->id );
+
+            LAYER_BATCH batch;
+            drawItem collectFunc( this, l->id, aRect, lodSize, &batch );
+
+            l->items->Query( aRect, collectFunc );
+
+            if( collectFunc.complete )
+            {
+                batch.depth = l->renderingOrder;
+                collectFunc.getProxies( batch.rects );
+
+                if( !batch.groups.empty() || !batch.rects.empty() )
+                {
+                    batches.push_back( std::move( batch ) );
+                    batchedLayers.push_back( l->id );
+                }
+
+                if( collectStats )
+                {
+                    layerTime.Stop();
+                    m_renderStats.Layer( l->id ).time += layerTime.msecs();
+                }
+
+                checkBudget( i );
+                continue;
+            }
+
+            // Start over, the items are drawn the usual way below
+            if( collectStats )
+                m_renderStats.Layer( l->id ) = savedStats;
+        }
+
+        if( !batches.empty() )
+        {
+            flushBatches();
+            layerTime.Start();
+        }
+
+        // Overlay items (selection, previews) are always drawn in full detail
+        drawItem drawFunc( this, l->id, aRect, l->target == TARGET_OVERLAY ? 0.0 : lodSize );
+
+        m_gal->SetTarget( l->target );
+        m_gal->SetLayerDepth( l->renderingOrder );
+        l->items->Query( aRect, drawFunc );
+        drawFunc.drawProxies( m_gal, l->target );
+
+        if( collectStats )
+        {
+            layerTime.Stop();
+            m_renderStats.Layer( l->id ).time += layerTime.msecs();
+        }
+
+        if( l->target != TARGET_OVERLAY )
+            checkBudget( i );
+    }
+
+    if( !batches.empty() )
+        flushBatches();
+
+    return nextLayer;
+}
+
+
+void VIEW::markAreaDirty( int aTarget, const BOX2I& aArea )
+{
+    // A half-done progressive redraw cannot be patched, it starts over instead
+    if( aTarget == TARGET_OVERLAY || IsTargetDirty( aTarget ) || !m_gal
+            || !m_gal->IsPartialRedrawSupported() || m_redrawPending )
+    {
+        MarkTargetDirty( aTarget );
+        return;
+    }
+
+    // Past some point tracking the areas costs more than redrawing everything
+    if( m_dirtyAreas.size() >= MAX_DIRTY_AREAS )
+    {
+        MarkTargetDirty( aTarget );
+        m_dirtyAreas.clear();
+        return;
+    }
+
+    m_dirtyAreas.push_back( aArea );
+}
+
+
+void VIEW::markScreenAreaDirty( const BOX2D& aArea )
+{
+    BOX2I area( ToWorld( aArea.GetOrigin() ),
+                ToWorld( aArea.GetEnd() ) - ToWorld( aArea.GetOrigin() ) );
+    area.Normalize();
+
+    markAreaDirty( TARGET_CACHED, area );
+}
+
+
+void VIEW::redrawDirtyAreas()
+{
+    VECTOR2D screenSize = m_gal->GetScreenPixelSize();
+    int      cols       = ( (int) screenSize.x + DIRTY_TILE_SIZE - 1 ) / DIRTY_TILE_SIZE;
+    int      rows       = ( (int) screenSize.y + DIRTY_TILE_SIZE - 1 ) / DIRTY_TILE_SIZE;
+    int      dirtyCount = 0;
+
+    if( cols <= 0 || rows <= 0 )
+        return;
+
+    std::vector<bool> dirtyTiles( cols * rows, false );
+
+    for( const BOX2I& area : m_dirtyAreas )
     {
-        if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
+        VECTOR2D a = ToScreen( VECTOR2D( area.GetOrigin() ) );
+        VECTOR2D b = ToScreen( VECTOR2D( area.GetEnd() ) );
+
+        // Minimal line widths may make items spill a pixel or two out of their bounding boxes
+        double left   = std::max( 0.0, std::min( a.x, b.x ) - 2.0 );
+        double right  = std::min( screenSize.x - 1.0, std::max( a.x, b.x ) + 2.0 );
+        double top    = std::max( 0.0, std::min( a.y, b.y ) - 2.0 );
+        double bottom = std::min( screenSize.y - 1.0, std::max( a.y, b.y ) + 2.0 );
+
+        if( left > right || top > bottom )
+            continue;       // not visible
+
+        for( int row = (int) top / DIRTY_TILE_SIZE; row <= (int) bottom / DIRTY_TILE_SIZE; ++row )
         {
-            drawItem drawFunc( this, l->id );
+            for( int col = (int) left / DIRTY_TILE_SIZE; col <= (int) right / DIRTY_TILE_SIZE; ++col )
+            {
+                if( !dirtyTiles[row * cols + col] )
+                {
+                    dirtyTiles[row * cols + col] = true;
+                    ++dirtyCount;
+                }
+            }
+        }
+    }
 
-            m_gal->SetTarget( l->target );
-            m_gal->SetLayerDepth( l->renderingOrder );
-            l->items->Query( aRect, drawFunc );
+    // Merge the dirty tiles into rectangles: runs of tiles in a row, then equal runs
+    // in consecutive rows
+    std::vector<BOX2I> rects;
+
+    if( 2 * dirtyCount > cols * rows )
+    {
+        rects.push_back( BOX2I( VECTOR2I( 0, 0 ), VECTOR2I( screenSize ) ) );
+    }
+    else
+    {
+        for( int row = 0; row < rows; ++row )
+        {
+            for( int col = 0; col < cols; )
+            {
+                if( !dirtyTiles[row * cols + col] )
+                {
+                    ++col;
+                    continue;
+                }
+
+                int first = col;
+
+                while( col < cols && dirtyTiles[row * cols + col] )
+                    ++col;
+
+                BOX2I run( VECTOR2I( first * DIRTY_TILE_SIZE, row * DIRTY_TILE_SIZE ),
+                           VECTOR2I( ( col - first ) * DIRTY_TILE_SIZE, DIRTY_TILE_SIZE ) );
+                bool merged = false;
+
+                for( BOX2I& rect : rects )
+                {
+                    if( rect.GetX() == run.GetX() && rect.GetWidth() == run.GetWidth()
+                            && rect.GetBottom() == run.GetY() )
+                    {
+                        rect.SetHeight( rect.GetHeight() + DIRTY_TILE_SIZE );
+                        merged = true;
+                        break;
+                    }
+                }
+
+                if( !merged )
+                    rects.push_back( run );
+            }
         }
     }
+
+    for( const BOX2I& rect : rects )
+    {
+        BOX2I area( ToWorld( VECTOR2D( rect.GetOrigin() ) ),
+                    ToWorld( VECTOR2D( rect.GetEnd() ) ) - ToWorld( VECTOR2D( rect.GetOrigin() ) ) );
+        area.Normalize();
+
+        m_gal->BeginPartialRedraw( rect );
+        m_gal->DrawGrid();
+        redrawRect( area, true );
+        m_gal->EndPartialRedraw();
+    }
 }
 
 
@@ -865,6 +1395,16 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
         // Draw using cached information or create one
         int group = viewData->getGroup( aLayer );
 
+        if( m_renderStats.IsEnabled() )
+        {
+            RENDER_STATS::LAYER_STATS& stats = m_renderStats.Layer( aLayer );
+
+            if( group >= 0 )
+                stats.cacheHits++;
+            else
+                stats.cacheMisses++;
+        }
+
         if( group >= 0 )
         {
             m_gal->DrawGroup( group );
@@ -913,38 +1453,6 @@ void VIEW::draw( VIEW_GROUP* aGroup, bool aImmediate )
 }
 
 
-struct VIEW::recacheItem
-{
-    recacheItem( VIEW* aView, GAL* aGal, int aLayer ) :
-        view( aView ), gal( aGal ), layer( aLayer )
-    {
-    }
-
-    bool operator()( VIEW_ITEM* aItem )
-    {
-        auto viewData = aItem->viewPrivData();
-
-        if( !viewData )
-            return false;
-
-        // Remove previously cached group
-        int group = viewData->getGroup( layer );
-
-        if( group >= 0 )
-            gal->DeleteGroup( group );
-
-        viewData->setGroup( layer, -1 );
-        view->Update( aItem );
-
-        return true;
-    }
-
-    VIEW* view;
-    GAL* gal;
-    int layer;
-};
-
-
 void VIEW::Clear()
 {
     BOX2I r;
@@ -959,10 +1467,37 @@ void VIEW::Clear()
 }
 
 
+void VIEW::showRedrawPreview()
+{
+    if( !m_imageValid )
+        return;
+
+    // Transformation from the screen of the last complete image to the current screen
+    MATRIX3x3D t = m_gal->GetWorldScreenMatrix() * m_imageMatrix.Inverse();
+    const double eps = 1e-6;
+
+    // Zooming and panning only scale and move the image, anything else needs a fresh one
+    bool similar = t.m_data[0][0] > eps && std::fabs( t.m_data[0][0] - t.m_data[1][1] ) < eps
+                   && std::fabs( t.m_data[0][1] ) < eps && std::fabs( t.m_data[1][0] ) < eps;
+
+    if( !similar || !m_gal->ShowTargetPreview( TARGET_CACHED, t.m_data[0][0],
+                                               VECTOR2D( t.m_data[0][2], t.m_data[1][2] ) ) )
+    {
+        m_gal->HideTargetPreview();
+
+        // The image is lost as soon as the targets are cleared
+        m_imageValid = false;
+    }
+}
+
+
 void VIEW::ClearTargets()
 {
     if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
     {
+        if( m_progressiveRedraw )
+            showRedrawPreview();
+
         // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
         // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
         m_gal->ClearTarget( TARGET_NONCACHED );
@@ -980,29 +1515,72 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
-#ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime;
-#endif /* __WXDEBUG__ */
 
     VECTOR2D screenSize = m_gal->GetScreenPixelSize();
     BOX2I    rect( ToWorld( VECTOR2D( 0, 0 ) ),
                    ToWorld( screenSize ) - ToWorld( VECTOR2D( 0, 0 ) ) );
     rect.Normalize();
 
-    redrawRect( rect );
+    // A change of the targets cancels the pending progressive redraw, it starts over
+    if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
+    {
+        m_redrawPending = false;
+        m_redrawLayer   = 0;
+    }
+
+    if( !m_dirtyAreas.empty() )
+    {
+        // Dirty areas matter only if the whole cached & noncached targets are not redrawn anyway
+        if( !IsTargetDirty( TARGET_CACHED ) && !IsTargetDirty( TARGET_NONCACHED ) )
+            redrawDirtyAreas();
+
+        m_dirtyAreas.clear();
+    }
+
+    unsigned int nextLayer = redrawRect( rect, false, m_redrawLayer,
+                                         m_progressiveRedraw ? m_redrawBudget : 0.0 );
+
+    m_redrawPending = nextLayer < m_orderedLayers.size();
+    m_redrawLayer   = m_redrawPending ? nextLayer : 0;
 
-    // All targets were redrawn, so nothing is dirty
+    // The complete image replaces the preview and becomes the source of the next one
+    if( !m_redrawPending )
+    {
+        m_gal->HideTargetPreview();
+        m_imageMatrix = m_gal->GetWorldScreenMatrix();
+        m_imageValid  = true;
+    }
+
+    // All targets were redrawn (or a progressive redraw continues with the next call),
+    // so nothing is dirty
     markTargetClean( TARGET_CACHED );
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
 
-#ifdef __WXDEBUG__
     totalRealTime.Stop();
+
+    if( m_renderStats.IsEnabled() )
+        m_renderStats.AddRedrawTime( totalRealTime.msecs() );
+
+#ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", wxT( "VIEW::Redraw(): %.1f ms" ), totalRealTime.msecs() );
 #endif /* __WXDEBUG__ */
 }
 
 
+void VIEW::SetProgressiveRedraw( bool aEnabled )
+{
+    m_progressiveRedraw = aEnabled;
+
+    if( !aEnabled && m_gal )
+        m_gal->HideTargetPreview();
+
+    // Finish a pending redraw in one go, or start using the time budget
+    MarkDirty();
+}
+
+
 const VECTOR2I& VIEW::GetScreenPixelSize() const
 {
     return m_gal->GetScreenPixelSize();
@@ -1042,13 +1620,13 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags, const BOX2I& aBBox )
 {
     // updateLayers updates geometry too, so we do not have to update both of them at the same time
     if( aUpdateFlags & LAYERS )
-        updateLayers( aItem );
+        updateLayers( aItem, aBBox );
     else if( aUpdateFlags & GEOMETRY )
-        updateBbox( aItem );
+        updateBbox( aItem, aBBox );
 
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
@@ -1060,14 +1638,14 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
 
         if( IsCached( layerId ) )
         {
-            if( aUpdateFlags & ( GEOMETRY | LAYERS ) )
+            if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
                 updateItemGeometry( aItem, layerId );
             else if( aUpdateFlags & COLOR )
                 updateItemColor( aItem, layerId );
         }
 
         // Mark those layers as dirty, so the VIEW will be refreshed
-        MarkTargetDirty( m_layers[layerId].target );
+        markAreaDirty( m_layers[layerId].target, aItem->viewPrivData()->m_bbox );
     }
 
     aItem->viewPrivData()->clearUpdateFlags();
@@ -1138,23 +1716,27 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
 }
 
 
-void VIEW::updateBbox( VIEW_ITEM* aItem )
+void VIEW::updateBbox( VIEW_ITEM* aItem, const BOX2I& aBBox )
 {
+    auto viewData = aItem->viewPrivData();
     int layers[VIEW_MAX_LAYERS], layers_count;
 
-    aItem->ViewGetLayers( layers, layers_count );
+    viewData->getLayers( layers, layers_count );
 
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Remove( aItem, viewData->m_bbox );
+        l.items->Insert( aItem, aBBox );
+        markAreaDirty( l.target, viewData->m_bbox );
+        markAreaDirty( l.target, aBBox );
     }
+
+    viewData->m_bbox = aBBox;
 }
 
 
-void VIEW::updateLayers( VIEW_ITEM* aItem )
+void VIEW::updateLayers( VIEW_ITEM* aItem, const BOX2I& aBBox )
 {
     auto viewData = aItem->viewPrivData();
     int layers[VIEW_MAX_LAYERS], layers_count;
@@ -1168,8 +1750,8 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Remove( aItem, viewData->m_bbox );
+        markAreaDirty( l.target, viewData->m_bbox );
 
         if( IsCached( l.id ) )
         {
@@ -1187,12 +1769,13 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     viewData->saveLayers( layers, layers_count );
+    viewData->m_bbox = aBBox;
 
     for( int i = 0; i < layers_count; i++ )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Insert( aItem, aBBox );
+        markAreaDirty( l.target, aBBox );
     }
 }
 
@@ -1217,41 +1800,48 @@ bool VIEW::areRequiredLayersEnabled( int aLayerId ) const
 
 void VIEW::RecacheAllItems()
 {
-    BOX2I r;
-
-    r.SetMaximum();
+    // Dropping the whole GAL cache at once is much cheaper than freeing the groups one by one
+    m_gal->ClearCache();
 
-    for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+    // Only the cached geometry has to be regenerated, the bounding boxes and layers are intact
+    for( VIEW_ITEM* item : m_allItems )
     {
-        VIEW_LAYER* l = &( ( *i ).second );
-
-        if( IsCached( l->id ) )
-        {
-            recacheItem visitor( this, m_gal, l->id );
-            l->items->Query( r, visitor );
-        }
+        item->viewPrivData()->deleteGroups();
+        Update( item, REPAINT );
     }
 }
 
 
 void VIEW::UpdateItems()
 {
-    m_gal->BeginUpdate();
+    std::vector<VIEW_ITEM*> items;
 
     for( VIEW_ITEM* item : m_allItems )
     {
         auto viewData = item->viewPrivData();
 
-        if( !viewData )
-            continue;
-
-        if( viewData->m_requiredUpdate != NONE )
-        {
-            invalidateItem( item, viewData->m_requiredUpdate );
-            viewData->m_requiredUpdate = NONE;
-        }
+        if( viewData && viewData->m_requiredUpdate != NONE )
+            items.push_back( item );
     }
 
+    if( items.empty() )
+        return;
+
+    // Bounding boxes are only read from the items, so unlike the R-trees and the GAL, they
+    // can be computed on as many threads as there are cores.
+    std::vector<BOX2I> bboxes( items.size() );
+
+    parallelFor( items.size(), [&]( unsigned i )
+    {
+        if( items[i]->viewPrivData()->m_requiredUpdate & ( GEOMETRY | LAYERS ) )
+            bboxes[i] = items[i]->ViewBBox();
+    } );
+
+    m_gal->BeginUpdate();
+
+    for( unsigned i = 0; i < items.size(); ++i )
+        invalidateItem( items[i], items[i]->viewPrivData()->m_requiredUpdate, bboxes[i] );
+
     m_gal->EndUpdate();
 }
 
@@ -1362,4 +1952,8 @@ void VIEW::Update( VIEW_ITEM* aItem, int aUpdateFlags )
 
 const int VIEW::TOP_LAYER_MODIFIER = -VIEW_MAX_LAYERS;
 
+const int VIEW::DIRTY_TILE_SIZE = 64;
+
+const unsigned int VIEW::MAX_DIRTY_AREAS = 1024;
+
 };
@@ -0,0 +1,468 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/detail/xml_parser_error.hpp>
+
+#include <xml_stream.h>
+
+
+#define XML_STREAM_BUFZ     (64*1024)
+
+
+XML_STREAM::XML_STREAM( const std::string& aFileName ) :
+    m_fileName( aFileName ),
+    m_line( 1 ),
+    m_buffer( XML_STREAM_BUFZ ),
+    m_pos( 0 ),
+    m_len( 0 ),
+    m_depth( 0 ),
+    m_pendingEnd( false )
+{
+    m_fp = fopen( aFileName.c_str(), "rb" );
+
+    if( !m_fp )
+        throw boost::property_tree::xml_parser::xml_parser_error( "cannot open file", aFileName, 0 );
+}
+
+
+XML_STREAM::~XML_STREAM()
+{
+    fclose( m_fp );
+}
+
+
+bool XML_STREAM::fill()
+{
+    m_pos = 0;
+    m_len = fread( &m_buffer[0], 1, m_buffer.size(), m_fp );
+
+    return m_len > 0;
+}
+
+
+void XML_STREAM::error( const char* aMessage )
+{
+    throw boost::property_tree::xml_parser::xml_parser_error( aMessage, m_fileName, m_line );
+}
+
+
+void XML_STREAM::skipSpace()
+{
+    int c;
+
+    while( ( c = peek() ) == ' ' || c == '\t' || c == '\n' || c == '\r' )
+        get();
+}
+
+
+void XML_STREAM::expect( char aChar )
+{
+    if( get() != aChar )
+    {
+        char msg[32];
+        snprintf( msg, sizeof(msg), "expected '%c'", aChar );
+        error( msg );
+    }
+}
+
+
+static inline bool isNameChar( int c )
+{
+    return c != EOF && c != ' ' && c != '\t' && c != '\n' && c != '\r'
+        && c != '/' && c != '>' && c != '=' && c != '<' && c != '?';
+}
+
+
+void XML_STREAM::readName( std::string& aName )
+{
+    aName.clear();
+
+    while( isNameChar( peek() ) )
+        aName += (char) get();
+
+    if( aName.empty() )
+        error( "expected element or attribute name" );
+}
+
+
+void XML_STREAM::readUntil( const char* aTerminator, std::string* aOut )
+{
+    size_t  len = strlen( aTerminator );
+    size_t  matched = 0;
+
+    while( matched < len )
+    {
+        int c = get();
+
+        if( c == EOF )
+            error( "unexpected end of data" );
+
+        if( c == aTerminator[matched] )
+        {
+            ++matched;
+            continue;
+        }
+
+        // Fall back to the longest tail of the chars seen so far which still begins the
+        // terminator, e.g. "]]]>" ending a CDATA section.
+        std::string seen( aTerminator, matched );
+        seen += (char) c;
+
+        size_t keep = std::min( matched, seen.size() - 1 );
+
+        while( keep && seen.compare( seen.size() - keep, keep, aTerminator, keep ) )
+            --keep;
+
+        if( aOut )
+            aOut->append( seen, 0, seen.size() - keep );
+
+        matched = keep;
+    }
+}
+
+
+void XML_STREAM::skipDeclaration()
+{
+    // "<!" has been read, skip to the matching '>' including an internal subset
+    int nest = 0;
+    int c;
+
+    while( ( c = get() ) != EOF )
+    {
+        if( c == '[' )
+            ++nest;
+        else if( c == ']' )
+            --nest;
+        else if( c == '>' && nest <= 0 )
+            return;
+    }
+
+    error( "unexpected end of data" );
+}
+
+
+static void appendUtf8( std::string& aOut, unsigned long aCode )
+{
+    if( aCode < 0x80 )
+        aOut += (char) aCode;
+    else if( aCode < 0x800 )
+    {
+        aOut += (char) ( 0xC0 | ( aCode >> 6 ) );
+        aOut += (char) ( 0x80 | ( aCode & 0x3F ) );
+    }
+    else if( aCode < 0x10000 )
+    {
+        aOut += (char) ( 0xE0 | ( aCode >> 12 ) );
+        aOut += (char) ( 0x80 | ( ( aCode >> 6 ) & 0x3F ) );
+        aOut += (char) ( 0x80 | ( aCode & 0x3F ) );
+    }
+    else
+    {
+        aOut += (char) ( 0xF0 | ( aCode >> 18 ) );
+        aOut += (char) ( 0x80 | ( ( aCode >> 12 ) & 0x3F ) );
+        aOut += (char) ( 0x80 | ( ( aCode >> 6 ) & 0x3F ) );
+        aOut += (char) ( 0x80 | ( aCode & 0x3F ) );
+    }
+}
+
+
+void XML_STREAM::decode( const std::string& aRaw, std::string& aOut )
+{
+    aOut.clear();
+
+    for( size_t i = 0;  i < aRaw.size();  ++i )
+    {
+        if( aRaw[i] != '&' )
+        {
+            aOut += aRaw[i];
+            continue;
+        }
+
+        size_t semi = aRaw.find( ';', i );
+
+        if( semi == std::string::npos )
+        {
+            aOut += aRaw[i];
+            continue;
+        }
+
+        const char* ent = aRaw.c_str() + i + 1;
+        size_t      len = semi - i - 1;
+
+        if( len == 2 && !strncmp( ent, "lt", 2 ) )
+            aOut += '<';
+        else if( len == 2 && !strncmp( ent, "gt", 2 ) )
+            aOut += '>';
+        else if( len == 3 && !strncmp( ent, "amp", 3 ) )
+            aOut += '&';
+        else if( len == 4 && !strncmp( ent, "quot", 4 ) )
+            aOut += '"';
+        else if( len == 4 && !strncmp( ent, "apos", 4 ) )
+            aOut += '\'';
+        else if( len > 1 && ent[0] == '#' )
+        {
+            bool            hex = ent[1] == 'x';
+            std::string     digits( ent + ( hex ? 2 : 1 ), ent + len );
+            char*           end;
+            unsigned long   code = strtoul( digits.c_str(), &end, hex ? 16 : 10 );
+
+            if( digits.empty() || *end )
+            {
+                // not a character reference, keep it as it is like read_xml() does
+                aOut.append( aRaw, i, semi - i + 1 );
+            }
+            else
+                appendUtf8( aOut, code );
+        }
+        else
+        {
+            aOut.append( aRaw, i, semi - i + 1 );
+        }
+
+        i = semi;
+    }
+}
+
+
+XML_STREAM::TOKEN XML_STREAM::next()
+{
+    if( m_pendingEnd )
+    {
+        m_pendingEnd = false;
+        return T_END;
+    }
+
+    for(;;)
+    {
+        int c = peek();
+
+        if( c == EOF )
+            return T_EOF;
+
+        if( c != '<' )
+        {
+            m_raw.clear();
+
+            while( ( c = peek() ) != EOF && c != '<' )
+                m_raw += (char) get();
+
+            decode( m_raw, m_text );
+            return T_TEXT;
+        }
+
+        get();      // '<'
+        c = peek();
+
+        if( c == '?' )
+        {
+            readUntil( "?>", NULL );
+            continue;
+        }
+
+        if( c == '!' )
+        {
+            get();
+
+            if( peek() == '-' )
+            {
+                get();
+                expect( '-' );
+                readUntil( "-->", NULL );
+                continue;
+            }
+
+            if( peek() == '[' )
+            {
+                get();
+
+                for( const char* p = "CDATA[";  *p;  ++p )
+                    expect( *p );
+
+                m_text.clear();
+                readUntil( "]]>", &m_text );
+                return T_TEXT;
+            }
+
+            skipDeclaration();
+            continue;
+        }
+
+        if( c == '/' )
+        {
+            get();
+            readName( m_name );
+            skipSpace();
+            expect( '>' );
+            return T_END;
+        }
+
+        readName( m_name );
+        m_attributes.clear();
+
+        for(;;)
+        {
+            skipSpace();
+            c = peek();
+
+            if( c == '>' )
+            {
+                get();
+                return T_START;
+            }
+
+            if( c == '/' )
+            {
+                get();
+                expect( '>' );
+                m_pendingEnd = true;
+                return T_START;
+            }
+
+            m_attributes.push_back( ATTRIBUTES::value_type() );
+            ATTRIBUTES::value_type& attr = m_attributes.back();
+
+            readName( attr.first );
+            skipSpace();
+            expect( '=' );
+            skipSpace();
+
+            int quote = get();
+
+            if( quote != '"' && quote != '\'' )
+                error( "expected ' or \"" );
+
+            m_raw.clear();
+
+            while( ( c = get() ) != quote )
+            {
+                if( c == EOF )
+                    error( "unexpected end of data" );
+
+                m_raw += (char) c;
+            }
+
+            decode( m_raw, attr.second );
+        }
+    }
+}
+
+
+bool XML_STREAM::NextChild()
+{
+    for(;;)
+    {
+        switch( next() )
+        {
+        case T_START:
+            ++m_depth;
+            return true;
+
+        case T_END:
+            if( m_depth == 0 )
+                error( "unexpected end tag" );
+
+            --m_depth;
+            return false;
+
+        case T_TEXT:
+            break;
+
+        case T_EOF:
+            if( m_depth )
+                error( "unexpected end of data" );
+
+            return false;
+        }
+    }
+}
+
+
+PTREE& XML_STREAM::ReadElement( PTREE& aParent )
+{
+    PTREE& elem = aParent.push_back( PTREE::value_type( m_name, PTREE() ) )->second;
+
+    if( m_attributes.size() )
+    {
+        PTREE& attrs = elem.push_back( PTREE::value_type( "<xmlattr>", PTREE() ) )->second;
+
+        for( ATTRIBUTES::const_iterator it = m_attributes.begin();  it != m_attributes.end();  ++it )
+            attrs.push_back( PTREE::value_type( it->first, PTREE( it->second ) ) );
+    }
+
+    std::string data;
+
+    for(;;)
+    {
+        switch( next() )
+        {
+        case T_START:
+            ++m_depth;
+            ReadElement( elem );
+            break;
+
+        case T_TEXT:
+            data += m_text;
+            break;
+
+        case T_END:
+            --m_depth;
+
+            if( data.size() )
+                elem.data() = data;
+
+            return elem;
+
+        case T_EOF:
+            error( "unexpected end of data" );
+        }
+    }
+}
+
+
+void XML_STREAM::SkipElement()
+{
+    int depth = m_depth;
+
+    while( m_depth >= depth )
+    {
+        switch( next() )
+        {
+        case T_START:
+            ++m_depth;
+            break;
+
+        case T_END:
+            --m_depth;
+            break;
+
+        case T_TEXT:
+            break;
+
+        case T_EOF:
+            error( "unexpected end of data" );
+        }
+    }
+}
@@ -35,6 +35,7 @@
 #include <listview_classes.h>
 #include <cvpcb_id.h>
 #include <eda_pattern_match.h>
+#include <eda_search_index.h>
 
 
 FOOTPRINTS_LISTBOX::FOOTPRINTS_LISTBOX( CVPCB_MAINFRAME* parent,
@@ -139,6 +140,22 @@ void FOOTPRINTS_LISTBOX::SetFootprints( FOOTPRINT_LIST& aList, const wxString& a
     if( GetSelection() >= 0 && GetSelection() < (int)m_footprintList.GetCount() )
         oldSelection = m_footprintList[ GetSelection() ];
 
+    // The index of the list gives the footprints whose name may match the pattern,
+    // the others need not be checked at all.
+    std::vector<unsigned>   nameCandidates;
+    std::vector<bool>       isNameCandidate;
+
+    if( (aFilterType & FILTERING_BY_NAME) && !aFootPrintFilterPattern.IsEmpty()
+        && aList.GetNameIndex().FindCandidates( aFootPrintFilterPattern.Lower(),
+                                                EDA_SEARCH_INDEX::MATCH_WILDCARD,
+                                                nameCandidates ) )
+    {
+        isNameCandidate.resize( aList.GetCount(), false );
+
+        for( unsigned ii : nameCandidates )
+            isNameCandidate[ii] = true;
+    }
+
     for( unsigned ii = 0; ii < aList.GetCount(); ii++ )
     {
         if( aFilterType == UNFILTERED_FP_LIST )
@@ -150,6 +167,9 @@ void FOOTPRINTS_LISTBOX::SetFootprints( FOOTPRINT_LIST& aList, const wxString& a
             continue;
         }
 
+        if( !isNameCandidate.empty() && !isNameCandidate[ii] )
+            continue;
+
         if( (aFilterType & FILTERING_BY_LIBRARY) && !aLibName.IsEmpty()
             && !aList.GetItem( ii ).InLibrary( aLibName ) )
             continue;
@@ -0,0 +1,49 @@
+'''
+    A python script example to render PNG previews of boards, without starting pcbnew:
+
+        python render_board_previews.py [--dpi 200] board1.kicad_pcb board2.kicad_pcb ...
+
+    Every board is rendered by a separate process, so the previews are generated in parallel.
+    The image of board.kicad_pcb is saved as board.png next to it.
+'''
+
+import sys
+import os
+from multiprocessing import Pool
+
+from pcbnew import *
+
+def render(args):
+    filename, dpi = args
+
+    board = LoadBoard(filename)
+
+    renderer = PCB_IMAGE_RENDERER(board)
+    renderer.SetDPI(dpi)
+
+    # Render only the area inside the board outline, if there is one
+    outline = board.ComputeBoundingBox(True)
+
+    if outline.GetWidth() > 0 and outline.GetHeight() > 0:
+        renderer.SetViewport(outline)
+
+    output = os.path.splitext(filename)[0] + ".png"
+
+    if not renderer.Render(output):
+        return "%s: rendering failed" % filename
+
+    size = renderer.GetImageSize()
+    return "%s: %dx%d pixels" % (output, size.x, size.y)
+
+if __name__ == '__main__':
+    args = sys.argv[1:]
+    dpi = 200.0
+
+    if len(args) > 1 and args[0] == "--dpi":
+        dpi = float(args[1])
+        args = args[2:]
+
+    pool = Pool()
+
+    for result in pool.imap(render, [(f, dpi) for f in args]):
+        print(result)
@@ -123,15 +123,19 @@ void SCH_EDIT_FRAME::AnnotateComponents( bool              aAnnotateSchematic,
     // example: IC1 become IC, and 1
     references.SplitReferences();
 
+    // When the previous annotation is kept, only the new references need to be sorted
+    // by position: the others just keep their numbers.
+    bool newOnly = !aResetAnnotation;
+
     switch( aSortOption )
     {
     default:
     case SORT_BY_X_POSITION:
-        references.SortByXCoordinate();
+        references.SortByXCoordinate( newOnly );
         break;
 
     case SORT_BY_Y_POSITION:
-        references.SortByYCoordinate();
+        references.SortByYCoordinate( newOnly );
         break;
     }
 
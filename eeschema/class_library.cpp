@@ -55,7 +55,8 @@
 PART_LIB::PART_LIB( int aType, const wxString& aFileName ) :
     // start @ != 0 so each additional library added
     // is immediately detectable, zero would not be.
-    m_mod_hash( PART_LIBS::s_modify_generation )
+    m_mod_hash( PART_LIBS::s_modify_generation ),
+    m_loader( NULL )
 {
     type = aType;
     isModified = false;
@@ -90,6 +91,51 @@ PART_LIB::~PART_LIB()
     }
 
     m_amap.clear();
+
+    if( m_loader )
+        SCH_IO_MGR::ReleasePlugin( m_loader );
+}
+
+
+LIB_ALIAS* PART_LIB::loadPendingAlias( const wxString& aName )
+{
+    if( !m_pending.erase( aName ) )
+        return NULL;
+
+    LIB_ALIAS* alias = NULL;
+
+    try
+    {
+        alias = m_loader->TransferSymbol( *this, aName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogError( ioe.What() );
+    }
+
+    // The other aliases of the part came along
+    if( alias )
+    {
+        LIB_PART* part = alias->GetPart();
+
+        for( size_t i = 0; i < part->GetAliasCount(); i++ )
+            m_pending.erase( part->GetAlias( i )->GetName() );
+    }
+
+    if( m_pending.empty() )
+    {
+        SCH_IO_MGR::ReleasePlugin( m_loader );
+        m_loader = NULL;
+    }
+
+    return alias;
+}
+
+
+void PART_LIB::loadPendingAliases()
+{
+    while( !m_pending.empty() )
+        loadPendingAlias( *m_pending.begin() );
 }
 
 
@@ -100,12 +146,18 @@ void PART_LIB::GetAliasNames( wxArrayString& aNames )
         aNames.Add( (*it).first );
     }
 
+    // The names are known without loading the parts
+    for( const wxString& name : m_pending )
+        aNames.Add( name );
+
     aNames.Sort();
 }
 
 
 void PART_LIB::GetEntryTypePowerNames( wxArrayString& aNames )
 {
+    loadPendingAliases();
+
     for( LIB_ALIAS_MAP::iterator it = m_amap.begin();  it!=m_amap.end();  it++ )
     {
         LIB_ALIAS* alias = it->second;
@@ -128,7 +180,7 @@ LIB_ALIAS* PART_LIB::FindAlias( const wxString& aName )
     if( it != m_amap.end() )
         return it->second;
 
-    return NULL;
+    return loadPendingAlias( aName );
 }
 
 
@@ -153,6 +205,8 @@ LIB_PART* PART_LIB::FindPart( const wxString& aName )
 
 bool PART_LIB::HasPowerParts()
 {
+    loadPendingAliases();
+
     // return true if at least one power part is found in lib
     for( LIB_ALIAS_MAP::iterator it = m_amap.begin();  it!=m_amap.end();  it++ )
     {
@@ -171,6 +225,8 @@ bool PART_LIB::AddAlias( LIB_ALIAS* aAlias )
 {
     wxASSERT( aAlias );
 
+    loadPendingAliases();
+
 #if defined(DEBUG) && 0
     if( !aAlias->GetName().Cmp( "TI_STELLARIS_BOOSTERPACK" ) )
     {
@@ -203,6 +259,8 @@ bool PART_LIB::AddAlias( LIB_ALIAS* aAlias )
 
 void PART_LIB::AddPart( LIB_PART* aPart )
 {
+    loadPendingAliases();
+
     // add a clone, not the caller's copy
     LIB_PART* my_part = new LIB_PART( *aPart );
 
@@ -225,6 +283,8 @@ LIB_ALIAS* PART_LIB::RemoveAlias( LIB_ALIAS* aEntry )
 {
     wxCHECK_MSG( aEntry != NULL, NULL, "NULL pointer cannot be removed from library." );
 
+    loadPendingAliases();
+
     LIB_ALIAS_MAP::iterator it = m_amap.find( aEntry->GetName() );
 
     if( it == m_amap.end() )
@@ -269,6 +329,8 @@ LIB_PART* PART_LIB::ReplacePart( LIB_PART* aOldPart, LIB_PART* aNewPart )
     wxASSERT( aOldPart != NULL );
     wxASSERT( aNewPart != NULL );
 
+    loadPendingAliases();
+
     /* Remove the old root component.  The component will automatically be deleted
      * when all it's aliases are deleted.  Do not place any code that accesses
      * aOldPart inside this loop that gets evaluated after the last alias is
@@ -567,6 +629,8 @@ bool PART_LIB::Save( OUTPUTFORMATTER& aFormatter )
         isModified = false;
     }
 
+    loadPendingAliases();
+
     bool success = true;
 
     try
@@ -596,6 +660,8 @@ bool PART_LIB::SaveDocs( OUTPUTFORMATTER& aFormatter )
 {
     bool success = true;
 
+    loadPendingAliases();
+
     try
     {
         aFormatter.Print( 0, "%s\n", DOCFILE_IDENT );
@@ -644,12 +710,26 @@ PART_LIB* PART_LIB::LoadLibrary( const wxString& aFileName ) throw( IO_ERROR, bo
     wxString errorMsg;
 
 #ifdef KICAD_USE_SCH_IO_MANAGER
-    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+    SCH_PLUGIN* pi = SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY );
+    wxArrayString names;
 
-    wxArrayString tmp;
+    try
+    {
+        pi->EnumerateSymbolLib( names, aFileName );
+    }
+    catch( ... )
+    {
+        SCH_IO_MGR::ReleasePlugin( pi );
+        throw;
+    }
 
-    pi->EnumerateSymbolLib( tmp, aFileName );
-    pi->TransferCache( *lib.get() );
+    // The plugin indexes the library, parts are parsed when they are looked up
+    lib->m_pending.insert( names.begin(), names.end() );
+
+    if( lib->m_pending.empty() )
+        SCH_IO_MGR::ReleasePlugin( pi );
+    else
+        lib->m_loader = pi;
 #else
     if( !lib->Load( errorMsg ) )
         THROW_IO_ERROR( errorMsg );
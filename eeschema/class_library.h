@@ -38,10 +38,12 @@
 #include <project.h>
 
 #include <map>
+#include <set>
 
 class LINE_READER;
 class OUTPUTFORMATTER;
 class SCH_LEGACY_PLUGIN;
+class SCH_PLUGIN;
 
 
 /*
@@ -334,6 +336,12 @@ class PART_LIB
     LIB_ALIAS_MAP   m_amap;         ///< Map of alias objects associated with the library.
     int             m_mod_hash;     ///< incremented each time library is changed.
 
+    /// Alias names of the parts not loaded yet, see LoadLibrary()
+    std::set< wxString >    m_pending;
+
+    /// Plugin loading the pending parts on demand, owned, NULL when nothing is pending
+    SCH_PLUGIN*     m_loader;
+
     friend class LIB_PART;
     friend class PART_LIBS;
     friend class SCH_LEGACY_PLUGIN;
@@ -376,6 +384,16 @@ private:
     bool LoadHeader( LINE_READER& aLineReader );
     void LoadAliases( LIB_PART* aPart );
 
+    /**
+     * Function loadPendingAlias
+     * takes the part having the alias \a aName over from m_loader.
+     * @return the alias, or NULL if it is not pending or cannot be loaded.
+     */
+    LIB_ALIAS* loadPendingAlias( const wxString& aName );
+
+    /// Takes all the pending parts over from m_loader, before m_amap is walked or changed
+    void loadPendingAliases();
+
 public:
     /**
      * Get library entry status.
@@ -384,7 +402,7 @@ public:
      */
     bool IsEmpty() const
     {
-        return m_amap.empty();
+        return m_amap.empty() && m_pending.empty();
     }
 
     /**
@@ -395,7 +413,7 @@ public:
      */
     int GetCount() const
     {
-        return m_amap.size();
+        return m_amap.size() + m_pending.size();
     }
 
     bool IsModified() const
@@ -530,6 +548,9 @@ public:
      * Function LoadLibrary
      * allocates and loads a part library file.
      *
+     * With KICAD_USE_SCH_IO_MANAGER, only the alias names are read and each part is
+     * parsed by the plugin when it is first looked up.
+     *
      * @param aFileName - File name of the part library to load.
      * @return PART_LIB* - the allocated and loaded PART_LIB, which is owned by
      *   the caller.
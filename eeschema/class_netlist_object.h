@@ -177,6 +177,8 @@ public:
      */
     bool HasNetNameCandidate() { return m_netNameCandidate != NULL; }
 
+    NETLIST_OBJECT* GetNetNameCandidate() const { return m_netNameCandidate; }
+
     /**
      * Function GetPinNum
      * returns a pin number in wxString form.  Pin numbers are not always
@@ -277,6 +279,38 @@ public:
 typedef std::vector<NETLIST_OBJECT*>    NETLIST_OBJECTS;
 
 
+/**
+ * Class NETCODE_UNION
+ * holds the net codes of the items of a NETLIST_OBJECT_LIST while their connections
+ * are searched.  Items sharing a net code are kept in a union-find set, so merging two
+ * nets costs almost nothing instead of a scan of the whole list.
+ */
+class NETCODE_UNION
+{
+public:
+    /// Forget all net codes, for a list of \a aItemCount items.
+    void Reset( unsigned aItemCount );
+
+    /// @return the net code of item \a aItem, 0 if it has none.
+    int Get( unsigned aItem );
+
+    /// Give net code \a aNetCode to item \a aItem, which leaves the net it was on if any.
+    void Set( unsigned aItem, int aNetCode );
+
+    /// Give net code \a aNewNetCode to all the items having net code \a aOldNetCode.
+    void Propagate( int aOldNetCode, int aNewNetCode );
+
+private:
+    int find( int aNode );
+
+    std::vector<int> m_itemNode;    // union-find node of each item, -1 if no net code
+    std::vector<int> m_parent;      // parent of each node, itself for a root node
+    std::vector<int> m_rank;        // rank of each root node
+    std::vector<int> m_netCode;     // net code of each root node
+    std::vector<int> m_codeRoot;    // root node of each net code, -1 if not used
+};
+
+
 /**
  * Class NETLIST_OBJECT_LIST
  * is a container holding and _owning_ NETLIST_OBJECTs, which are connected items
@@ -287,6 +321,7 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastNetCode;      // Used in intermediate calculation: last net code created
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
+    NETCODE_UNION m_nets;   // Used in intermediate calculation: net codes
 
 public:
     /**
@@ -304,6 +339,13 @@ public:
         m_lastBusNetCode = 0;
     }
 
+    /**
+     * Copy constructor.
+     * Makes a deep copy of the items of \a aSource, the net name candidates of the copied
+     * items are items of the new list.
+     */
+    NETLIST_OBJECT_LIST( const NETLIST_OBJECT_LIST& aSource );
+
     ~NETLIST_OBJECT_LIST();
 
     /**
@@ -381,23 +423,6 @@ public:
      */
     void SortListbySheet();
 
-    /**
-     * Counts number of pins connected on the same net.
-     * Used to count all pins connected to a no connect symbol
-     * @return the pin count of the net starting at aNetStart
-     * @param aNetStart = index in list of net objects of the first item
-     */
-    int CountPinsInNet( unsigned aNetStart );
-
-    /**
-     * Function TestforNonOrphanLabel
-     * Sheet labels are expected to be connected to a hierarchical label.
-     * Hierarchical labels are expected to be connected to a sheet label.
-     * Global labels are expected to be not orphan (connected to at least one other global label.
-     * this function tests the connection to an other suitable label
-     */
-    void TestforNonOrphanLabel( unsigned aNetItemRef, unsigned aStartNet );
-
     /**
      * Function TestforSimilarLabels
      * detects labels which are different when using case sensitive comparisons
@@ -425,14 +450,23 @@ private:
      * used to interconnect group of items already physically connected,
      * when a new connection is found between aOldNetCode and aNewNetCode
      */
-    void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
+    void propagateNetCode( int aOldNetCode, int aNewNetCode );
+
+    /*
+     * Find the connections made inside each sheet by wires, buses and junctions,
+     * and give the items their first net codes.
+     * The list is expected sorted by sheets.
+     */
+    void connectSheets();
 
     /*
      * This function merges the net codes of groups of objects already connected
      * to labels (wires, bus, pins ... ) when 2 labels are equivalents
      * (i.e. group objects connected by labels)
+     * aLabels holds the indices of all the label items having the same text
+     * as the label at index aLabelRef.
      */
-    void labelConnect( NETLIST_OBJECT* aLabelRef );
+    void labelConnect( unsigned aLabelRef, const std::vector<unsigned>& aLabels );
 
     /* Comparison function to sort by increasing Netcode the list of connected items
      */
@@ -451,20 +485,10 @@ private:
     /**
      * Propagate net codes from a parent sheet to an include sheet,
      * from a pin sheet connection
+     * aLabels holds the indices of all the label items having the same text
+     * as the sheet pin at index aSheetLabel.
      */
-    void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
-
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
-
-    /**
-     * Search connections between a junction and segments
-     * Propagate the junction net code to objects connected by this junction.
-     * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
-     */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
-
+    void sheetLabelConnect( unsigned aSheetLabel, const std::vector<unsigned>& aLabels );
 
     /**
      * Function connectBusLabels
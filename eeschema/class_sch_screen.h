@@ -49,6 +49,7 @@ class SCH_SHEET_PIN;
 class SCH_LINE;
 class SCH_TEXT;
 class PLOTTER;
+class SCH_POSITION_INDEX;
 
 
 enum SCH_LINE_TEST_T
@@ -85,6 +86,18 @@ private:
     int     m_modification_sync;        ///< inequality with PART_LIBS::GetModificationHash()
                                         ///< will trigger ResolveAll().
 
+    /// Index of the items and pin connection points by position, used by GetItem() and
+    /// GetPin().  Built on demand and rebuilt once the change stamp of the screen or the
+    /// libraries have changed.
+    mutable SCH_POSITION_INDEX* m_positionIndex;
+
+    /**
+     * Function getPositionIndex
+     * @return the position index, rebuilt first if it is out of date, or NULL when it cannot
+     *         be trusted because items are being moved in place by an edit in progress.
+     */
+    SCH_POSITION_INDEX* getPositionIndex() const;
+
     /**
      * Function addConnectedItemsToBlock
      * add items connected at \a aPosition to the block pick list.
@@ -141,6 +154,7 @@ public:
     {
         m_drawList.Append( aItem );
         --m_modification_sync;
+        UpdateChangeStamp();
     }
 
     /**
@@ -153,6 +167,7 @@ public:
     {
         m_drawList.Append( aList );
         --m_modification_sync;
+        UpdateChangeStamp();
     }
 
     /**
@@ -31,6 +31,9 @@
 
 #include <wx/regex.h>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 #include <fctsys.h>
@@ -40,9 +43,6 @@
 #include <sch_component.h>
 
 
-//#define USE_OLD_ALGO
-
-
 void SCH_REFERENCE_LIST::RemoveItem( unsigned int aIndex )
 {
     if( aIndex < componentFlatList.size() )
@@ -138,6 +138,18 @@ bool SCH_REFERENCE_LIST::sortByTimeStamp( const SCH_REFERENCE& item1,
     return ii < 0;
 }
 
+std::vector<SCH_REFERENCE>::iterator SCH_REFERENCE_LIST::partitionNew( bool aPartition )
+{
+    if( !aPartition )
+        return componentFlatList.begin();
+
+    return std::stable_partition( componentFlatList.begin(), componentFlatList.end(),
+                                  []( const SCH_REFERENCE& aRef )
+                                  {
+                                      return !aRef.m_IsNew && aRef.GetRefStr()[0] != '#';
+                                  } );
+}
+
 int SCH_REFERENCE_LIST::FindUnit( size_t aIndex, int aUnit )
 {
     int NumRef;
@@ -283,128 +295,183 @@ int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFi
 }
 
 
+/**
+ * Struct REF_PREFIX_INDEX
+ * holds what the annotation needs to know about the references sharing a prefix, so that
+ * it does not have to search the whole reference list again for each component.
+ */
+struct REF_PREFIX_INDEX
+{
+    /// The reference numbers in use.
+    std::set<int>                       idsInUse;
+
+    /// The first number worth testing, for each minimum reference number.
+    std::map<int, int>                  firstFreeIds;
+
+    /// The count of annotated references for each reference number and unit.
+    std::map<std::pair<int, int>, int>  annotatedUnits;
+
+    /// The indices of the references not annotated yet, for each value and part name.
+    std::map<std::pair<wxString, wxString>, std::set<unsigned> > newUnits;
+
+    /**
+     * Function CreateFirstFreeRefId
+     * returns the first reference number not in use from \a aMinRefId, and marks it used.
+     * Numbers are never released during an annotation, so the search for a given
+     * minimum number resumes where the previous one stopped.
+     */
+    int CreateFirstFreeRefId( int aMinRefId )
+    {
+        int  id = aMinRefId;
+        auto it = firstFreeIds.find( aMinRefId );
+
+        if( it != firstFreeIds.end() )
+            id = it->second;
+
+        while( idsInUse.count( id ) )
+            id++;
+
+        idsInUse.insert( id );
+        firstFreeIds[aMinRefId] = id + 1;
+
+        return id;
+    }
+};
+
+
 void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
       SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap )
 {
     if ( componentFlatList.size() == 0 )
         return;
 
-    int LastReferenceNumber = 0;
-    int NumberOfUnits, Unit;
-
     // Components with an invisible reference (power...) always are re-annotated.
     ResetHiddenReferences();
 
-    /* calculate index of the first component with the same reference prefix
-     * than the current component.  All components having the same reference
-     * prefix will receive a reference number with consecutive values:
-     * IC .. will be set to IC4, IC4, IC5 ...
+    /* Index the list in a single pass: the numbers and the units in use for each
+     * reference prefix, the references to annotate for each prefix, value and part name,
+     * and the position of each component instance.  The annotation below then never has
+     * to search the whole list.
      */
-    unsigned first = 0;
+    std::unordered_map<std::string, REF_PREFIX_INDEX> prefixes;
+    std::unordered_map<SCH_COMPONENT*, std::vector<unsigned> > instances;
+
+    for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
+    {
+        SCH_REFERENCE&    ref = componentFlatList[ii];
+        REF_PREFIX_INDEX& index = prefixes[ ref.GetRefStr() ];
+
+        if( ref.m_NumRef > 0 )
+            index.idsInUse.insert( ref.m_NumRef );
+
+        if( ref.m_IsNew )
+            index.newUnits[ std::make_pair( ref.m_Value->GetText(),
+                                            ref.m_RootCmp->GetPartName() ) ].insert( ii );
+        else
+            index.annotatedUnits[ std::make_pair( ref.m_NumRef, ref.m_Unit ) ]++;
+
+        instances[ ref.GetComp() ].push_back( ii );
+    }
 
-    // calculate the last used number for this reference prefix:
-#ifdef USE_OLD_ALGO
-    int minRefId = 0;
+    // The locked unit sets of each component, in the order of aLockedUnitMap.
+    std::unordered_map<SCH_COMPONENT*,
+                       std::vector< std::pair<SCH_REFERENCE*, SCH_REFERENCE_LIST*> > > lockedLists;
 
-    // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
-    if( aUseSheetNum )
-        minRefId = componentFlatList[first].m_SheetNum * aSheetIntervalId;
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+        {
+            SCH_REFERENCE& thisRef = pair.second[thisRefI];
 
-    LastReferenceNumber = GetLastReference( first, minRefId );
-#else
-    int minRefId = 1;
+            lockedLists[ thisRef.GetComp() ].push_back( std::make_pair( &thisRef, &pair.second ) );
+        }
+    }
+
+    // Helpers keeping the index up to date when a reference changes.
+    auto removeUnit = [&]( unsigned aIndex )
+    {
+        SCH_REFERENCE& ref = componentFlatList[aIndex];
 
-    // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
-    if( aUseSheetNum )
-        minRefId = componentFlatList[first].m_SheetNum * aSheetIntervalId + 1;
+        if( !ref.m_IsNew )
+            prefixes[ ref.GetRefStr() ].annotatedUnits[ std::make_pair( ref.m_NumRef,
+                                                                        ref.m_Unit ) ]--;
+    };
+
+    auto addUnit = [&]( unsigned aIndex )
+    {
+        SCH_REFERENCE& ref = componentFlatList[aIndex];
+
+        if( !ref.m_IsNew )
+            prefixes[ ref.GetRefStr() ].annotatedUnits[ std::make_pair( ref.m_NumRef,
+                                                                        ref.m_Unit ) ]++;
+    };
+
+    auto setFlag = [&]( unsigned aIndex )
+    {
+        SCH_REFERENCE& ref = componentFlatList[aIndex];
+
+        ref.m_Flag = 1;
+        prefixes[ ref.GetRefStr() ].newUnits[ std::make_pair( ref.m_Value->GetText(),
+                                              ref.m_RootCmp->GetPartName() ) ].erase( aIndex );
+    };
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
-#endif
     for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
     {
-        if( componentFlatList[ii].m_Flag )
+        SCH_REFERENCE& ref = componentFlatList[ii];
+
+        if( ref.m_Flag )
             continue;
 
+        REF_PREFIX_INDEX& index = prefixes[ ref.GetRefStr() ];
+
         // Check whether this component is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+        auto locked = lockedLists.find( ref.GetComp() );
+
+        if( locked != lockedLists.end() )
         {
-            unsigned n_refs = pair.second.GetCount();
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
+            for( auto& lockedRef : locked->second )
             {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
-
-                if( thisRef.IsSameInstance( componentFlatList[ii] ) )
+                if( lockedRef.first->IsSameInstance( ref ) )
                 {
-                    lockedList = &pair.second;
+                    lockedList = lockedRef.second;
                     break;
                 }
             }
-            if( lockedList != NULL ) break;
         }
 
-        if(  ( componentFlatList[first].CompareRef( componentFlatList[ii] ) != 0 )
-          || ( aUseSheetNum && ( componentFlatList[first].m_SheetNum != componentFlatList[ii].m_SheetNum ) )  )
-        {
-            // New reference found: we need a new ref number for this reference
-            first = ii;
-#ifdef USE_OLD_ALGO
-            minRefId = 0;
-
-            // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
-            if( aUseSheetNum )
-                minRefId = componentFlatList[ii].m_SheetNum * aSheetIntervalId;
-
-            LastReferenceNumber = componentFlatList.GetLastReference( ii, minRefId );
-#else
-            minRefId = 1;
+        int minRefId = 1;
 
-            // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
-            if( aUseSheetNum )
-                minRefId = componentFlatList[ii].m_SheetNum * aSheetIntervalId + 1;
-
-            GetRefsInUse( first, idList, minRefId );
-#endif
-        }
+        // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
+        if( aUseSheetNum )
+            minRefId = ref.m_SheetNum * aSheetIntervalId + 1;
 
         // Annotation of one part per package components (trivial case).
-        if( componentFlatList[ii].GetLibPart()->GetUnitCount() <= 1 )
+        if( ref.GetLibPart()->GetUnitCount() <= 1 )
         {
-            if( componentFlatList[ii].m_IsNew )
-            {
-#ifdef USE_OLD_ALGO
-                LastReferenceNumber++;
-#else
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
-#endif
-                componentFlatList[ii].m_NumRef = LastReferenceNumber;
-            }
+            removeUnit( ii );
 
-            componentFlatList[ii].m_Unit  = 1;
-            componentFlatList[ii].m_Flag  = 1;
-            componentFlatList[ii].m_IsNew = false;
+            if( ref.m_IsNew )
+                ref.m_NumRef = index.CreateFirstFreeRefId( minRefId );
+
+            ref.m_Unit  = 1;
+            ref.m_IsNew = false;
+            addUnit( ii );
+            setFlag( ii );
             continue;
         }
 
         // Annotation of multi-unit parts ( n units per part ) (complex case)
-        NumberOfUnits = componentFlatList[ii].GetLibPart()->GetUnitCount();
+        int numberOfUnits = ref.GetLibPart()->GetUnitCount();
 
-        if( componentFlatList[ii].m_IsNew )
+        if( ref.m_IsNew )
         {
-#ifdef USE_OLD_ALGO
-            LastReferenceNumber++;
-#else
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
-#endif
-            componentFlatList[ii].m_NumRef = LastReferenceNumber;
+            ref.m_NumRef = index.CreateFirstFreeRefId( minRefId );
 
-            if( !componentFlatList[ii].IsUnitsLocked() )
-                componentFlatList[ii].m_Unit = 1;
+            if( !ref.IsUnitsLocked() )
+                ref.m_Unit = 1;
 
-            componentFlatList[ii].m_Flag = 1;
+            setFlag( ii );
         }
 
         // If this component is in aLockedUnitMap, copy the annotation to all
@@ -412,26 +479,34 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
         if( lockedList != NULL )
         {
             unsigned n_refs = lockedList->GetCount();
+
             for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
             {
                 SCH_REFERENCE &thisRef = (*lockedList)[thisRefI];
-                if( thisRef.IsSameInstance( componentFlatList[ii] ) )
+
+                if( thisRef.IsSameInstance( ref ) )
                 {
                     // This is the component we're currently annotating. Hold the unit!
-                    componentFlatList[ii].m_Unit = thisRef.m_Unit;
+                    removeUnit( ii );
+                    ref.m_Unit = thisRef.m_Unit;
+                    addUnit( ii );
                 }
 
-                if( thisRef.CompareValue( componentFlatList[ii] ) != 0 ) continue;
-                if( thisRef.CompareLibName( componentFlatList[ii] ) != 0 ) continue;
+                if( thisRef.CompareValue( ref ) != 0 ) continue;
+                if( thisRef.CompareLibName( ref ) != 0 ) continue;
 
                 // Find the matching component
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
+                for( unsigned jj : instances[ thisRef.GetComp() ] )
                 {
-                    if( ! thisRef.IsSameInstance( componentFlatList[jj] ) ) continue;
-                    componentFlatList[jj].m_NumRef = componentFlatList[ii].m_NumRef;
+                    if( jj <= ii || !thisRef.IsSameInstance( componentFlatList[jj] ) )
+                        continue;
+
+                    removeUnit( jj );
+                    componentFlatList[jj].m_NumRef = ref.m_NumRef;
                     componentFlatList[jj].m_Unit = thisRef.m_Unit;
                     componentFlatList[jj].m_IsNew = false;
-                    componentFlatList[jj].m_Flag = 1;
+                    addUnit( jj );
+                    setFlag( jj );
                     break;
                 }
             }
@@ -443,42 +518,37 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             * we search for others parts that have the same value and the same
             * reference prefix (ref without ref number)
             */
-            for( Unit = 1; Unit <= NumberOfUnits; Unit++ )
+            auto candidates = index.newUnits.find( std::make_pair( ref.m_Value->GetText(),
+                                                                   ref.m_RootCmp->GetPartName() ) );
+
+            for( int unit = 1; unit <= numberOfUnits; unit++ )
             {
-                if( componentFlatList[ii].m_Unit == Unit )
+                if( ref.m_Unit == unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
+                auto annotated = index.annotatedUnits.find( std::make_pair( ref.m_NumRef, unit ) );
 
-                if( found >= 0 )
+                if( annotated != index.annotatedUnits.end() && annotated->second > 0 )
                     continue; // this unit exists for this reference (unit already annotated)
 
+                if( candidates == index.newUnits.end() )
+                    continue;
+
                 // Search a component to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
+                for( auto it = candidates->second.upper_bound( ii );
+                     it != candidates->second.end();  ++it )
                 {
-                    if( componentFlatList[jj].m_Flag )    // already tested
-                        continue;
-
-                    if( componentFlatList[ii].CompareRef( componentFlatList[jj] ) != 0 )
-                        continue;
-
-                    if( componentFlatList[jj].CompareValue( componentFlatList[ii] ) != 0 )
-                        continue;
-
-                    if( componentFlatList[jj].CompareLibName( componentFlatList[ii] ) != 0 )
-                        continue;
-
-                    if( !componentFlatList[jj].m_IsNew )
-                        continue;
+                    unsigned       jj = *it;
+                    SCH_REFERENCE& candidate = componentFlatList[jj];
 
                     // Component without reference number found, annotate it if possible
-                    if( !componentFlatList[jj].IsUnitsLocked()
-                        || ( componentFlatList[jj].m_Unit == Unit ) )
+                    if( !candidate.IsUnitsLocked() || ( candidate.m_Unit == unit ) )
                     {
-                        componentFlatList[jj].m_NumRef = componentFlatList[ii].m_NumRef;
-                        componentFlatList[jj].m_Unit   = Unit;
-                        componentFlatList[jj].m_Flag   = 1;
-                        componentFlatList[jj].m_IsNew  = false;
+                        candidate.m_NumRef = ref.m_NumRef;
+                        candidate.m_Unit   = unit;
+                        candidate.m_IsNew  = false;
+                        addUnit( jj );
+                        setFlag( jj );
                         break;
                     }
                 }
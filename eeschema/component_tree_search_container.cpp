@@ -24,6 +24,7 @@
 #include <component_tree_search_container.h>
 
 #include <algorithm>
+#include <iterator>
 #include <set>
 
 #include <wx/string.h>
@@ -35,6 +36,7 @@
 #include <macros.h>
 
 #include <eda_pattern_match.h>
+#include <eda_search_index.h>
 
 // Each node gets this lowest score initially, without any matches applied. Matches
 // will then increase this score depending on match quality.
@@ -61,7 +63,8 @@ struct COMPONENT_TREE_SEARCH_CONTAINER::TREE_NODE
           DisplayInfo( aDisplayInfo ),
           MatchName( aName.Lower() ),
           SearchText( aSearchText.Lower() ),
-          MatchScore( 0 ), PreviousScore( 0 )
+          MatchScore( 0 ), PreviousScore( 0 ),
+          IsCandidate( false )
     {
     }
 
@@ -78,6 +81,89 @@ struct COMPONENT_TREE_SEARCH_CONTAINER::TREE_NODE
     unsigned MatchScore;          ///< Result-Score after UpdateSearchTerm()
     unsigned PreviousScore;       ///< Optimization: used to see if we need any tree update.
     wxTreeItemId TreeId;          ///< Tree-ID if stored in the tree (if MatchScore > 0).
+    bool IsCandidate;             ///< Temporary: may match the term being scored.
+};
+
+
+// True if aTerm has none of the characters meaning something to the regex and wildcard
+// matchers. They then find it where the substring matcher does, so a component can only
+// match it if its texts contain it.
+static bool isPlainString( const wxString& aTerm )
+{
+    static const wxString special = wxT( ".[]()*+?{}|^$\\" );
+
+    for( wxUniChar c : aTerm )
+    {
+        if( special.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Struct SEARCH_INDEX
+ * indexes the name, keywords and description of the aliases, see EDA_SEARCH_INDEX.
+ */
+struct COMPONENT_TREE_SEARCH_CONTAINER::SEARCH_INDEX
+{
+    SEARCH_INDEX( const std::vector<TREE_NODE*>& aNodes ) :
+        Nodes( aNodes )
+    {
+    }
+
+    /**
+     * Function Build
+     * indexes Nodes.  Only reads their constant texts, so it can run on another thread
+     * than the search.
+     */
+    void Build()
+    {
+        for( unsigned ii = 0; ii < Nodes.size(); ++ii )
+        {
+            Index.AddText( ii, Nodes[ii]->MatchName );
+            Index.AddText( ii, Nodes[ii]->SearchText );
+        }
+    }
+
+    /**
+     * Function FindCandidates
+     * stores in \a aCandidates the nodes in which the combined matcher may find \a aTerm,
+     * that is the nodes where any of its matchers may find it.
+     * @return false if \a aTerm cannot be narrowed, all the nodes are candidates.
+     */
+    bool FindCandidates( const wxString& aTerm, std::vector<TREE_NODE*>& aCandidates ) const
+    {
+        static const EDA_SEARCH_INDEX::MATCH_TYPE types[] = {
+            EDA_SEARCH_INDEX::MATCH_SUBSTR,
+            EDA_SEARCH_INDEX::MATCH_WILDCARD,
+            EDA_SEARCH_INDEX::MATCH_REGEX
+        };
+
+        std::vector<unsigned> all, found, merged;
+
+        aCandidates.clear();
+
+        for( EDA_SEARCH_INDEX::MATCH_TYPE type : types )
+        {
+            if( !Index.FindCandidates( aTerm, type, found ) )
+                return false;
+
+            merged.clear();
+            std::set_union( all.begin(), all.end(), found.begin(), found.end(),
+                            std::back_inserter( merged ) );
+            all.swap( merged );
+        }
+
+        for( unsigned ii : all )
+            aCandidates.push_back( Nodes[ii] );
+
+        return true;
+    }
+
+    const std::vector<TREE_NODE*> Nodes;    ///< The alias nodes, when indexing started.
+    EDA_SEARCH_INDEX Index;                 ///< Items are indices in Nodes.
 };
 
 
@@ -105,13 +191,17 @@ COMPONENT_TREE_SEARCH_CONTAINER::COMPONENT_TREE_SEARCH_CONTAINER( PART_LIBS* aLi
       m_components_added( 0 ),
       m_preselect_unit_number( -1 ),
       m_libs( aLibs ),
-      m_filter( CMP_FILTER_NONE )
+      m_filter( CMP_FILTER_NONE ),
+      m_index( NULL ),
+      m_index_ready( false )
 {
 }
 
 
 COMPONENT_TREE_SEARCH_CONTAINER::~COMPONENT_TREE_SEARCH_CONTAINER()
 {
+    discardIndex();
+
     for( TREE_NODE* node : m_nodes )
         delete node;
 
@@ -130,10 +220,40 @@ void COMPONENT_TREE_SEARCH_CONTAINER::SetPreselectNode( const wxString& aCompone
 void COMPONENT_TREE_SEARCH_CONTAINER::SetTree( wxTreeCtrl* aTree )
 {
     m_tree = aTree;
+
+    if( m_tree )
+        startIndexing();
+
     UpdateSearchTerm( wxEmptyString );
 }
 
 
+void COMPONENT_TREE_SEARCH_CONTAINER::startIndexing()
+{
+    if( m_index || m_alias_nodes.empty() )
+        return;
+
+    m_index = new SEARCH_INDEX( m_alias_nodes );
+
+    m_index_thread = std::thread( [this]()
+                                  {
+                                      m_index->Build();
+                                      m_index_ready = true;
+                                  } );
+}
+
+
+void COMPONENT_TREE_SEARCH_CONTAINER::discardIndex()
+{
+    if( m_index_thread.joinable() )
+        m_index_thread.join();
+
+    delete m_index;
+    m_index = NULL;
+    m_index_ready = false;
+}
+
+
 void COMPONENT_TREE_SEARCH_CONTAINER::AddLibrary( PART_LIB& aLib )
 {
     wxArrayString all_aliases;
@@ -153,6 +273,9 @@ void COMPONENT_TREE_SEARCH_CONTAINER::AddAliasList( const wxString& aNodeName,
                                                     const wxArrayString& aAliasNameList,
                                                     PART_LIB* aOptionalLib )
 {
+    discardIndex();
+    m_last_search.Empty();
+
     TREE_NODE* const lib_node = new TREE_NODE( TREE_NODE::TYPE_LIB,  NULL, NULL,
                                                aNodeName, wxEmptyString, wxEmptyString );
     m_nodes.push_back( lib_node );
@@ -197,6 +320,7 @@ void COMPONENT_TREE_SEARCH_CONTAINER::AddAliasList( const wxString& aNodeName,
         TREE_NODE* alias_node = new TREE_NODE( TREE_NODE::TYPE_ALIAS, lib_node,
                                                a, a->GetName(), display_info, search_text );
         m_nodes.push_back( alias_node );
+        m_alias_nodes.push_back( alias_node );
 
         if( a->GetPart()->IsMulti() )    // Add all units as sub-nodes.
         {
@@ -330,17 +454,31 @@ void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch
     unsigned starttime =  GetRunningMicroSecs();
 #endif
 
-    // We score the list by going through it several time, essentially with a complexity
-    // of O(n). For the default library of 2000+ items, this typically takes less than 5ms
-    // on an i5. Good enough, no index needed.
+    // Only the aliases which can still match are scored.  When the search got longer,
+    // with plain strings, only the aliases which matched before can match: terms are
+    // ANDed and a longer term is only found where its beginning was.  And for each
+    // term, the search index gives the aliases which may contain it.
+    bool refine = !m_last_search.IsEmpty() && aSearch.StartsWith( m_last_search )
+                  && isPlainString( aSearch );
+
+    std::vector<TREE_NODE*> candidates;
+
+    for( TREE_NODE* node : m_alias_nodes )
+    {
+        if( !refine || node->MatchScore > 0 )
+            candidates.push_back( node );
+    }
 
     // Initial AND condition: Leaf nodes are considered to match initially.
     for( TREE_NODE* node : m_nodes )
     {
         node->PreviousScore = node->MatchScore;
-        node->MatchScore = ( node->Type == TREE_NODE::TYPE_LIB ) ? 0 : kLowestDefaultScore;
+        node->MatchScore = ( node->Type == TREE_NODE::TYPE_UNIT ) ? kLowestDefaultScore : 0;
     }
 
+    for( TREE_NODE* node : candidates )
+        node->MatchScore = kLowestDefaultScore;
+
     // Create match scores for each node for all the terms, that come space-separated.
     // Scoring adds up values for each term according to importance of the match. If a term does
     // not match at all, the result is thrown out of the results (AND semantics).
@@ -353,19 +491,42 @@ void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch
     //
     // This is of course subject to tweaking.
     wxStringTokenizer tokenizer( aSearch );
+    std::vector<TREE_NODE*> indexed;
+    std::vector<TREE_NODE*> matching_libs;
 
-    while ( tokenizer.HasMoreTokens() )
+    while ( tokenizer.HasMoreTokens() && !candidates.empty() )
     {
         const wxString term = tokenizer.GetNextToken().Lower();
         EDA_COMBINED_MATCHER matcher( term );
 
-        for( TREE_NODE* node : m_nodes )
+        // The aliases the index did not give can still match by their library name.
+        bool use_index = m_index_ready && m_index->FindCandidates( term, indexed );
+
+        if( use_index )
         {
-            if( node->Type != TREE_NODE::TYPE_ALIAS )
-                continue;      // Only aliases are actually scored here.
+            for( TREE_NODE* node : indexed )
+                node->IsCandidate = true;
 
-            if( node->MatchScore == 0)
-                continue;   // Leaf node without score are out of the game.
+            for( TREE_NODE* node : m_nodes )
+            {
+                int unused = 0;
+
+                if( node->Type == TREE_NODE::TYPE_LIB
+                    && matcher.Find( node->MatchName, &unused ) != EDA_PATTERN_NOT_FOUND )
+                {
+                    node->IsCandidate = true;
+                    matching_libs.push_back( node );
+                }
+            }
+        }
+
+        for( TREE_NODE* node : candidates )
+        {
+            if( use_index && !node->IsCandidate && !node->Parent->IsCandidate )
+            {
+                node->MatchScore = 0;   // Has none of the texts a matcher could find.
+                continue;
+            }
 
             // Keywords and description we only count if the match string is at
             // least two characters long. That avoids spurious, low quality
@@ -398,8 +559,26 @@ void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch
 
             node->MatchScore += 2 * matcher_fired;
         }
+
+        for( TREE_NODE* node : indexed )
+            node->IsCandidate = false;
+
+        for( TREE_NODE* node : matching_libs )
+            node->IsCandidate = false;
+
+        matching_libs.clear();
+
+        // Leaf nodes without score are out of the game.
+        candidates.erase( std::remove_if( candidates.begin(), candidates.end(),
+                                          []( const TREE_NODE* node )
+                                          {
+                                              return node->MatchScore == 0;
+                                          } ),
+                          candidates.end() );
     }
 
+    m_last_search = aSearch;
+
     // Library nodes have the maximum score seen in any of their children.
     // Alias nodes have the score of their parents.
     unsigned highest_score_seen = 0;
@@ -24,6 +24,8 @@
 #ifndef COMPONENT_TREE_SEARCH_CONTAINER_H
 #define COMPONENT_TREE_SEARCH_CONTAINER_H
 
+#include <atomic>
+#include <thread>
 #include <vector>
 #include <wx/string.h>
 
@@ -95,6 +97,9 @@ public:
      * scoring component at the top and selected. If a preselect node is set, this
      * is displayed. Does not take ownership of the tree.
      *
+     * This ends the setup phase: the search index of the components is built in the
+     * background from here, searches scan all the components until it is ready.
+     *
      * @param aTree that is to be modified on search updates.
      */
     void SetTree( wxTreeCtrl* aTree );
@@ -127,9 +132,23 @@ public:
 
 private:
     struct TREE_NODE;
+    struct SEARCH_INDEX;
     static bool scoreComparator( const TREE_NODE* a1, const TREE_NODE* a2 );
 
+    /// Starts building m_index in the background, if not done yet.
+    void startIndexing();
+
+    /// Waits for the background indexing and forgets the index, the components changed.
+    void discardIndex();
+
     std::vector<TREE_NODE*> m_nodes;
+    std::vector<TREE_NODE*> m_alias_nodes;  ///< The alias nodes of m_nodes, in added order.
+
+    SEARCH_INDEX*       m_index;            ///< Built by m_index_thread, NULL before.
+    std::thread         m_index_thread;
+    std::atomic<bool>   m_index_ready;      ///< m_index can be used by the search.
+
+    wxString m_last_search;                 ///< The search giving the current scores.
     wxTreeCtrl* m_tree;
     int m_libraries_added;
     int m_components_added;
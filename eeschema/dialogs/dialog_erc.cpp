@@ -495,34 +495,29 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
     // Reset the connection type indicator
     objectsConnectedList->ResetConnectionsType();
 
-    unsigned lastItemIdx;
-    unsigned nextItemIdx = lastItemIdx = 0;
+    ERC_NET_SUMMARY net( objectsConnectedList.get() );
     int MinConn    = NOC;
 
     /* The netlist generated by SCH_EDIT_FRAME::BuildNetListBase is sorted
      * by net number, which means we can group netlist items into ranges
-     * that live in the same net. The range from nextItem to the current
-     * item (exclusive) needs to be checked against the current item. The
-     * lastItem variable is used as a helper to pass the last item's number
-     * from one loop iteration to the next, which simplifies the initial
-     * pass.
+     * that live in the same net. When a new net starts, its items are
+     * gathered once in the net summary, which is then used to check each
+     * item of the net against the others.
      */
 
     for( unsigned itemIdx = 0; itemIdx < objectsConnectedList->size(); itemIdx++ )
     {
         auto item = objectsConnectedList->GetItem( itemIdx );
-        auto lastItem = objectsConnectedList->GetItem( lastItemIdx );
 
-        auto lastNet = lastItem->GetNet();
-        auto net = item->GetNet();
-
-        wxASSERT_MSG( lastNet <= net, wxT( "Netlist not correctly ordered" ) );
-
-        if( lastNet != net )
+        if( itemIdx == 0 || itemIdx == net.GetNetEnd() )
         {
+            wxASSERT_MSG( itemIdx == 0 ||
+                          objectsConnectedList->GetItemNet( itemIdx - 1 ) <= item->GetNet(),
+                          wxT( "Netlist not correctly ordered" ) );
+
             // New net found:
-            MinConn      = NOC;
-            nextItemIdx = itemIdx;
+            MinConn = NOC;
+            net.Build( itemIdx );
         }
 
         switch( item->m_Type )
@@ -545,11 +540,12 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
             // ERC problems when pin sheets do not match hierarchical labels.
             // Each pin sheet must match a hierarchical label
             // Each hierarchical label must match a pin sheet
-            objectsConnectedList->TestforNonOrphanLabel( itemIdx, nextItemIdx );
+            if( !net.IsLabelConnected( itemIdx ) )
+                Diagnose( item, NULL, -1, WAR );
             break;
         case NET_GLOBLABEL:
-            if( m_tstUniqueGlobalLabels )
-                objectsConnectedList->TestforNonOrphanLabel( itemIdx, nextItemIdx );
+            if( m_tstUniqueGlobalLabels && !net.IsLabelConnected( itemIdx ) )
+                Diagnose( item, NULL, -1, WAR );
             break;
 
         case NET_NOCONNECT:
@@ -557,7 +553,7 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
             // ERC problems when a noconnect symbol is connected to more than one pin.
             MinConn = NET_NC;
 
-            if( objectsConnectedList->CountPinsInNet( nextItemIdx ) > 1 )
+            if( net.GetPinCount() > 1 )
                 Diagnose( item, NULL, MinConn, UNC );
 
             break;
@@ -565,11 +561,9 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
         case NET_PIN:
 
             // Look for ERC problems between pins:
-            TestOthersItems( objectsConnectedList.get(), itemIdx, nextItemIdx, &MinConn );
+            TestOthersItems( objectsConnectedList.get(), net, itemIdx, &MinConn );
             break;
         }
-
-        lastItemIdx = itemIdx;
     }
 
     // Test similar labels (i;e. labels which are identical when
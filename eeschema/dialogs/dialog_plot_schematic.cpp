@@ -28,6 +28,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
 #include <fctsys.h>
 #include <pgm_base.h>
 #include <kiface_i.h>
@@ -353,3 +358,140 @@ wxFileName DIALOG_PLOT_SCHEMATIC::createPlotFileName( wxTextCtrl* aOutputDirecto
     fn.SetPath( outputDir.GetFullPath() );
     return fn;
 }
+
+
+std::vector<DIALOG_PLOT_SCHEMATIC::PLOT_SHEET> DIALOG_PLOT_SCHEMATIC::buildPlotSheets( bool aPlotAll )
+{
+    SCH_SHEET_PATH          oldsheetpath = m_parent->GetCurrentSheet();
+    SCH_SHEET_LIST          sheetList;
+    std::vector<PLOT_SHEET> sheets;
+
+    if( aPlotAll )
+        sheetList.BuildSheetList( g_RootSheet );
+    else
+        sheetList.push_back( m_parent->GetCurrentSheet() );
+
+    for( unsigned i = 0; i < sheetList.size(); i++ )
+    {
+        m_parent->SetCurrentSheet( sheetList[i] );
+        m_parent->SetSheetNumberAndCount();
+
+        PLOT_SHEET sheet;
+
+        sheet.m_SheetPath   = sheetList[i];
+        sheet.m_Screen      = sheetList[i].LastScreen();
+        sheet.m_FileName    = m_parent->GetUniqueFilenameForCurrentSheet();
+        sheet.m_SheetDesc   = m_parent->GetScreenDesc();
+        sheet.m_SheetNumber = sheet.m_Screen->m_ScreenNumber;
+        sheet.m_SheetCount  = sheet.m_Screen->m_NumberOfScreens;
+        sheet.m_Success     = false;
+
+        sheets.push_back( sheet );
+    }
+
+    m_parent->SetCurrentSheet( oldsheetpath );
+    m_parent->SetSheetNumberAndCount();
+
+    return sheets;
+}
+
+
+void DIALOG_PLOT_SCHEMATIC::plotSheets( std::vector<PLOT_SHEET>& aSheets,
+                                        const std::function<void( PLOT_SHEET& )>& aPlotSheet )
+{
+    SCH_SHEET_PATH  oldsheetpath = m_parent->GetCurrentSheet();
+
+    /* In complex hierarchies a SCH_SCREEN is shared between many sheets, and its
+     * component references depend on the sheet path, so the sheets sharing a screen
+     * are dispatched to successive rounds.  The sheets of a round are plotted together.
+     */
+    std::vector< std::vector<PLOT_SHEET*> > rounds;
+    std::map<SCH_SCREEN*, unsigned>         screenUseCount;
+
+    for( PLOT_SHEET& sheet : aSheets )
+    {
+        unsigned round = screenUseCount[ sheet.m_Screen ]++;
+
+        if( round >= rounds.size() )
+            rounds.resize( round + 1 );
+
+        rounds[round].push_back( &sheet );
+    }
+
+    LOCALE_IO toggle;       // Switch the locale to standard C, for all the threads
+
+    for( std::vector<PLOT_SHEET*>& round : rounds )
+    {
+        for( PLOT_SHEET* sheet : round )
+        {
+            sheet->m_SheetPath.UpdateAllScreenReferences();
+
+            // Link the components to their library parts now: plotting only reads them.
+            sheet->m_Screen->CheckComponentsToPartsLinks();
+        }
+
+        std::atomic<unsigned>   nextJob( 0 );
+
+        auto worker = [&]()
+        {
+            for( unsigned job = nextJob++;  job < round.size();  job = nextJob++ )
+            {
+                PLOT_SHEET* sheet = round[job];
+
+                try
+                {
+                    aPlotSheet( *sheet );
+                }
+                catch( const IO_ERROR& e )
+                {
+                    sheet->m_Success = false;
+                    sheet->m_Message = e.What();
+                }
+                catch( const std::exception& e )
+                {
+                    // Would terminate the program if it left the thread
+                    sheet->m_Success = false;
+                    sheet->m_Message = FROM_UTF8( e.what() );
+                }
+            }
+        };
+
+        unsigned threadCount = std::min< unsigned >( std::thread::hardware_concurrency(),
+                                                     round.size() );
+        std::vector< std::thread > threads;
+
+        for( unsigned ii = 1; ii < threadCount; ii++ )
+            threads.push_back( std::thread( worker ) );
+
+        worker();   // this thread is one of the workers
+
+        for( unsigned ii = 0; ii < threads.size(); ii++ )
+            threads[ii].join();
+    }
+
+    m_parent->SetCurrentSheet( oldsheetpath );
+    m_parent->GetCurrentSheet().UpdateAllScreenReferences();
+    m_parent->SetSheetNumberAndCount();
+}
+
+
+void DIALOG_PLOT_SCHEMATIC::plotSheetContent( PLOTTER* aPlotter, const PLOT_SHEET& aSheet,
+                                              bool aPlotFrameRef )
+{
+    if( aPlotFrameRef )
+    {
+        // The page layout items keep the state of the frame being built, so frames are
+        // built one at a time.
+        static std::mutex frameMutex;
+        std::lock_guard<std::mutex> lock( frameMutex );
+
+        aPlotter->SetColor( BLACK );
+        PlotWorkSheet( aPlotter, aSheet.m_Screen->GetTitleBlock(),
+                       aSheet.m_Screen->GetPageSettings(),
+                       aSheet.m_SheetNumber, aSheet.m_SheetCount,
+                       aSheet.m_SheetDesc,
+                       aSheet.m_Screen->GetFileName() );
+    }
+
+    aSheet.m_Screen->Plot( aPlotter );
+}
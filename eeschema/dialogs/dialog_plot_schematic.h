@@ -28,6 +28,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <functional>
+#include <vector>
+
 #include <fctsys.h>
 #include <plot_common.h>
 #include <class_sch_screen.h>
@@ -91,18 +94,55 @@ private:
 
     void PlotSchematic( bool aPlotAll );
 
+    /**
+     * Struct PLOT_SHEET
+     * holds what is needed to plot a sheet once it is no longer the current sheet, so
+     * that the sheets can be plotted on several threads.
+     */
+    struct PLOT_SHEET
+    {
+        SCH_SHEET_PATH  m_SheetPath;
+        SCH_SCREEN*     m_Screen;
+        wxString        m_FileName;     ///< Unique file name of the sheet, without extension
+        wxString        m_SheetDesc;    ///< Sheet path displayed in the title block
+        int             m_SheetNumber;
+        int             m_SheetCount;
+        wxFileName      m_PlotFileName; ///< The file to create
+        bool            m_Success;
+        wxString        m_Message;      ///< The plotter exception, if any
+        std::string     m_PdfPage;      ///< The compressed page content, for PDF
+    };
+
+    /**
+     * Function buildPlotSheets
+     * @return the sheets to plot: all the sheets if \a aPlotAll is true, otherwise the
+     *         current sheet.
+     */
+    std::vector<PLOT_SHEET> buildPlotSheets( bool aPlotAll );
+
+    /**
+     * Function plotSheets
+     * calls \a aPlotSheet for each sheet of \a aSheets, on as many threads as there are
+     * cores.  The sheets using the same screen (complex hierarchies) are plotted one after
+     * the other, each one after updating the component references for its sheet path.
+     * The current sheet is restored afterwards.
+     * @param aSheets the sheets to plot, from buildPlotSheets().
+     * @param aPlotSheet the function plotting a sheet.  It must only use the given sheet,
+     *                   an IO_ERROR it throws is stored in the sheet message.
+     */
+    void plotSheets( std::vector<PLOT_SHEET>& aSheets,
+                     const std::function<void( PLOT_SHEET& )>& aPlotSheet );
+
+    /**
+     * Function plotSheetContent
+     * plots the frame reference, when \a aPlotFrameRef is true, and the items of a sheet.
+     */
+    void plotSheetContent( PLOTTER* aPlotter, const PLOT_SHEET& aSheet, bool aPlotFrameRef );
+
     // PDF
     void    createPDFFile( bool aPlotAll, bool aPlotFrameRef );
-    void    plotOneSheetPDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen, bool aPlotFrameRef);
     void    setupPlotPagePDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen );
 
-    /**
-    * Everything done, close the plot and restore the environment
-    * @param aPlotter the plotter to close and destroy
-    * @param aOldsheetpath the stored old sheet path for the current sheet before the plot started
-    */
-    void    restoreEnvironment( PDF_PLOTTER* aPlotter, SCH_SHEET_PATH& aOldsheetpath );
-
     // DXF
     void    CreateDXFFile( bool aPlotAll, bool aPlotFrameRef );
     bool    PlotOneSheetDXF( const wxString& aFileName, SCH_SCREEN* aScreen,
@@ -127,12 +167,14 @@ private:
 
     // PS
     void    createPSFile( bool aPlotAll, bool aPlotFrameRef );
-    bool    plotOneSheetPS( const wxString& aFileName, SCH_SCREEN* aScreen,
-                            const PAGE_INFO& aPageInfo,
-                            wxPoint aPlot0ffset, double aScale, bool aPlotFrameRef );
+    bool    plotOneSheetPS( const PLOT_SHEET& aSheet, const PAGE_INFO& aPageInfo,
+                            wxPoint aPlot0ffset, double aScale, bool aPlotColor,
+                            bool aPlotFrameRef );
 
     // SVG
     void    createSVGFile( bool aPlotAll, bool aPlotFrameRef );
+    bool    plotOneSheetSVG( const PLOT_SHEET& aSheet, bool aPlotBlackAndWhite,
+                             bool aPlotFrameRef );
 
     /**
      * Create a file name with an absolute path name
@@ -147,11 +189,4 @@ private:
     wxFileName createPlotFileName( wxTextCtrl* aOutputDirectoryName,
                                    wxString& aPlotFileName,
                                    wxString& aExtension, REPORTER* aReporter = NULL );
-
-public:
-    // This function is static because it is called by libedit
-    // outside a dialog. This is the reason we need aFrame as parameter
-    static bool plotOneSheetSVG( EDA_DRAW_FRAME* aFrame, const wxString& aFileName,
-                                 SCH_SCREEN* aScreen,
-                                 bool aPlotBlackAndWhite, bool aPlotFrameRef );
 };
@@ -49,6 +49,7 @@
 
 #include <kiway.h>
 #include <sim/sim_plot_frame.h>
+#include <sch_headless_export.h>
 
 // The main sheet of the project
 SCH_SHEET*  g_RootSheet = NULL;
@@ -130,7 +131,14 @@ static struct IFACE : public KIFACE_I
      */
     void* IfaceOrAddress( int aDataId ) override
     {
-        return NULL;
+        switch( aDataId )
+        {
+        case KIFACE_ADDR_SCH_HEADLESS_EXPORT:
+            return (void*) &SchHeadlessExport;
+
+        default:
+            return NULL;
+        }
     }
 
 } kiface( "eeschema", KIWAY::FACE_SCH );
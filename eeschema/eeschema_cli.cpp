@@ -0,0 +1,397 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file eeschema_cli.cpp
+ * @brief Command line netlist and BOM exporter, running the eeschema KIFACE without
+ * creating any window.
+ *
+ * A single schematic is exported in this process.  With several schematics, this
+ * process runs a copy of itself for each of them, up to --jobs at once: the loaded
+ * hierarchy and the project are global to a process, not to a thread.
+ */
+
+#include <fctsys.h>
+#include <wx/cmdline.h>
+#include <wx/stdpaths.h>
+#include <wx/process.h>
+
+#include <kiway.h>
+#include <pgm_base.h>
+#include <reporter.h>
+#include <profile.h>
+
+#include <netlist.h>
+#include <sch_headless_export.h>
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <vector>
+
+
+// A single KIWAY, the eeschema KIFACE is the only one loaded.
+KIWAY    Kiway( &Pgm(), KFCTL_STANDALONE );
+
+
+static const wxCmdLineEntryDesc cmdLineDesc[] =
+    {
+        { wxCMD_LINE_PARAM, NULL, NULL, _( "schematic_filename" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_MANDATORY | wxCMD_LINE_PARAM_MULTIPLE },
+        { wxCMD_LINE_OPTION, "f", "format",
+            _( "pcbnew (default), orcadpcb2, cadstar, spice or generic" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+        { wxCMD_LINE_OPTION, "o", "output-filename",
+            _( "output filename, only for a single schematic" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+        { wxCMD_LINE_OPTION, "p", "plugin",
+            _( "command turning the generic netlist into the output file, "
+               "e.g. a BOM plugin" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+        { wxCMD_LINE_OPTION, "j", "jobs",
+            _( "number of schematics exported at once (default: one per core)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+        { wxCMD_LINE_SWITCH, "h", NULL, _( "display this message" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+        { wxCMD_LINE_NONE }
+    };
+
+
+/**
+ * Struct PGM_SCH_CLI
+ * implements PGM_BASE for the command line exporter.
+ */
+static struct PGM_SCH_CLI : public PGM_BASE
+{
+    PGM_SCH_CLI() :
+        m_jobs( 0 ),
+        m_running( 0 ),
+        m_failures( 0 ),
+        m_count( 0 )
+    {
+    }
+
+    bool OnPgmInit();
+
+    void OnPgmExit()
+    {
+        Kiway.OnKiwayEnd();
+
+        // Destroy everything in PGM_BASE earlier than wxApp and earlier than static
+        // destruction would.
+        PGM_BASE::Destroy();
+    }
+
+    void MacOpenFile( const wxString& aFileName )   override
+    {
+    }
+
+    /**
+     * Function ExportOne
+     * exports \a aJob in this process through the eeschema KIFACE.
+     * @return int - the exit code of the process.
+     */
+    int ExportOne( SCH_HEADLESS_EXPORT_JOB& aJob );
+
+    /**
+     * Function StartChildren
+     * runs this program on the pending schematics until m_jobs of them are running.
+     */
+    void StartChildren();
+
+    /**
+     * Function OnChildEnd
+     * reports the end of the export of \a aSchematic and starts the next ones.
+     */
+    void OnChildEnd( const wxString& aSchematic, int aStatus, double aElapsed );
+
+    wxString                m_format;
+    wxString                m_outputFile;
+    wxString                m_pluginCommand;
+    long                    m_jobs;             ///< child processes running at once
+
+    std::deque<wxString>    m_pending;          ///< schematics not yet started
+    int                     m_running;          ///< child processes still running
+    int                     m_failures;
+    int                     m_count;            ///< all the schematics given
+    PROF_COUNTER            m_timer;
+
+} program;
+
+
+PGM_BASE& Pgm()
+{
+    return program;
+}
+
+
+/**
+ * Class SCH_CLI_PROCESS
+ * is the child process exporting one schematic.
+ */
+class SCH_CLI_PROCESS : public wxProcess
+{
+public:
+    SCH_CLI_PROCESS( const wxString& aSchematic ) :
+        wxProcess(),
+        m_schematic( aSchematic )
+    {
+    }
+
+    void OnTerminate( int aPid, int aStatus ) override
+    {
+        program.OnChildEnd( m_schematic, aStatus, m_timer.msecs() );
+        delete this;
+    }
+
+private:
+    wxString        m_schematic;
+    PROF_COUNTER    m_timer;
+};
+
+
+static int formatFromName( const wxString& aName )
+{
+    if( aName.IsEmpty() || aName == wxT( "pcbnew" ) )
+        return NET_TYPE_PCBNEW;
+    else if( aName == wxT( "orcadpcb2" ) )
+        return NET_TYPE_ORCADPCB2;
+    else if( aName == wxT( "cadstar" ) )
+        return NET_TYPE_CADSTAR;
+    else if( aName == wxT( "spice" ) )
+        return NET_TYPE_SPICE;
+    else if( aName == wxT( "generic" ) )
+        return NET_TYPE_CUSTOM1;
+    else
+        return NET_TYPE_UNINIT;
+}
+
+
+/**
+ * Struct APP_SCH_CLI
+ * is the wxApp of the command line exporter.  It never shows a window, it is a wxApp
+ * and not a wxAppConsole because the KIFACE needs the toolkit.
+ */
+struct APP_SCH_CLI : public wxApp
+{
+    bool OnInit() override
+    {
+        if( !wxApp::OnInit() )          // parses the command line
+            return false;
+
+        try
+        {
+            return program.OnPgmInit();
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxLogError( GetChars( ioe.What() ) );
+        }
+
+        program.OnPgmExit();
+
+        return false;
+    }
+
+    void OnInitCmdLine( wxCmdLineParser& parser ) override
+    {
+        parser.SetDesc( cmdLineDesc );
+        parser.SetSwitchChars( "-" );
+    }
+
+    bool OnCmdLineParsed( wxCmdLineParser& parser ) override
+    {
+        parser.Found( "f", &program.m_format );
+        parser.Found( "o", &program.m_outputFile );
+        parser.Found( "p", &program.m_pluginCommand );
+        parser.Found( "j", &program.m_jobs );
+
+        for( size_t ii = 0; ii < parser.GetParamCount(); ii++ )
+            program.m_pending.push_back( parser.GetParam( ii ) );
+
+        program.m_count = program.m_pending.size();
+
+        if( formatFromName( program.m_format ) == NET_TYPE_UNINIT
+            || ( program.m_count > 1 && !program.m_outputFile.IsEmpty() ) )
+        {
+            parser.Usage();
+            return false;
+        }
+
+        return true;
+    }
+
+    int OnRun() override
+    {
+        int ret = 1;
+
+        try
+        {
+            if( program.m_count == 1 )
+            {
+                SCH_HEADLESS_EXPORT_JOB job;
+
+                job.m_SchematicFile = program.m_pending.front();
+                job.m_OutputFile = program.m_outputFile;
+                job.m_Format = formatFromName( program.m_format );
+                job.m_PluginCommand = program.m_pluginCommand;
+
+                ret = program.ExportOne( job );
+            }
+            else
+            {
+                if( program.m_jobs <= 0 )
+                    program.m_jobs = std::max( 1u, std::thread::hardware_concurrency() );
+
+                program.StartChildren();
+
+                // The children report their end through the event loop.
+                if( program.m_running )
+                    wxApp::OnRun();
+
+                wxPrintf( _( "%d of %d schematics exported in %.1f ms\n" ),
+                          program.m_count - program.m_failures, program.m_count,
+                          program.m_timer.msecs() );
+
+                ret = program.m_failures ? 1 : 0;
+            }
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxLogError( GetChars( ioe.What() ) );
+        }
+
+        program.OnPgmExit();
+
+        return ret;
+    }
+};
+
+IMPLEMENT_APP( APP_SCH_CLI );
+
+
+bool PGM_SCH_CLI::OnPgmInit()
+{
+    // Several copies run at once when exporting several schematics.
+    if( !InitPgm( false ) )
+        return false;
+
+    m_timer.Start();
+
+    return true;
+}
+
+
+int PGM_SCH_CLI::ExportOne( SCH_HEADLESS_EXPORT_JOB& aJob )
+{
+    STDIO_REPORTER  reporter;
+    KIFACE*         kiface = Kiway.KiFACE( KIWAY::FACE_SCH );
+
+    if( !kiface )
+        return 1;
+
+    SCH_HEADLESS_EXPORT_FUNC* exportFunc = (SCH_HEADLESS_EXPORT_FUNC*)
+            kiface->IfaceOrAddress( KIFACE_ADDR_SCH_HEADLESS_EXPORT );
+
+    wxCHECK_MSG( exportFunc, 1, wxT( "The eeschema KIFACE has no headless export." ) );
+
+    if( !exportFunc( &Kiway, aJob, reporter ) )
+        return 1;
+
+    reporter.Report( wxString::Format( _( "%s: load %.1f ms, connectivity %.1f ms, "
+                                          "export %.1f ms\n" ),
+                                       GetChars( aJob.m_SchematicFile ),
+                                       aJob.m_LoadTime, aJob.m_ConnectivityTime,
+                                       aJob.m_ExportTime ),
+                     REPORTER::RPT_INFO );
+    return 0;
+}
+
+
+void PGM_SCH_CLI::StartChildren()
+{
+    while( m_running < m_jobs && !m_pending.empty() )
+    {
+        wxString schematic = m_pending.front();
+        m_pending.pop_front();
+
+        // Give the child the same options, but a single schematic.
+        std::vector<wxString> args;
+
+        args.push_back( wxStandardPaths::Get().GetExecutablePath() );
+
+        if( !m_format.IsEmpty() )
+        {
+            args.push_back( wxT( "--format" ) );
+            args.push_back( m_format );
+        }
+
+        if( !m_pluginCommand.IsEmpty() )
+        {
+            args.push_back( wxT( "--plugin" ) );
+            args.push_back( m_pluginCommand );
+        }
+
+        args.push_back( schematic );
+
+        std::vector<const wchar_t*> argv;
+
+        for( const wxString& arg : args )
+            argv.push_back( arg.wc_str() );
+
+        argv.push_back( NULL );
+
+        SCH_CLI_PROCESS* process = new SCH_CLI_PROCESS( schematic );
+
+        if( wxExecute( const_cast<wchar_t**>( argv.data() ), wxEXEC_ASYNC, process ) <= 0 )
+        {
+            delete process;
+            m_failures++;
+            wxFprintf( stderr, _( "%s: cannot start the export\n" ), GetChars( schematic ) );
+            continue;
+        }
+
+        m_running++;
+    }
+}
+
+
+void PGM_SCH_CLI::OnChildEnd( const wxString& aSchematic, int aStatus, double aElapsed )
+{
+    m_running--;
+
+    if( aStatus != 0 )
+    {
+        m_failures++;
+        wxFprintf( stderr, _( "%s: export failed\n" ), GetChars( aSchematic ) );
+    }
+    else
+    {
+        wxPrintf( _( "%s: done in %.1f ms\n" ), GetChars( aSchematic ), aElapsed );
+    }
+
+    StartChildren();
+
+    if( !m_running )
+        App().ExitMainLoop();
+}
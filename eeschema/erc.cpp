@@ -42,6 +42,11 @@
 #include <sch_sheet.h>
 
 #include <wx/ffile.h>
+#include <wx/hashmap.h>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 
 /* ERC tests :
@@ -369,159 +374,231 @@ void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst,
 }
 
 
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                      unsigned aNetItemRef, unsigned aNetStart,
-                      int* aMinConnexion )
+ERC_NET_SUMMARY::ERC_NET_SUMMARY( NETLIST_OBJECT_LIST* aList ) :
+    m_list( aList ),
+    m_netStart( 0 ),
+    m_netEnd( 0 ),
+    m_pinCount( 0 ),
+    m_hasNoConnect( false )
 {
-    unsigned netItemTst = aNetStart;
-    ELECTRICAL_PINTYPE jj;
-    int erc = OK;
+}
 
-    /* Analysis of the table of connections. */
-    ELECTRICAL_PINTYPE ref_elect_type = aList->GetItem( aNetItemRef )->m_ElectricalPinType;
-    int local_minconn = NOC;
 
-    if( ref_elect_type == PIN_NC )
-        local_minconn = NPI;
+void ERC_NET_SUMMARY::Build( unsigned aNetStart )
+{
+    int net = m_list->GetItemNet( aNetStart );
 
-    /* Test pins connected to NetItemRef */
-    for( ; ; netItemTst++ )
-    {
-        if( aNetItemRef == netItemTst )
-            continue;
+    m_netStart = aNetStart;
+    m_pinCount = 0;
+    m_hasNoConnect = false;
+    m_hierLabelPaths.clear();
+    m_sheetLabelPaths.clear();
+    m_globalLabelCount.clear();
 
-        // We examine only a given net. We stop the search if the net changes
-        if( ( netItemTst >= aList->size() ) // End of list
-            || ( aList->GetItemNet( aNetItemRef ) !=
-                 aList->GetItemNet( netItemTst ) ) ) // End of net
-        {
-            /* End net code found: minimum connection test. */
-            if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
-            {
-                /* Not connected or not driven pin. */
-                bool seterr = true;
+    for( int ii = 0; ii < PINTYPE_COUNT; ii++ )
+        m_pinTypeCount[ii] = 0;
 
-                if( local_minconn == NOC &&
-                    aList->GetItemType( aNetItemRef ) == NET_PIN )
-                {
-                    /* This pin is not connected: for multiple part per
-                     * package, and duplicated pin,
-                     * search for an other instance of this pin
-                     * this will be flagged only if all instances of this pin
-                     * are not connected
-                     * TODO test also if instances connected are connected to
-                     * the same net
-                     */
-                    for( unsigned duplicate = 0; duplicate < aList->size(); duplicate++ )
-                    {
-                        if( aList->GetItemType( duplicate ) != NET_PIN )
-                            continue;
-
-                        if( duplicate == aNetItemRef )
-                            continue;
-
-                        if( aList->GetItem( aNetItemRef )->m_PinNum !=
-                            aList->GetItem( duplicate )->m_PinNum )
-                            continue;
-
-                        if( ( (SCH_COMPONENT*) aList->GetItem( aNetItemRef )->
-                             m_Link )->GetRef( &aList->GetItem( aNetItemRef )-> m_SheetPath ) !=
-                            ( (SCH_COMPONENT*) aList->GetItem( duplicate )->m_Link )
-                           ->GetRef( &aList->GetItem( duplicate )->m_SheetPath ) )
-                            continue;
-
-                        // Same component and same pin. Do dot create error for this pin
-                        // if the other pin is connected (i.e. if duplicate net has an other
-                        // item)
-                        if( (duplicate > 0)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate - 1 ) ) )
-                            seterr = false;
-
-                        if( (duplicate < aList->size() - 1)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate + 1 ) ) )
-                            seterr = false;
-                    }
-                }
-
-                if( seterr )
-                    Diagnose( aList->GetItem( aNetItemRef ), NULL, local_minconn, WAR );
+    for( m_netEnd = aNetStart; m_netEnd < m_list->size(); m_netEnd++ )
+    {
+        NETLIST_OBJECT* item = m_list->GetItem( m_netEnd );
 
-                *aMinConnexion = DRV;   // inhibiting other messages of this
-                                       // type for the net.
-            }
-            return;
-        }
+        if( item->GetNet() != net )
+            break;
 
-        switch( aList->GetItemType( netItemTst ) )
+        switch( item->m_Type )
         {
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
+        case NET_PIN:
+            m_pinCount++;
+            m_pinTypeCount[ item->m_ElectricalPinType ]++;
+            break;
+
+        case NET_NOCONNECT:
+            m_hasNoConnect = true;
+            break;
+
         case NET_HIERLABEL:
-        case NET_BUSLABELMEMBER:
         case NET_HIERBUSLABELMEMBER:
-        case NET_SHEETBUSLABELMEMBER:
+            m_hierLabelPaths.insert( item->m_SheetPath );
+            break;
+
         case NET_SHEETLABEL:
+        case NET_SHEETBUSLABELMEMBER:
+            m_sheetLabelPaths.insert( item->m_SheetPathInclude );
+            break;
+
         case NET_GLOBLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-        case NET_PINLABEL:
+            m_globalLabelCount[ item->m_Label ]++;
             break;
 
-        case NET_NOCONNECT:
-            local_minconn = std::max( NET_NC, local_minconn );
+        default:
             break;
+        }
+    }
 
-        case NET_PIN:
-            jj = aList->GetItem( netItemTst )->m_ElectricalPinType;
+    // Search backward the first conflicting pin after each pin: nextPin[type] is the
+    // first pin of this type after the current item.
+    int nextPin[PINTYPE_COUNT];
+
+    for( int ii = 0; ii < PINTYPE_COUNT; ii++ )
+        nextPin[ii] = -1;
+
+    m_firstConflict.assign( m_netEnd - m_netStart, -1 );
+
+    for( unsigned item = m_netEnd; item-- > m_netStart; )
+    {
+        if( m_list->GetItemType( item ) != NET_PIN )
+            continue;
+
+        ELECTRICAL_PINTYPE ref_elect_type = m_list->GetItem( item )->m_ElectricalPinType;
+        int conflict = -1;
+
+        for( int jj = 0; jj < PINTYPE_COUNT; jj++ )
+        {
+            if( nextPin[jj] < 0 || DiagErc[ref_elect_type][jj] == OK )
+                continue;
+
+            if( conflict < 0 || nextPin[jj] < conflict )
+                conflict = nextPin[jj];
+        }
+
+        m_firstConflict[item - m_netStart] = conflict;
+        nextPin[ref_elect_type] = item;
+    }
+}
+
+
+int ERC_NET_SUMMARY::GetMinimalConnection( unsigned aPin ) const
+{
+    ELECTRICAL_PINTYPE ref_elect_type = m_list->GetItem( aPin )->m_ElectricalPinType;
+    int local_minconn = NOC;
+
+    if( ref_elect_type == PIN_NC )
+        local_minconn = NPI;
+
+    if( m_hasNoConnect )
+        local_minconn = std::max( NET_NC, local_minconn );
+
+    for( int jj = 0; jj < PINTYPE_COUNT; jj++ )
+    {
+        // The pin itself is not one of the other pins.
+        int count = m_pinTypeCount[jj] - ( jj == ref_elect_type ? 1 : 0 );
+
+        if( count > 0 )
             local_minconn = std::max( MinimalReq[ref_elect_type][jj], local_minconn );
+    }
 
-            if( netItemTst <= aNetItemRef )
-                break;
+    return local_minconn;
+}
 
-            if( erc == OK )
-            {
-                erc = DiagErc[ref_elect_type][jj];
 
-                if( erc != OK )
-                {
-                    if( aList->GetConnectionType( netItemTst ) == UNCONNECTED )
-                    {
-                        Diagnose( aList->GetItem( aNetItemRef ),
-                                  aList->GetItem( netItemTst ),
-                                  0, erc );
-                        aList->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
-                    }
-                }
-            }
+bool ERC_NET_SUMMARY::IsLabelConnected( unsigned aLabel ) const
+{
+    NETLIST_OBJECT* label = m_list->GetItem( aLabel );
 
-            break;
+    switch( label->m_Type )
+    {
+    case NET_HIERLABEL:
+    case NET_HIERBUSLABELMEMBER:
+        return m_sheetLabelPaths.count( label->m_SheetPath ) > 0;
+
+    case NET_SHEETLABEL:
+    case NET_SHEETBUSLABELMEMBER:
+        return m_hierLabelPaths.count( label->m_SheetPathInclude ) > 0;
+
+    case NET_GLOBLABEL:
+    {
+        // The label itself is counted.
+        auto it = m_globalLabelCount.find( label->m_Label );
+        return it != m_globalLabelCount.end() && it->second > 1;
+    }
+
+    default:
+        return false;
+    }
+}
+
+
+ERC_NET_SUMMARY::PIN_KEY ERC_NET_SUMMARY::pinKey( unsigned aPin ) const
+{
+    NETLIST_OBJECT* pin = m_list->GetItem( aPin );
+    SCH_COMPONENT*  component = (SCH_COMPONENT*) pin->m_Link;
+
+    return PIN_KEY( component->GetRef( &pin->m_SheetPath ), pin->m_PinNum );
+}
+
+
+bool ERC_NET_SUMMARY::IsPinConnectedElsewhere( unsigned aPin )
+{
+    if( m_pinInstances.empty() )
+    {
+        for( unsigned item = 0; item < m_list->size(); item++ )
+        {
+            if( m_list->GetItemType( item ) == NET_PIN )
+                m_pinInstances[ pinKey( item ) ].push_back( item );
         }
     }
+
+    for( unsigned duplicate : m_pinInstances[ pinKey( aPin ) ] )
+    {
+        if( duplicate == aPin )
+            continue;
+
+        // Same component and same pin: the other pin is connected if its net has an other
+        // item.
+        if( duplicate > 0
+          && m_list->GetItemNet( duplicate ) == m_list->GetItemNet( duplicate - 1 ) )
+            return true;
+
+        if( duplicate < m_list->size() - 1
+          && m_list->GetItemNet( duplicate ) == m_list->GetItemNet( duplicate + 1 ) )
+            return true;
+    }
+
+    return false;
 }
 
-int NETLIST_OBJECT_LIST::CountPinsInNet( unsigned aNetStart )
+
+void TestOthersItems( NETLIST_OBJECT_LIST* aList, ERC_NET_SUMMARY& aNet,
+                      unsigned aNetItemRef, int* aMinConnexion )
 {
-    int count = 0;
-    int curr_net = GetItemNet( aNetStart );
+    NETLIST_OBJECT* ref = aList->GetItem( aNetItemRef );
 
-    /* Test pins connected to NetItemRef */
-    for( unsigned item = aNetStart; item < size(); item++ )
+    // Only the first pin in conflict with NetItemRef is reported, and only once.
+    int netItemTst = aNet.GetFirstConflict( aNetItemRef );
+
+    if( netItemTst >= 0 && aList->GetConnectionType( netItemTst ) == UNCONNECTED )
     {
-        // We examine only a given net. We stop the search if the net changes
-        if( curr_net != GetItemNet( item ) )   // End of net
-            break;
+        ELECTRICAL_PINTYPE jj = aList->GetItem( netItemTst )->m_ElectricalPinType;
 
-        if( GetItemType( item ) == NET_PIN )
-            count++;
+        Diagnose( ref, aList->GetItem( netItemTst ), 0, DiagErc[ref->m_ElectricalPinType][jj] );
+        aList->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
     }
 
-    return count;
+    // Minimum connection test.
+    int local_minconn = aNet.GetMinimalConnection( aNetItemRef );
+
+    if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
+    {
+        /* Not connected or not driven pin. */
+        bool seterr = true;
+
+        /* This pin is not connected: for multiple part per package, and duplicated pin,
+         * search for an other instance of this pin this will be flagged only if all
+         * instances of this pin are not connected
+         * TODO test also if instances connected are connected to the same net
+         */
+        if( local_minconn == NOC && aNet.IsPinConnectedElsewhere( aNetItemRef ) )
+            seterr = false;
+
+        if( seterr )
+            Diagnose( ref, NULL, local_minconn, WAR );
+
+        *aMinConnexion = DRV;   // inhibiting other messages of this
+                                // type for the net.
+    }
 }
 
+
 bool WriteDiagnosticERC( const wxString& aFullFileName )
 {
     wxString    msg;
@@ -581,77 +658,24 @@ bool WriteDiagnosticERC( const wxString& aFullFileName )
 }
 
 
-void NETLIST_OBJECT_LIST::TestforNonOrphanLabel( unsigned aNetItemRef, unsigned aStartNet )
-{
-    unsigned netItemTst = aStartNet;
-    int      erc = 1;
-
-    // Review the list of labels connected to NetItemRef:
-    for( ; ; netItemTst++ )
-    {
-        if( netItemTst == aNetItemRef )
-            continue;
-
-        /* Is always in the same net? */
-        if( ( netItemTst == size() )
-          || ( GetItemNet( aNetItemRef ) != GetItemNet( netItemTst ) ) )
-        {
-            /* End Netcode found. */
-            if( erc )
-            {
-                /* Glabel or SheetLabel orphaned. */
-                Diagnose( GetItem( aNetItemRef ), NULL, -1, WAR );
-            }
-
-            return;
-        }
-
-        if( GetItem( aNetItemRef )->IsLabelConnected( GetItem( netItemTst ) ) )
-            erc = 0;
-
-        //same thing, different order.
-        if( GetItem( netItemTst )->IsLabelConnected( GetItem( aNetItemRef ) ) )
-            erc = 0;
-    }
-}
-
-
 // this code try to detect similar labels, i.e. labels which are identical
 // when they are compared using case insensitive coparisons.
+// Labels are grouped in hash tables by their text and by their case folded text,
+// so only the labels of a group are compared.
 
+typedef std::unordered_map<wxString, int, wxStringHash, wxStringEqual> LABEL_COUNT_MAP;
 
-// A helper struct to compare NETLIST_OBJECT items by sheetpath and label texts
-// for a std::set<NETLIST_OBJECT*> container
-// the full text is "sheetpath+label" for local labels and "label" for global labels
-struct compare_labels
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        wxString str1 = lab1->m_SheetPath.Path() + lab1->m_Label;
-        wxString str2 = lab2->m_SheetPath.Path() + lab2->m_Label;
-
-        return str1.Cmp( str2 ) < 0;
-    }
-};
-
-struct compare_label_names
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        return lab1->m_Label.Cmp( lab2->m_Label ) < 0;
-    }
-};
-
-struct compare_paths
+// The labels of a sheet path: the first label found for each text (used to build diag
+// messages) and the count of labels having this text.
+struct SHEET_LABELS
 {
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        return lab1->m_SheetPath.Path().Cmp( lab2->m_SheetPath.Path() ) < 0;
-    }
+    std::unordered_map<wxString, NETLIST_OBJECT*, wxStringHash, wxStringEqual> m_first;
+    LABEL_COUNT_MAP m_count;
 };
 
 // Helper functions to build the warning messages about Similar Labels:
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel );
+static void similarLabelsTest( std::vector<NETLIST_OBJECT*>& aLabels, bool aLocalOnly,
+                               const std::function<int( NETLIST_OBJECT* )>& aCount );
 static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
 
 
@@ -660,13 +684,15 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     // Similar labels which are different when using case sensitive comparisons
     // but are equal when using case insensitive comparisons
 
-    // list of all labels (used the better item to build diag messages)
-    std::vector<NETLIST_OBJECT*> fullLabelList;
-    // list of all labels , each label appears only once (used to to detect similar labels)
-    std::set<NETLIST_OBJECT*, compare_labels> uniqueLabelList;
-    wxString msg;
+    // labels of each sheet path, by path
+    std::map<wxString, SHEET_LABELS> sheetLabels;
+    // the global label used for each global label text, and its sheet path
+    std::unordered_map<wxString, std::pair<NETLIST_OBJECT*, wxString>,
+                       wxStringHash, wxStringEqual> globalLabels;
+    // count of global labels in the full project, by text
+    LABEL_COUNT_MAP globalCount;
 
-    // Build a list of differents labels. If inside a given sheet there are
+    // Build the lists of differents labels. If inside a given sheet there are
     // more than one given label, only one label is stored.
     // not also the sheet labels are not taken in account for 2 reasons:
     //  * they are in the root sheet but they are seen only from the child sheet
@@ -674,7 +700,9 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     //    already detected by ERC
     for( unsigned netItem = 0; netItem < size(); ++netItem )
     {
-        switch( GetItemType( netItem ) )
+        NETLIST_OBJECT* label = GetItem( netItem );
+
+        switch( label->m_Type )
         {
         case NET_LABEL:
         case NET_BUSLABELMEMBER:
@@ -683,10 +711,28 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         case NET_HIERLABEL:
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBLABEL:
-            // add this label in lists
-            uniqueLabelList.insert( GetItem( netItem ) );
-            fullLabelList.push_back( GetItem( netItem ) );
+        {
+            wxString      path = label->m_SheetPath.Path();
+            SHEET_LABELS& sheet = sheetLabels[path];
+
+            if( sheet.m_count[label->m_Label]++ == 0 )
+                sheet.m_first[label->m_Label] = label;
+
+            if( label->IsLabelGlobal() )
+            {
+                auto it = globalLabels.find( label->m_Label );
+
+                // For global labels, use a label of the first sheet path.
+                if( it == globalLabels.end() )
+                    globalLabels[label->m_Label] = std::make_pair( label, path );
+                else if( path.Cmp( it->second.second ) < 0 )
+                    it->second = std::make_pair( label, path );
+
+                globalCount[label->m_Label]++;
+            }
+
             break;
+        }
 
         case NET_SHEETLABEL:
         case NET_SHEETBUSLABELMEMBER:
@@ -695,118 +741,87 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         }
     }
 
-    // build global labels and compare
-    std::set<NETLIST_OBJECT*, compare_label_names> loc_labelList;
-    std::set<NETLIST_OBJECT*>::const_iterator it;
-
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-    {
-        if( (*it)->IsLabelGlobal() )
-            loc_labelList.insert( *it );
-    }
+    // Count the number of labels identical to a label:
+    //  for global label: global labels in the full project
+    //  for local label: all labels in the current sheet
+    const SHEET_LABELS* currentSheet = NULL;
 
-    // compare global labels (same label names appears only once in list)
-    for( it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
+    auto countIdenticalLabels = [&]( NETLIST_OBJECT* aLabel ) -> int
     {
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = it;
+        if( aLabel->IsLabelGlobal() )
+            return globalCount[aLabel->m_Label];
 
-        for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-        {
-            if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-            {
-                // Create new marker for ERC.
-                int cntA = countIndenticalLabels( fullLabelList, *it );
-                int cntB = countIndenticalLabels( fullLabelList, *it_aux );
+        return currentSheet->m_count.at( aLabel->m_Label );
+    };
 
-                if( cntA <= cntB )
-                    SimilarLabelsDiagnose( (*it), (*it_aux) );
-                else
-                    SimilarLabelsDiagnose( (*it_aux), (*it) );
-            }
-        }
-    }
+    // compare global labels (same label names appears only once in list)
+    std::vector<NETLIST_OBJECT*> labels;
 
-    // Build paths list
-    std::set<NETLIST_OBJECT*, compare_paths> pathsList;
+    for( const auto& global : globalLabels )
+        labels.push_back( global.second.first );
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-        pathsList.insert( *it );
+    similarLabelsTest( labels, false, countIdenticalLabels );
 
     // Examine each label inside a sheet path:
-    for( it = pathsList.begin(); it != pathsList.end(); ++it )
+    for( const auto& sheet : sheetLabels )
     {
-        loc_labelList.clear();
-
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = uniqueLabelList.begin();
-
-        for( ; it_aux != uniqueLabelList.end(); ++it_aux )
-        {
-            if( (*it)->m_SheetPath.Path() == (*it_aux)->m_SheetPath.Path() )
-                loc_labelList.insert( *it_aux );
-        }
-
-        // at this point, loc_labelList contains labels of the current sheet path.
-        // Detect similar labels (same label names appears only once in list)
-        std::set<NETLIST_OBJECT*>::const_iterator ref_it;
-
-        for( ref_it = loc_labelList.begin(); ref_it != loc_labelList.end(); ++ref_it )
-        {
-            NETLIST_OBJECT* ref_item = *ref_it;
-            it_aux = ref_it;
+        currentSheet = &sheet.second;
+        labels.clear();
 
-            for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-            {
-                // global label versus global label was already examined.
-                // here, at least one label must be local
-                if( ref_item->IsLabelGlobal() && (*it_aux)->IsLabelGlobal() )
-                    continue;
+        for( const auto& first : sheet.second.m_first )
+            labels.push_back( first.second );
 
-                if( ref_item->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-                {
-                    // Create new marker for ERC.
-                    int cntA = countIndenticalLabels( fullLabelList, ref_item );
-                    int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                    if( cntA <= cntB )
-                        SimilarLabelsDiagnose( ref_item, (*it_aux) );
-                    else
-                        SimilarLabelsDiagnose( (*it_aux), ref_item );
-                }
-            }
-        }
+        // global label versus global label was already examined.
+        // here, at least one label must be local
+        similarLabelsTest( labels, true, countIdenticalLabels );
     }
 }
 
-// Helper function: count the number of labels identical to aLabel
-//  for global label: global labels in the full project
-//  for local label: all labels in the current sheet
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel )
+
+// Helper function: creates a marker for each pair of labels of aLabels (which all have
+// different texts) having the same case folded text.
+static void similarLabelsTest( std::vector<NETLIST_OBJECT*>& aLabels, bool aLocalOnly,
+                               const std::function<int( NETLIST_OBJECT* )>& aCount )
 {
-    int count = 0;
+    // Sort the labels, so the markers are always created in the same order.
+    std::sort( aLabels.begin(), aLabels.end(),
+               []( const NETLIST_OBJECT* aLabelA, const NETLIST_OBJECT* aLabelB )
+               {
+                   return aLabelA->m_Label.Cmp( aLabelB->m_Label ) < 0;
+               } );
 
-    if( aLabel->IsLabelGlobal() )
-    {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
+    std::unordered_map<wxString, std::vector<NETLIST_OBJECT*>,
+                       wxStringHash, wxStringEqual> similarLabels;
 
-            if( item->IsLabelGlobal() && item->m_Label == aLabel->m_Label )
-                count++;
-        }
-    }
-    else
+    for( NETLIST_OBJECT* label : aLabels )
+        similarLabels[label->m_Label.Lower()].push_back( label );
+
+    for( NETLIST_OBJECT* label : aLabels )
     {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
+        std::vector<NETLIST_OBJECT*>& group = similarLabels[label->m_Label.Lower()];
+
+        // Each group is tested once, when its first label is found.
+        if( group.size() < 2 || group[0] != label )
+            continue;
+
+        for( unsigned ii = 0; ii < group.size(); ii++ )
         {
-            NETLIST_OBJECT* item = aList[netItem];
+            for( unsigned jj = ii + 1; jj < group.size(); jj++ )
+            {
+                if( aLocalOnly && group[ii]->IsLabelGlobal() && group[jj]->IsLabelGlobal() )
+                    continue;
 
-            if( item->m_Label == aLabel->m_Label &&
-                item->m_SheetPath.Path() == aLabel->m_SheetPath.Path() )
-                count++;
+                // Create new marker for ERC.
+                int cntA = aCount( group[ii] );
+                int cntB = aCount( group[jj] );
+
+                if( cntA <= cntB )
+                    SimilarLabelsDiagnose( group[ii], group[jj] );
+                else
+                    SimilarLabelsDiagnose( group[jj], group[ii] );
+            }
         }
     }
-
-    return count;
 }
 
 // Helper function: creates a marker for similar labels ERC warning
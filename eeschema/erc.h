@@ -30,10 +30,17 @@
 #ifndef _ERC_H
 #define _ERC_H
 
+#include <map>
+#include <set>
+#include <vector>
+
+#include <pin_type.h>
+
 
 //class EDA_DRAW_PANEL;
 class NETLIST_OBJECT;
 class NETLIST_OBJECT_LIST;
+class SCH_SHEET;
 
 /* For ERC markers: error types (used in diags, and to set the color):
 */
@@ -85,18 +92,95 @@ bool WriteDiagnosticERC( const wxString& aFullFileName );
 void Diagnose( NETLIST_OBJECT* NetItemRef, NETLIST_OBJECT* NetItemTst,
                       int MinConnexion, int Diag );
 
+/**
+ * Class ERC_NET_SUMMARY
+ * gathers in a single pass over a net what the ERC tests of its items need to know about
+ * the other items of the net: the pins of each electrical type, the no connect symbols and
+ * the hierarchical and global labels.  So the test of an item does not scan the net again,
+ * and the ERC time grows linearly with the size of the nets.
+ */
+class ERC_NET_SUMMARY
+{
+public:
+    /**
+     * Constructor
+     * @param aList = the list of connected objects, sorted by net code
+     */
+    ERC_NET_SUMMARY( NETLIST_OBJECT_LIST* aList );
+
+    /**
+     * Function Build
+     * gathers the data of the net which starts at \a aNetStart.
+     */
+    void Build( unsigned aNetStart );
+
+    /// @return the index in list after the last item of the net.
+    unsigned GetNetEnd() const { return m_netEnd; }
+
+    /// @return the number of pins in the net.
+    int GetPinCount() const { return m_pinCount; }
+
+    /**
+     * Function GetMinimalConnection
+     * @return the minimal connection (NOC, NOD, DRV, NET_NC or NPI) that the other items
+     *         of the net give to the pin \a aPin.
+     */
+    int GetMinimalConnection( unsigned aPin ) const;
+
+    /**
+     * Function GetFirstConflict
+     * @return the index of the first pin after \a aPin in the net whose electrical type
+     *         is in conflict with the one of \a aPin in the ERC matrix, or -1.
+     */
+    int GetFirstConflict( unsigned aPin ) const { return m_firstConflict[aPin - m_netStart]; }
+
+    /**
+     * Function IsLabelConnected
+     * @return true if the hierarchical, sheet or global label \a aLabel is connected to an
+     *         other suitable label of the net (see NETLIST_OBJECT::IsLabelConnected()).
+     */
+    bool IsLabelConnected( unsigned aLabel ) const;
+
+    /**
+     * Function IsPinConnectedElsewhere
+     * @return true if an other instance of the pin \a aPin (same pin number and same
+     *         component reference, in an other unit) is connected to something.
+     */
+    bool IsPinConnectedElsewhere( unsigned aPin );
+
+private:
+    typedef std::vector<SCH_SHEET*> SHEETS;
+    typedef std::pair<wxString, long> PIN_KEY;      ///< Component reference and pin number
+
+    NETLIST_OBJECT_LIST*    m_list;
+    unsigned                m_netStart;
+    unsigned                m_netEnd;
+    int                     m_pinCount;
+    int                     m_pinTypeCount[PINTYPE_COUNT];
+    bool                    m_hasNoConnect;
+    std::vector<int>        m_firstConflict;        ///< Indexed by item index - m_netStart
+    std::set<SHEETS>        m_hierLabelPaths;       ///< Sheet paths of the hierarchical labels
+    std::set<SHEETS>        m_sheetLabelPaths;      ///< Sheet paths included by the sheet pins
+    std::map<wxString, int> m_globalLabelCount;     ///< Global label count, by label text
+
+    /// All the pins of the list, by component and pin number, built when first needed.
+    std::map< PIN_KEY, std::vector<unsigned> > m_pinInstances;
+
+    PIN_KEY pinKey( unsigned aPin ) const;
+};
+
+
 /**
  * Perform ERC testing for electrical conflicts between \a NetItemRef and other items
  * (mainly pin) on the same net.
  * @param aList = a reference to the list of connected objects
+ * @param aNet = the summary of the net of \a aNetItemRef
  * @param aNetItemRef = index in list of the current object
- * @param aNetStart = index in list of net objects of the first item
  * @param aMinConnexion = a pointer to a variable to store the minimal connection
  * found( NOD, DRV, NPI, NET_NC)
  */
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                             unsigned aNetItemRef, unsigned aNetStart,
-                             int* aMinConnexion );
+void TestOthersItems( NETLIST_OBJECT_LIST* aList, ERC_NET_SUMMARY& aNet,
+                      unsigned aNetItemRef, int* aMinConnexion );
 
 /**
  * Function TestDuplicateSheetNames( )
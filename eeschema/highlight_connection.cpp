@@ -51,8 +51,8 @@ bool SCH_EDIT_FRAME::HighlightConnectionAtPosition( wxPoint aPosition )
             wxMessageBox( _( "Error: duplicate sub-sheet names found in current sheet. Fix it" ) );
         else
         {
-            // Build netlist info to get the proper netnames of connected items
-            std::unique_ptr<NETLIST_OBJECT_LIST> objectsConnectedList( BuildNetListBase() );
+            // Use the schematic connectivity to get the proper netnames of connected items
+            const NETLIST_OBJECT_LIST* objectsConnectedList = GetConnectivity();
             buildNetlistOk = true;
 
             for( auto obj : *objectsConnectedList )
@@ -96,8 +96,8 @@ bool SCH_EDIT_FRAME::SetCurrentSheetHighlightFlags()
     if( TestDuplicateSheetNames( false ) > 0 )
         return false;
 
-    // Build netlist info to get the proper netnames
-    std::unique_ptr<NETLIST_OBJECT_LIST> objectsConnectedList( BuildNetListBase( false ) );
+    // Use the schematic connectivity to get the proper netnames
+    const NETLIST_OBJECT_LIST* objectsConnectedList = GetConnectivity( false );
 
     // highlight the items belonging to this net
     for( auto obj1 : *objectsConnectedList )
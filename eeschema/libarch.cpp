@@ -104,6 +104,8 @@ bool SCH_EDIT_FRAME::CreateArchiveLibrary( const wxString& aFileName )
             DisplayError( this, msg );
             return false;
         }
+
+        formatter.Finish();
     }
     catch( ... /* IO_ERROR ioe */ )
     {
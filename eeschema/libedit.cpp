@@ -391,6 +391,8 @@ bool LIB_EDIT_FRAME::SaveActiveLibrary( bool newFile )
             DisplayError( this, msg );
             return false;
         }
+
+        libFormatter.Finish();
     }
     catch( ... /* IO_ERROR ioe */ )
     {
@@ -433,6 +435,8 @@ bool LIB_EDIT_FRAME::SaveActiveLibrary( bool newFile )
             DisplayError( this, msg );
             return false;
         }
+
+        docFormatter.Finish();
     }
     catch( ... /* IO_ERROR ioe */ )
     {
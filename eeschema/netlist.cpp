@@ -44,6 +44,10 @@
 #include <sch_text.h>
 #include <sch_sheet.h>
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <unordered_map>
 #include <invoke_sch_dialog.h>
 
 #define IS_WIRE false
@@ -123,6 +127,32 @@ bool SCH_EDIT_FRAME::CreateNetlist( int aFormat, const wxString& aFullFileName,
 
 //#define NETLIST_DEBUG
 
+NETLIST_OBJECT_LIST::NETLIST_OBJECT_LIST( const NETLIST_OBJECT_LIST& aSource ) :
+    NETLIST_OBJECTS()
+{
+    m_lastNetCode = aSource.m_lastNetCode;
+    m_lastBusNetCode = aSource.m_lastBusNetCode;
+
+    reserve( aSource.size() );
+
+    std::unordered_map<const NETLIST_OBJECT*, NETLIST_OBJECT*> copies;
+
+    for( NETLIST_OBJECT* item : aSource )
+    {
+        NETLIST_OBJECT* copy = new NETLIST_OBJECT( *item );
+
+        copies[item] = copy;
+        push_back( copy );
+    }
+
+    for( NETLIST_OBJECT* copy : *this )
+    {
+        if( copy->GetNetNameCandidate() )
+            copy->SetNetNameCandidate( copies[ copy->GetNetNameCandidate() ] );
+    }
+}
+
+
 NETLIST_OBJECT_LIST::~NETLIST_OBJECT_LIST()
 {
     Clear();
@@ -151,158 +181,645 @@ void NETLIST_OBJECT_LIST::SortListbyNetcode()
 
 void NETLIST_OBJECT_LIST::SortListbySheet()
 {
-    sort( this->begin(), this->end(), NETLIST_OBJECT_LIST::sortItemsBySheet );
+    // Keep the items of a sheet in the order they were created, so all the instances
+    // of a sheet list their items in the same order, see connectSheets().
+    stable_sort( this->begin(), this->end(), NETLIST_OBJECT_LIST::sortItemsBySheet );
 }
 
 
 NETLIST_OBJECT_LIST* SCH_EDIT_FRAME::BuildNetListBase( bool updateStatusText )
 {
-    // I own this list until I return it to the new owner.
-    std::unique_ptr<NETLIST_OBJECT_LIST> ret( new NETLIST_OBJECT_LIST() );
+    // The caller owns the list and can modify it, so give it a copy of the cached one.
+    return new NETLIST_OBJECT_LIST( *GetConnectivity( updateStatusText ) );
+}
+
+
+const NETLIST_OBJECT_LIST* SCH_EDIT_FRAME::GetConnectivity( bool updateStatusText )
+{
+    // Each change of a screen gives it a new stamp, greater than all the previous ones,
+    // and a new screen also gets a new stamp.  So the connectivity is up to date as long
+    // as the greatest stamp of the hierarchy and the libraries are unchanged.
+    SCH_SCREENS screens;
+    unsigned    stamp = 0;
+    int         libHash = Prj().SchLibs()->GetModifyHash();
+
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+        stamp = std::max( stamp, screen->GetChangeStamp() );
 
-    // Creates the flattened sheet list:
-    SCH_SHEET_LIST aSheets( g_RootSheet );
+    if( !m_connectivity || stamp != m_connectivityStamp || libHash != m_connectivityLibHash )
+    {
+        // Creates the flattened sheet list:
+        SCH_SHEET_LIST aSheets( g_RootSheet );
+
+        // Build netlist info
+        std::unique_ptr<NETLIST_OBJECT_LIST> list( new NETLIST_OBJECT_LIST() );
+        list->BuildNetListInfo( aSheets );
 
-    // Build netlist info
-    bool success = ret->BuildNetListInfo( aSheets );
+        delete m_connectivity;
+        m_connectivity = list.release();
+        m_connectivityStamp = stamp;
+        m_connectivityLibHash = libHash;
+    }
 
-    if( !success )
+    if( updateStatusText )
     {
-        if( updateStatusText )
+        if( m_connectivity->size() == 0 )
             SetStatusText( _( "No Objects" ) );
-        return ret.release();
+        else
+            SetStatusText( wxString::Format( _( "Net count = %d" ),
+                                             int( m_connectivity->size() ) ) );
+    }
+
+    return m_connectivity;
+}
+
+
+void NETCODE_UNION::Reset( unsigned aItemCount )
+{
+    m_itemNode.assign( aItemCount, -1 );
+    m_parent.clear();
+    m_rank.clear();
+    m_netCode.clear();
+    m_codeRoot.clear();
+}
+
+
+int NETCODE_UNION::find( int aNode )
+{
+    while( m_parent[aNode] != aNode )
+    {
+        m_parent[aNode] = m_parent[ m_parent[aNode] ];     // path halving
+        aNode = m_parent[aNode];
     }
 
-    wxString msg = wxString::Format( _( "Net count = %d" ), int( ret->size() ) );
+    return aNode;
+}
 
-    if( updateStatusText )
-         SetStatusText( msg );
 
-    return ret.release();
+int NETCODE_UNION::Get( unsigned aItem )
+{
+    int node = m_itemNode[aItem];
+
+    return node < 0 ? 0 : m_netCode[ find( node ) ];
 }
 
 
-bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
+void NETCODE_UNION::Set( unsigned aItem, int aNetCode )
 {
-    SCH_SHEET_PATH* sheet;
+    if( (int) m_codeRoot.size() <= aNetCode )
+        m_codeRoot.resize( aNetCode + 1, -1 );
+
+    // A new node is used even if the item already had one: the item leaves its old
+    // net, and the old node stays as an empty member of it.
+    int node = m_parent.size();
+
+    m_itemNode[aItem] = node;
+    m_parent.push_back( node );
+    m_rank.push_back( 0 );
+    m_netCode.push_back( aNetCode );
+
+    if( m_codeRoot[aNetCode] < 0 )
+        m_codeRoot[aNetCode] = node;
+    else
+        m_parent[node] = m_codeRoot[aNetCode];
+}
 
-    // Fill list with connected items from the flattened sheet list
-    for( unsigned i = 0; i < aSheets.size();  i++ )
+
+void NETCODE_UNION::Propagate( int aOldNetCode, int aNewNetCode )
+{
+    if( aOldNetCode == aNewNetCode || aOldNetCode >= (int) m_codeRoot.size() )
+        return;
+
+    int oldRoot = m_codeRoot[aOldNetCode];
+
+    if( oldRoot < 0 )
+        return;
+
+    if( (int) m_codeRoot.size() <= aNewNetCode )
+        m_codeRoot.resize( aNewNetCode + 1, -1 );
+
+    int newRoot = m_codeRoot[aNewNetCode];
+    int root = oldRoot;
+
+    m_codeRoot[aOldNetCode] = -1;
+
+    if( newRoot >= 0 )
     {
-        sheet = &aSheets[i];
+        if( m_rank[oldRoot] < m_rank[newRoot] )
+            root = newRoot;
+        else if( m_rank[oldRoot] == m_rank[newRoot] )
+            m_rank[oldRoot]++;
 
-        for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
-        {
-            item->GetNetListItem( *this, sheet );
-        }
+        m_parent[ root == oldRoot ? newRoot : oldRoot ] = root;
     }
 
-    if( size() == 0 )
-        return false;
+    m_netCode[root] = aNewNetCode;
+    m_codeRoot[aNewNetCode] = root;
+}
 
-    // Sort objects by Sheet
-    SortListbySheet();
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
-    m_lastNetCode = m_lastBusNetCode = 1;
+/**
+ * Class CONNECTION_GRID
+ * buckets the items of one sheet by their connection points, so the items connected
+ * to a point are found without scanning the whole sheet.  Wire and bus segments are
+ * also bucketed in the cells of a coarse grid they cross, for the search of the
+ * segments a junction or a label is on.
+ */
+class CONNECTION_GRID
+{
+public:
+    /// Fill the grid with the items aStart to aEnd - 1 of aList.
+    void Build( const NETLIST_OBJECT_LIST& aList, unsigned aStart, unsigned aEnd );
+
+    void Clear();
+
+    /// Append to aItems the items of the wire or bus kind having an end at aPoint.
+    void ItemsAt( const wxPoint& aPoint, bool aIsBus, std::vector<unsigned>& aItems ) const;
+
+    /// Append to aItems the wire or bus segments which may contain aPoint.
+    void SegmentsNear( const wxPoint& aPoint, bool aIsBus, std::vector<unsigned>& aItems ) const;
+
+private:
+    typedef std::unordered_multimap< uint64_t, unsigned > BUCKETS;
+
+    static const int CELL_SIZE = 1024;      // in internal units
+
+    static uint64_t key( int aX, int aY )
+    {
+        return ( uint64_t( uint32_t( aX ) ) << 32 ) | uint32_t( aY );
+    }
+
+    static int cell( int aCoord )
+    {
+        // round towards minus infinity, so cells do not overlap around 0
+        return aCoord >= 0 ? aCoord / CELL_SIZE : ( aCoord + 1 ) / CELL_SIZE - 1;
+    }
+
+    void addPoints( BUCKETS& aBuckets, const NETLIST_OBJECT* aItem, unsigned aIndex );
+    void addSegment( BUCKETS& aBuckets, const NETLIST_OBJECT* aItem, unsigned aIndex );
+
+    BUCKETS m_points[2];        // indexed by IS_WIRE or IS_BUS
+    BUCKETS m_segments[2];
+};
+
+
+void CONNECTION_GRID::addPoints( BUCKETS& aBuckets, const NETLIST_OBJECT* aItem,
+                                 unsigned aIndex )
+{
+    aBuckets.insert( std::make_pair( key( aItem->m_Start.x, aItem->m_Start.y ), aIndex ) );
+
+    if( aItem->m_End != aItem->m_Start )
+        aBuckets.insert( std::make_pair( key( aItem->m_End.x, aItem->m_End.y ), aIndex ) );
+}
+
+
+void CONNECTION_GRID::addSegment( BUCKETS& aBuckets, const NETLIST_OBJECT* aItem,
+                                  unsigned aIndex )
+{
+    int xmin = cell( std::min( aItem->m_Start.x, aItem->m_End.x ) );
+    int xmax = cell( std::max( aItem->m_Start.x, aItem->m_End.x ) );
+    int ymin = cell( std::min( aItem->m_Start.y, aItem->m_End.y ) );
+    int ymax = cell( std::max( aItem->m_Start.y, aItem->m_End.y ) );
+
+    for( int x = xmin;  x <= xmax;  x++ )
+    {
+        for( int y = ymin;  y <= ymax;  y++ )
+            aBuckets.insert( std::make_pair( key( x, y ), aIndex ) );
+    }
+}
+
+
+void CONNECTION_GRID::Clear()
+{
+    for( int ii = 0;  ii < 2;  ii++ )
+    {
+        BUCKETS().swap( m_points[ii] );
+        BUCKETS().swap( m_segments[ii] );
+    }
+}
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+
+void CONNECTION_GRID::Build( const NETLIST_OBJECT_LIST& aList, unsigned aStart, unsigned aEnd )
+{
+    Clear();
+
+    for( unsigned ii = aStart; ii < aEnd; ii++ )
     {
-        NETLIST_OBJECT* net_item = GetItem( ii );
+        const NETLIST_OBJECT* item = aList.GetItem( ii );
 
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
+        // The item kinds matched by pointToPointConnect() and segmentToPointConnect()
+        switch( item->m_Type )
         {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+        case NET_SEGMENT:
+            addPoints( m_points[IS_WIRE], item, ii );
+            addSegment( m_segments[IS_WIRE], item, ii );
+            break;
+
+        case NET_PIN:
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+        case NET_SHEETLABEL:
+        case NET_PINLABEL:
+        case NET_NOCONNECT:
+            addPoints( m_points[IS_WIRE], item, ii );
+            break;
+
+        case NET_JUNCTION:
+            addPoints( m_points[IS_WIRE], item, ii );
+            addPoints( m_points[IS_BUS], item, ii );
+            break;
+
+        case NET_BUS:
+            addPoints( m_points[IS_BUS], item, ii );
+            addSegment( m_segments[IS_BUS], item, ii );
+            break;
+
+        case NET_BUSLABELMEMBER:
+        case NET_SHEETBUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            addPoints( m_points[IS_BUS], item, ii );
+            break;
+
+        case NET_ITEM_UNSPECIFIED:
+            break;
         }
+    }
+}
+
+
+void CONNECTION_GRID::ItemsAt( const wxPoint& aPoint, bool aIsBus,
+                               std::vector<unsigned>& aItems ) const
+{
+    auto range = m_points[aIsBus].equal_range( key( aPoint.x, aPoint.y ) );
+
+    for( auto it = range.first;  it != range.second;  ++it )
+        aItems.push_back( it->second );
+}
+
+
+void CONNECTION_GRID::SegmentsNear( const wxPoint& aPoint, bool aIsBus,
+                                    std::vector<unsigned>& aItems ) const
+{
+    auto range = m_segments[aIsBus].equal_range( key( cell( aPoint.x ), cell( aPoint.y ) ) );
+
+    for( auto it = range.first;  it != range.second;  ++it )
+        aItems.push_back( it->second );
+}
+
+
+/**
+ * Class SHEET_CONNECTIONS
+ * finds the connections made by wires, buses and junctions between the items of one
+ * sheet, i.e. the items aStart to aEnd - 1 of a NETLIST_OBJECT_LIST sorted by sheet.
+ * The net codes are numbered from 1 in each sheet, and offset when the sheets are
+ * merged.  The list is only read, so several sheets can be processed at once.
+ */
+class SHEET_CONNECTIONS
+{
+public:
+    SHEET_CONNECTIONS( const NETLIST_OBJECT_LIST& aList, unsigned aStart, unsigned aEnd ) :
+        m_list( aList ),
+        m_start( aStart ),
+        m_end( aEnd ),
+        m_lastNetCode( 1 ),
+        m_lastBusNetCode( 1 )
+    {
+    }
 
-        switch( net_item->m_Type )
+    void Connect();
+
+    /**
+     * Function IsSameAs
+     * @return true if the items of this sheet are the same as the ones of \a aOther,
+     *         which happens for the instances of a sheet used several times.  The
+     *         connections of one are then the connections of the other.
+     */
+    bool IsSameAs( const SHEET_CONNECTIONS& aOther ) const;
+
+    unsigned Start() const          { return m_start; }
+    unsigned End() const            { return m_end; }
+
+    /// @return the net code of the item aStart + \a aOffset, 0 if none.
+    int GetNet( unsigned aOffset )      { return m_nets.Get( aOffset ); }
+    int GetBusNet( unsigned aOffset )   { return m_busNets.Get( aOffset ); }
+
+    int NetCount() const            { return m_lastNetCode - 1; }
+    int BusNetCount() const         { return m_lastBusNetCode - 1; }
+
+private:
+    void pointToPointConnect( unsigned aRef, bool aIsBus );
+
+    /**
+     * Search connections between a junction and segments
+     * Propagate the junction net code to objects connected by this junction.
+     * The junction must have a valid net code
+     */
+    void segmentToPointConnect( unsigned aJonction, bool aIsBus );
+
+    const NETLIST_OBJECT_LIST& m_list;
+    unsigned        m_start;
+    unsigned        m_end;
+    CONNECTION_GRID m_grid;
+    NETCODE_UNION   m_nets;         // indexed by list index - m_start
+    NETCODE_UNION   m_busNets;
+    int             m_lastNetCode;
+    int             m_lastBusNetCode;
+};
+
+
+bool SHEET_CONNECTIONS::IsSameAs( const SHEET_CONNECTIONS& aOther ) const
+{
+    if( m_end - m_start != aOther.m_end - aOther.m_start )
+        return false;
+
+    if( m_list.GetItem( m_start )->m_SheetPath.LastScreen()
+        != m_list.GetItem( aOther.m_start )->m_SheetPath.LastScreen() )
+        return false;
+
+    for( unsigned ii = 0; ii < m_end - m_start; ii++ )
+    {
+        const NETLIST_OBJECT* item = m_list.GetItem( m_start + ii );
+        const NETLIST_OBJECT* other = m_list.GetItem( aOther.m_start + ii );
+
+        if( item->m_Type != other->m_Type || item->m_Start != other->m_Start
+            || item->m_End != other->m_End )
+            return false;
+    }
+
+    return true;
+}
+
+
+void SHEET_CONNECTIONS::Connect()
+{
+    m_nets.Reset( m_end - m_start );
+    m_busNets.Reset( m_end - m_start );
+    m_grid.Build( m_list, m_start, m_end );
+
+    for( unsigned ii = m_start; ii < m_end; ii++ )
+    {
+        unsigned idx = ii - m_start;
+
+        switch( m_list.GetItem( ii )->m_Type )
         {
         case NET_ITEM_UNSPECIFIED:
-            wxMessageBox( wxT( "BuildNetListInfo() error" ) );
-            break;
+            break;      // reported by NETLIST_OBJECT_LIST::connectSheets()
 
         case NET_PIN:
         case NET_PINLABEL:
         case NET_SHEETLABEL:
         case NET_NOCONNECT:
-            if( net_item->GetNet() != 0 )
+            if( m_nets.Get( idx ) != 0 )
                 break;
 
         case NET_SEGMENT:
             // Test connections point to point type without bus.
-            if( net_item->GetNet() == 0 )
+            if( m_nets.Get( idx ) == 0 )
             {
-                net_item->SetNet( m_lastNetCode );
+                m_nets.Set( idx, m_lastNetCode );
                 m_lastNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
+            pointToPointConnect( ii, IS_WIRE );
             break;
 
         case NET_JUNCTION:
             // Control of the junction outside BUS.
-            if( net_item->GetNet() == 0 )
+            if( m_nets.Get( idx ) == 0 )
             {
-                net_item->SetNet( m_lastNetCode );
+                m_nets.Set( idx, m_lastNetCode );
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( ii, IS_WIRE );
 
             // Control of the junction, on BUS.
-            if( net_item->m_BusNetCode == 0 )
+            if( m_busNets.Get( idx ) == 0 )
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
+                m_busNets.Set( idx, m_lastBusNetCode );
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( ii, IS_BUS );
             break;
 
         case NET_LABEL:
         case NET_HIERLABEL:
         case NET_GLOBLABEL:
             // Test connections type junction without bus.
-            if( net_item->GetNet() == 0 )
+            if( m_nets.Get( idx ) == 0 )
             {
-                net_item->SetNet( m_lastNetCode );
+                m_nets.Set( idx, m_lastNetCode );
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( ii, IS_WIRE );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
+            if( m_busNets.Get( idx ) != 0 )
                 break;
 
         case NET_BUS:
             // Control type connections point to point mode bus
-            if( net_item->m_BusNetCode == 0 )
+            if( m_busNets.Get( idx ) == 0 )
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
+                m_busNets.Set( idx, m_lastBusNetCode );
                 m_lastBusNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
+            pointToPointConnect( ii, IS_BUS );
             break;
 
         case NET_BUSLABELMEMBER:
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
             // Control connections similar has on BUS
-            if( net_item->GetNet() == 0 )
+            if( m_nets.Get( idx ) == 0 )
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
+                m_busNets.Set( idx, m_lastBusNetCode );
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( ii, IS_BUS );
             break;
         }
     }
 
+    m_grid.Clear();
+}
+
+
+void SHEET_CONNECTIONS::pointToPointConnect( unsigned aRef, bool aIsBus )
+{
+    const NETLIST_OBJECT*   ref = m_list.GetItem( aRef );
+    NETCODE_UNION&          nets = aIsBus ? m_busNets : m_nets;
+    int                     netCode = nets.Get( aRef - m_start );
+    std::vector<unsigned>   items;
+
+    // Wire items for a wire, bus items and junctions for a bus, having an end
+    // on an end of aRef.
+    m_grid.ItemsAt( ref->m_Start, aIsBus, items );
+
+    if( ref->m_End != ref->m_Start )
+        m_grid.ItemsAt( ref->m_End, aIsBus, items );
+
+    for( unsigned i = 0; i < items.size(); i++ )
+    {
+        unsigned    idx = items[i] - m_start;
+        int         itemNet = nets.Get( idx );
+
+        if( itemNet == 0 )
+            nets.Set( idx, netCode );
+        else
+            nets.Propagate( itemNet, netCode );
+    }
+}
+
+
+void SHEET_CONNECTIONS::segmentToPointConnect( unsigned aJonction, bool aIsBus )
+{
+    const NETLIST_OBJECT*   jonction = m_list.GetItem( aJonction );
+    NETCODE_UNION&          nets = aIsBus ? m_busNets : m_nets;
+    int                     netCode = nets.Get( aJonction - m_start );
+    std::vector<unsigned>   segments;
+
+    m_grid.SegmentsNear( jonction->m_Start, aIsBus, segments );
+
+    for( unsigned i = 0; i < segments.size(); i++ )
+    {
+        const NETLIST_OBJECT* segment = m_list.GetItem( segments[i] );
+
+        if( IsPointOnSegment( segment->m_Start, segment->m_End, jonction->m_Start ) )
+        {
+            // Propagation Netcode has all the objects of the same Netcode.
+            unsigned    idx = segments[i] - m_start;
+            int         segmentNet = nets.Get( idx );
+
+            if( segmentNet )
+                nets.Propagate( segmentNet, netCode );
+            else
+                nets.Set( idx, netCode );
+        }
+    }
+}
+
+
+void NETLIST_OBJECT_LIST::connectSheets()
+{
+    std::vector< SHEET_CONNECTIONS >    sheets;
+    std::vector< unsigned >             source;     // sheet whose connections are used
+    std::vector< unsigned >             jobs;       // sheets to connect
+
+    for( unsigned ii = 0, iend; ii < size(); ii = iend )
+    {
+        const SCH_SHEET_PATH& sheet = GetItem( ii )->m_SheetPath;
+
+        for( iend = ii; iend < size(); iend++ )
+        {
+            if( GetItem( iend )->m_SheetPath != sheet )
+                break;
+
+            if( GetItem( iend )->m_Type == NET_ITEM_UNSPECIFIED )
+                wxMessageBox( wxT( "BuildNetListInfo() error" ) );
+        }
+
+        sheets.push_back( SHEET_CONNECTIONS( *this, ii, iend ) );
+
+        // Instances of a same sheet are connected once.
+        unsigned src = sheets.size() - 1;
+
+        for( unsigned jj = 0; jj < jobs.size(); jj++ )
+        {
+            if( sheets.back().IsSameAs( sheets[ jobs[jj] ] ) )
+            {
+                src = jobs[jj];
+                break;
+            }
+        }
+
+        source.push_back( src );
+
+        if( src == sheets.size() - 1 )
+            jobs.push_back( src );
+    }
+
+    // The sheets do not share anything until their labels are connected, so they
+    // are connected on as many threads as there are cores.
+    std::atomic<unsigned>   nextJob( 0 );
+
+    auto worker = [&]()
+    {
+        for( unsigned job = nextJob++;  job < jobs.size();  job = nextJob++ )
+            sheets[ jobs[job] ].Connect();
+    };
+
+    unsigned threadCount = std::min< unsigned >( std::thread::hardware_concurrency(),
+                                                 jobs.size() );
+    std::vector< std::thread > threads;
+
+    for( unsigned ii = 1; ii < threadCount; ii++ )
+        threads.push_back( std::thread( worker ) );
+
+    worker();   // this thread is one of the workers
+
+    for( unsigned ii = 0; ii < threads.size(); ii++ )
+        threads[ii].join();
+
+    // Merge the sheets, each one in turn gets the next range of net codes, as if the
+    // sheets were connected one after the other.
+    m_nets.Reset( size() );
+    m_lastNetCode = m_lastBusNetCode = 1;
+
+    for( unsigned ii = 0; ii < sheets.size(); ii++ )
+    {
+        SHEET_CONNECTIONS& sheet = sheets[ii];
+        SHEET_CONNECTIONS& connections = sheets[ source[ii] ];
+
+        for( unsigned jj = sheet.Start(); jj < sheet.End(); jj++ )
+        {
+            int netCode = connections.GetNet( jj - sheet.Start() );
+            int busNetCode = connections.GetBusNet( jj - sheet.Start() );
+
+            if( netCode )
+                m_nets.Set( jj, netCode + m_lastNetCode - 1 );
+
+            GetItem( jj )->m_BusNetCode = busNetCode ? busNetCode + m_lastBusNetCode - 1 : 0;
+        }
+
+        m_lastNetCode += connections.NetCount();
+        m_lastBusNetCode += connections.BusNetCount();
+    }
+}
+
+
+bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
+{
+    SCH_SHEET_PATH* sheet;
+
+    // Fill list with connected items from the flattened sheet list
+    for( unsigned i = 0; i < aSheets.size();  i++ )
+    {
+        sheet = &aSheets[i];
+
+        for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
+        {
+            item->GetNetListItem( *this, sheet );
+        }
+    }
+
+    if( size() == 0 )
+        return false;
+
+    // Sort objects by Sheet
+    SortListbySheet();
+
+    // Connections inside each sheet.  Net codes are kept in m_nets until the
+    // connections are all known, then stored in the items.
+    connectSheets();
+
 #if defined(NETLIST_DEBUG) && defined(DEBUG)
     std::cout << "\n\nafter sheet local\n\n";
     DumpNetTable();
@@ -311,6 +828,15 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     // Updating the Bus Labels Netcode connected by Bus
     connectBusLabels();
 
+    // Labels are grouped by text, only labels having the same text can be connected.
+    std::map< wxString, std::vector<unsigned> > labels;
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        if( GetItem( ii )->IsLabelType() )
+            labels[ GetItem( ii )->m_Label ].push_back( ii );
+    }
+
     // Group objects by label.
     for( unsigned ii = 0; ii < size(); ii++ )
     {
@@ -329,7 +855,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         case NET_PINLABEL:
         case NET_BUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
-            labelConnect( GetItem( ii ) );
+            labelConnect( ii, labels[ GetItem( ii )->m_Label ] );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -352,9 +878,14 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     {
         if( GetItem( ii )->m_Type == NET_SHEETLABEL
             || GetItem( ii )->m_Type == NET_SHEETBUSLABELMEMBER )
-            sheetLabelConnect( GetItem( ii ) );
+            sheetLabelConnect( ii, labels[ GetItem( ii )->m_Label ] );
     }
 
+    for( unsigned ii = 0; ii < size(); ii++ )
+        GetItem( ii )->SetNet( m_nets.Get( ii ) );
+
+    m_nets.Reset( 0 );
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -602,14 +1133,18 @@ void NETLIST_OBJECT_LIST::findBestNetNameForEachNet()
 }
 
 
-void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
+void NETLIST_OBJECT_LIST::sheetLabelConnect( unsigned aSheetLabel,
+                                             const std::vector<unsigned>& aLabels )
 {
-    if( SheetLabel->GetNet() == 0 )
+    NETLIST_OBJECT* SheetLabel = GetItem( aSheetLabel );
+
+    if( m_nets.Get( aSheetLabel ) == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
+    for( unsigned ii = 0; ii < aLabels.size(); ii++ )
     {
-        NETLIST_OBJECT* ObjetNet = GetItem( ii );
+        NETLIST_OBJECT* ObjetNet = GetItem( aLabels[ii] );
+        int             netCode = m_nets.Get( aLabels[ii] );
 
         if( ObjetNet->m_SheetPath != SheetLabel->m_SheetPathInclude )
             continue;  //use SheetInclude, not the sheet!!
@@ -617,17 +1152,14 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
         if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
+        if( netCode == m_nets.Get( aSheetLabel ) )
             continue;  //already connected.
 
-        if( ObjetNet->m_Label != SheetLabel->m_Label )
-            continue;  //different names.
-
         // Propagate Netcode having all the objects of the same Netcode.
-        if( ObjetNet->GetNet() )
-            propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
+        if( netCode )
+            propagateNetCode( netCode, m_nets.Get( aSheetLabel ) );
         else
-            ObjetNet->SetNet( SheetLabel->GetNet() );
+            m_nets.Set( aLabels[ii], m_nets.Get( aSheetLabel ) );
     }
 }
 
@@ -636,225 +1168,72 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
 {
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
-    // Search is done in the entire list
+    // Bus label members are grouped by bus net code and member number, only the
+    // members of a same group are connected.
+    std::map< std::pair<int, int>, std::vector<unsigned> > members;
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
 
         if( Label->IsLabelBusMemberType() )
-        {
-            if( Label->GetNet() == 0 )
-            {
-                // Not yet existiing net code: create a new one.
-                Label->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
-
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
-
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
-
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
-            }
-        }
-    }
-}
-
-
-void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
-{
-    if( aOldNetCode == aNewNetCode )
-        return;
-
-    if( aIsBus == false )    // Propagate NetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
-
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
+            members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ].push_back( ii );
     }
-    else               // Propagate BusNetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
-    }
-}
-
-
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
-{
-    int netCode;
-
-    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
-        netCode = aRef->GetNet();
+        NETLIST_OBJECT* Label = GetItem( ii );
 
-        for( unsigned i = start; i < size(); i++ )
+        if( Label->IsLabelBusMemberType() )
         {
-            NETLIST_OBJECT* item = GetItem( i );
-
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
-
-            switch( item->m_Type )
+            if( m_nets.Get( ii ) == 0 )
             {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
-                break;
-
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
+                // Not yet existiing net code: create a new one.
+                m_nets.Set( ii, m_lastNetCode );
+                m_lastNetCode++;
             }
-        }
-    }
-    else    // Object type BUS, BUSLABELS, and junctions.
-    {
-        netCode = aRef->m_BusNetCode;
-
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
+            const std::vector<unsigned>& group =
+                    members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ];
 
-            switch( item->m_Type )
+            for( std::vector<unsigned>::const_iterator jj =
+                    std::upper_bound( group.begin(), group.end(), ii );
+                 jj != group.end();  ++jj )
             {
-            case NET_ITEM_UNSPECIFIED:
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_NOCONNECT:
-                break;
-
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
-                }
-                break;
+                if( m_nets.Get( *jj ) == 0 )
+                    // Append this object to the current net
+                    m_nets.Set( *jj, m_nets.Get( ii ) );
+                else
+                    // Merge the 2 net codes, they are connected.
+                    propagateNetCode( m_nets.Get( *jj ), m_nets.Get( ii ) );
             }
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
-    {
-        NETLIST_OBJECT* segment = GetItem( i );
-
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
-            continue;
-
-        if( aIsBus == IS_WIRE )
-        {
-            if( segment->m_Type != NET_SEGMENT )
-                continue;
-        }
-        else
-        {
-            if( segment->m_Type != NET_BUS )
-                continue;
-        }
-
-        if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
-        {
-            // Propagation Netcode has all the objects of the same Netcode.
-            if( aIsBus == IS_WIRE )
-            {
-                if( segment->GetNet() )
-                    propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
-                else
-                    segment->SetNet( aJonction->GetNet() );
-            }
-            else
-            {
-                if( segment->m_BusNetCode )
-                    propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
-                else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
-            }
-        }
-    }
+    m_nets.Propagate( aOldNetCode, aNewNetCode );
 }
 
 
-void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
+void NETLIST_OBJECT_LIST::labelConnect( unsigned aLabelRef, const std::vector<unsigned>& aLabels )
 {
-    if( aLabelRef->GetNet() == 0 )
+    NETLIST_OBJECT* labelRef = GetItem( aLabelRef );
+
+    if( m_nets.Get( aLabelRef ) == 0 )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
+    for( unsigned i = 0; i < aLabels.size(); i++ )
     {
-        NETLIST_OBJECT* item = GetItem( i );
+        NETLIST_OBJECT* item = GetItem( aLabels[i] );
+        int             itemNet = m_nets.Get( aLabels[i] );
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+        if( itemNet == m_nets.Get( aLabelRef ) )
             continue;
 
-        if( item->m_SheetPath != aLabelRef->m_SheetPath )
+        if( item->m_SheetPath != labelRef->m_SheetPath )
         {
             if( item->m_Type != NET_PINLABEL && item->m_Type != NET_GLOBLABEL
                 && item->m_Type != NET_GLOBBUSLABELMEMBER )
@@ -862,7 +1241,7 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
 
             if( (item->m_Type == NET_GLOBLABEL
                  || item->m_Type == NET_GLOBBUSLABELMEMBER)
-               && item->m_Type != aLabelRef->m_Type )
+               && item->m_Type != labelRef->m_Type )
                 //global labels only connect other global labels.
                 continue;
         }
@@ -871,16 +1250,11 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
         // NET_LABEL are local to a sheet
         // NET_GLOBLABEL are global.
         // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
-        {
-            if( item->m_Label != aLabelRef->m_Label )
-                continue;
-
-            if( item->GetNet() )
-                propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
-        }
+        // aLabels only holds label items having the same text as labelRef.
+        if( itemNet )
+            propagateNetCode( itemNet, m_nets.Get( aLabelRef ) );
+        else
+            m_nets.Set( aLabels[i], m_nets.Get( aLabelRef ) );
     }
 }
 
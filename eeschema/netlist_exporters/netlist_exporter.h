@@ -230,6 +230,25 @@ public:
             const wxString& aTempfile, const wxString& aFinalFile,
             const wxString& aProjectDirectory
             );
+
+    /**
+     * Function Create
+     * returns a new exporter for \a aFormat, one of NETLIST_TYPE_ID.  The custom formats
+     * all get the generic (intermediate XML) exporter, see IsGenericFormat().
+     *
+     * @param aMasterList is given to the new exporter, which takes ownership of it.
+     * @param aLibs is the part libraries of the project, no ownership.
+     * @return NETLIST_EXPORTER* - the caller owns it.
+     */
+    static NETLIST_EXPORTER* Create( int aFormat, NETLIST_OBJECT_LIST* aMasterList,
+                                     PART_LIBS* aLibs );
+
+    /**
+     * Function IsGenericFormat
+     * @return true if \a aFormat is written as the generic intermediate netlist, which
+     *  an external command line (a netlist or BOM plugin) turns into the final file.
+     */
+    static bool IsGenericFormat( int aFormat );
 };
 
 #endif
@@ -41,9 +41,22 @@
 
 bool NETLIST_EXPORTER_PSPICE::WriteNetlist( const wxString& aOutFileName, unsigned aNetlistOptions )
 {
-    FILE_OUTPUTFORMATTER outputFile( aOutFileName, wxT( "wt" ), '\'' );
+    try
+    {
+        FILE_OUTPUTFORMATTER outputFile( aOutFileName, wxT( "wt" ), '\'' );
+
+        if( !Format( &outputFile, aNetlistOptions ) )
+            return false;
+
+        outputFile.Finish();
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        DisplayError( NULL, ioe.What() );
+        return false;
+    }
 
-    return Format( &outputFile, aNetlistOptions );
+    return true;
 }
 
 void  NETLIST_EXPORTER_PSPICE::ReplaceForbiddenChars( wxString &aNetName )
@@ -339,7 +339,7 @@ void SCH_EDIT_FRAME::OnLeftClick( wxDC* aDC, const wxPoint& aPosition )
             if( !item )
                 break;
 
-            NETLIST_OBJECT_LIST* netlist = BuildNetListBase();
+            const NETLIST_OBJECT_LIST* netlist = GetConnectivity();
 
             for( NETLIST_OBJECT* obj : *netlist )
             {
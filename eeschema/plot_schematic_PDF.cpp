@@ -40,124 +40,122 @@
 
 void DIALOG_PLOT_SCHEMATIC::createPDFFile( bool aPlotAll, bool aPlotFrameRef )
 {
-    SCH_SCREEN*     screen = m_parent->GetScreen();
-    SCH_SHEET_PATH  oldsheetpath = m_parent->GetCurrentSheet();     // sheetpath is saved here
-
-    /* When printing all pages, the printed page is not the current page.  In
-     * complex hierarchies, we must update component references and others
-     * parameters in the given printed SCH_SCREEN, accordint to the sheet path
-     * because in complex hierarchies a SCH_SCREEN (a drawing ) is shared
-     * between many sheets and component references depend on the actual sheet
-     * path used
-     */
-    SCH_SHEET_LIST sheetList;
+    std::vector<PLOT_SHEET> sheets = buildPlotSheets( aPlotAll );
+    bool                    colorMode = getModeColor();
 
-    if( aPlotAll )
-        sheetList.BuildSheetList( g_RootSheet );
-    else
-        sheetList.push_back( m_parent->GetCurrentSheet() );
+    wxString msg;
+    wxFileName plotFileName;
+    REPORTER& reporter = m_MessagesBox->Reporter();
+    LOCALE_IO toggle;       // Switch the locale to standard C
 
     // Allocate the plotter and set the job level parameter
     PDF_PLOTTER* plotter = new PDF_PLOTTER();
     plotter->SetDefaultLineWidth( GetDefaultLineThickness() );
-    plotter->SetColorMode( getModeColor() );
+    plotter->SetColorMode( colorMode );
     plotter->SetCreator( wxT( "Eeschema-PDF" ) );
     plotter->SetTitle( m_parent->GetTitleBlock().GetTitle() );
 
-    wxString msg;
-    wxFileName plotFileName;
-    REPORTER& reporter = m_MessagesBox->Reporter();
-    LOCALE_IO toggle;       // Switch the locale to standard C
-
-    for( unsigned i = 0; i < sheetList.size(); i++ )
+    try
     {
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-        screen = m_parent->GetCurrentSheet().LastScreen();
+        wxString fname = sheets[0].m_FileName;
+        wxString ext = PDF_PLOTTER::GetDefaultFileExtension();
+        plotFileName = createPlotFileName( m_outputDirectoryName,
+                                           fname, ext, &reporter );
 
-        if( i == 0 )
+        if( !plotter->OpenFile( plotFileName.GetFullPath() ) )
         {
+            msg.Printf( _( "Unable to create file '%s'.\n" ),
+                        GetChars( plotFileName.GetFullPath() ) );
+            reporter.Report( msg, REPORTER::RPT_ERROR );
+            delete plotter;
+            return;
+        }
+    }
+    catch( const IO_ERROR& e )
+    {
+        // Cannot plot PDF file
+        msg.Printf( wxT( "PDF Plotter exception: %s" ), GetChars( e.What() ) );
+        reporter.Report( msg, REPORTER::RPT_ERROR );
+        delete plotter;
+        return;
+    }
 
-            try
-            {
-                wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
-                wxString ext = PDF_PLOTTER::GetDefaultFileExtension();
-                plotFileName = createPlotFileName( m_outputDirectoryName,
-                                                   fname, ext, &reporter );
-
-                if( !plotter->OpenFile( plotFileName.GetFullPath() ) )
-                {
-                    msg.Printf( _( "Unable to create file '%s'.\n" ),
-                                GetChars( plotFileName.GetFullPath() ) );
-                    reporter.Report( msg, REPORTER::RPT_ERROR );
-                    delete plotter;
-                    return;
-                }
-
-                // Open the plotter and do the first page
-                setupPlotPagePDF( plotter, screen );
-                plotter->StartPlot();
-            }
-            catch( const IO_ERROR& e )
-            {
-                // Cannot plot PDF file
-                msg.Printf( wxT( "PDF Plotter exception: %s" ), GetChars( e.What() ) );
-                reporter.Report( msg, REPORTER::RPT_ERROR );
-
-                restoreEnvironment( plotter, oldsheetpath );
-                return;
-            }
-
+    /* Each page is plotted and compressed by its own plotter, on as many threads as
+     * possible.  The pages are then added to the document in the sheet order.
+     */
+    plotSheets( sheets, [&]( PLOT_SHEET& aSheet )
+    {
+        PDF_PLOTTER pagePlotter;
+
+        pagePlotter.SetDefaultLineWidth( GetDefaultLineThickness() );
+        pagePlotter.SetColorMode( colorMode );
+        setupPlotPagePDF( &pagePlotter, aSheet.m_Screen );
+
+        // Each page needs its own temporary file.  If plotting the sheet throws, the
+        // file is removed by the destructor of pagePlotter.
+        pagePlotter.StartPageStream( wxString::Format( wxT( "%s.%d.tmp" ),
+                                                       GetChars( plotFileName.GetFullPath() ),
+                                                       aSheet.m_SheetNumber ) );
+        plotSheetContent( &pagePlotter, aSheet, aPlotFrameRef );
+        aSheet.m_PdfPage = pagePlotter.ClosePageStream();
+        aSheet.m_Success = true;
+    } );
+
+    bool success = true;
+    bool anyPage = false;
+
+    for( const PLOT_SHEET& sheet : sheets )
+    {
+        if( !sheet.m_Success )
+        {
+            msg.Printf( wxT( "PDF Plotter exception: %s" ), GetChars( sheet.m_Message ) );
+            reporter.Report( msg, REPORTER::RPT_ERROR );
+            success = false;
         }
         else
         {
-            /* For the following pages you need to close the (finished) page,
-             *  reconfigure, and then start a new one */
-            plotter->ClosePage();
-            setupPlotPagePDF( plotter, screen );
-            plotter->StartPage();
+            anyPage = true;
         }
-
-        plotOneSheetPDF( plotter, screen, aPlotFrameRef );
     }
 
-    // Everything done, close the plot and restore the environment
-    msg.Printf( _( "Plot: '%s' OK.\n" ), GetChars( plotFileName.GetFullPath() ) );
-    reporter.Report( msg, REPORTER::RPT_ACTION );
+    // Do not leave a PDF file without any page
+    if( !anyPage )
+    {
+        delete plotter;     // closes the file
+        ::wxRemoveFile( plotFileName.GetFullPath() );
 
-    restoreEnvironment( plotter, oldsheetpath );
-}
+        msg.Printf( _( "Plot: '%s' not created, no sheet could be plotted.\n" ),
+                    GetChars( plotFileName.GetFullPath() ) );
+        reporter.Report( msg, REPORTER::RPT_ERROR );
+        return;
+    }
 
+    plotter->StartDocument();
 
-void DIALOG_PLOT_SCHEMATIC::restoreEnvironment( PDF_PLOTTER* aPlotter,
-                                                SCH_SHEET_PATH& aOldsheetpath )
-{
-    aPlotter->EndPlot();
-    delete aPlotter;
+    for( const PLOT_SHEET& sheet : sheets )
+    {
+        if( !sheet.m_Success )
+            continue;
 
-    // Restore the previous sheet
-    m_parent->SetCurrentSheet( aOldsheetpath );
-    m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-    m_parent->SetSheetNumberAndCount();
-}
+        setupPlotPagePDF( plotter, sheet.m_Screen );
+        plotter->AddPage( sheet.m_PdfPage );
+    }
 
+    // Everything done, close the plot
+    plotter->EndPlot();
+    delete plotter;
 
-void DIALOG_PLOT_SCHEMATIC::plotOneSheetPDF( PLOTTER* aPlotter,
-                                             SCH_SCREEN* aScreen,
-                                             bool aPlotFrameRef )
-{
-    if( aPlotFrameRef )
+    if( success )
     {
-        aPlotter->SetColor( BLACK );
-        PlotWorkSheet( aPlotter, m_parent->GetTitleBlock(),
-                       m_parent->GetPageSettings(),
-                       aScreen->m_ScreenNumber, aScreen->m_NumberOfScreens,
-                       m_parent->GetScreenDesc(),
-                       aScreen->GetFileName() );
+        msg.Printf( _( "Plot: '%s' OK.\n" ), GetChars( plotFileName.GetFullPath() ) );
+        reporter.Report( msg, REPORTER::RPT_ACTION );
+    }
+    else
+    {
+        msg.Printf( _( "Plot: '%s' is incomplete, some sheets could not be plotted.\n" ),
+                    GetChars( plotFileName.GetFullPath() ) );
+        reporter.Report( msg, REPORTER::RPT_ERROR );
     }
-
-    aScreen->Plot( aPlotter );
 }
 
 
@@ -38,31 +38,39 @@
 
 void DIALOG_PLOT_SCHEMATIC::createPSFile( bool aPlotAll, bool aPlotFrameRef )
 {
-    SCH_SCREEN*     screen = m_parent->GetScreen();
-    SCH_SHEET_PATH  oldsheetpath = m_parent->GetCurrentSheet();  // sheetpath is saved here
-    PAGE_INFO       actualPage;                                  // page size selected in schematic
-    PAGE_INFO       plotPage;                                    // page size selected to plot
-
     /* When printing all pages, the printed page is not the current page.
      * In complex hierarchies, we must update component references
      *  and others parameters in the given printed SCH_SCREEN, accordint to the sheet path
      *  because in complex hierarchies a SCH_SCREEN (a drawing )
      *  is shared between many sheets and component references depend on the actual sheet path used
      */
-    SCH_SHEET_LIST  sheetList;
+    std::vector<PLOT_SHEET> sheets = buildPlotSheets( aPlotAll );
+    bool                    colorMode = getModeColor();
 
-    if( aPlotAll )
-        sheetList.BuildSheetList( g_RootSheet );
-    else
-        sheetList.push_back( m_parent->GetCurrentSheet() );
+    wxString msg;
+    REPORTER& reporter = m_MessagesBox->Reporter();
 
-    for( unsigned i = 0; i < sheetList.size(); i++ )
+    for( PLOT_SHEET& sheet : sheets )
     {
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-        screen = m_parent->GetCurrentSheet().LastScreen();
-        actualPage = screen->GetPageSettings();
+        try
+        {
+            wxString ext = PS_PLOTTER::GetDefaultFileExtension();
+            sheet.m_PlotFileName = createPlotFileName( m_outputDirectoryName,
+                                                       sheet.m_FileName, ext, &reporter );
+        }
+        catch( IO_ERROR& e )
+        {
+            sheet.m_Message = e.What();
+        }
+    }
+
+    plotSheets( sheets, [&]( PLOT_SHEET& aSheet )
+    {
+        if( !aSheet.m_Message.IsEmpty() )
+            return;
+
+        PAGE_INFO actualPage = aSheet.m_Screen->GetPageSettings(); // page size selected in schematic
+        PAGE_INFO plotPage;                                        // page size selected to plot
 
         switch( m_pageSizeSelect )
         {
@@ -89,64 +97,52 @@ void DIALOG_PLOT_SCHEMATIC::createPSFile( bool aPlotAll, bool aPlotFrameRef )
 
         wxPoint plot_offset;
 
-        wxString outputDirName = m_outputDirectoryName->GetValue();
-
-        wxString msg;
-        REPORTER& reporter = m_MessagesBox->Reporter();
+        aSheet.m_Success = plotOneSheetPS( aSheet, plotPage, plot_offset, scale, colorMode,
+                                           aPlotFrameRef );
+    } );
 
-        try
+    for( const PLOT_SHEET& sheet : sheets )
+    {
+        if( !sheet.m_Message.IsEmpty() )
         {
-            wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
-            wxString ext = PS_PLOTTER::GetDefaultFileExtension();
-            wxFileName plotFileName = createPlotFileName( m_outputDirectoryName,
-                                                          fname, ext, &reporter );
-
-            if( plotOneSheetPS( plotFileName.GetFullPath(), screen, plotPage, plot_offset,
-                                scale, aPlotFrameRef ) )
-            {
-                msg.Printf( _( "Plot: '%s' OK.\n" ), GetChars( plotFileName.GetFullPath() ) );
-                reporter.Report( msg, REPORTER::RPT_ACTION );
-            }
-            else
-            {
-                // Error
-                msg.Printf( _( "Unable to create file '%s'.\n" ),
-                            GetChars( plotFileName.GetFullPath() ) );
-                reporter.Report( msg, REPORTER::RPT_ERROR );
-            }
-
+            msg.Printf( wxT( "PS Plotter exception: %s"), GetChars( sheet.m_Message ) );
+            reporter.Report( msg, REPORTER::RPT_ERROR );
         }
-        catch( IO_ERROR& e )
+        else if( sheet.m_Success )
         {
-            msg.Printf( wxT( "PS Plotter exception: %s"), GetChars( e.What() ) );
+            msg.Printf( _( "Plot: '%s' OK.\n" ),
+                        GetChars( sheet.m_PlotFileName.GetFullPath() ) );
+            reporter.Report( msg, REPORTER::RPT_ACTION );
+        }
+        else
+        {
+            // Error
+            msg.Printf( _( "Unable to create file '%s'.\n" ),
+                        GetChars( sheet.m_PlotFileName.GetFullPath() ) );
             reporter.Report( msg, REPORTER::RPT_ERROR );
         }
     }
-
-    m_parent->SetCurrentSheet( oldsheetpath );
-    m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-    m_parent->SetSheetNumberAndCount();
 }
 
 
-bool DIALOG_PLOT_SCHEMATIC::plotOneSheetPS( const wxString&     aFileName,
-                                            SCH_SCREEN*         aScreen,
+bool DIALOG_PLOT_SCHEMATIC::plotOneSheetPS( const PLOT_SHEET&   aSheet,
                                             const PAGE_INFO&    aPageInfo,
                                             wxPoint             aPlot0ffset,
                                             double              aScale,
+                                            bool                aPlotColor,
                                             bool                aPlotFrameRef )
 {
     PS_PLOTTER* plotter = new PS_PLOTTER();
     plotter->SetPageSettings( aPageInfo );
     plotter->SetDefaultLineWidth( GetDefaultLineThickness() );
-    plotter->SetColorMode( getModeColor() );
+    plotter->SetColorMode( aPlotColor );
     // Currently, plot units are in decimil
     plotter->SetViewport( aPlot0ffset, IU_PER_MILS/10, aScale, false );
 
     // Init :
     plotter->SetCreator( wxT( "Eeschema-PS" ) );
 
-    if( ! plotter->OpenFile( aFileName ) )
+    if( ! plotter->OpenFile( aSheet.m_PlotFileName.GetFullPath() ) )
     {
         delete plotter;
         return false;
@@ -156,17 +152,7 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetPS( const wxString&     aFileName,
 
     plotter->StartPlot();
 
-    if( aPlotFrameRef )
-    {
-        plotter->SetColor( BLACK );
-        PlotWorkSheet( plotter, m_parent->GetTitleBlock(),
-                       m_parent->GetPageSettings(),
-                       aScreen->m_ScreenNumber, aScreen->m_NumberOfScreens,
-                       m_parent->GetScreenDesc(),
-                       aScreen->GetFileName() );
-    }
-
-    aScreen->Plot( plotter );
+    plotSheetContent( plotter, aSheet, aPlotFrameRef );
 
     plotter->EndPlot();
     delete plotter;
@@ -43,72 +43,62 @@
 
 void DIALOG_PLOT_SCHEMATIC::createSVGFile( bool aPrintAll, bool aPrintFrameRef )
 {
-    wxString        msg;
-    REPORTER&       reporter = m_MessagesBox->Reporter();
-    SCH_SHEET_PATH  oldsheetpath = m_parent->GetCurrentSheet();
-    SCH_SHEET_LIST  sheetList;
+    wxString                msg;
+    REPORTER&               reporter = m_MessagesBox->Reporter();
+    std::vector<PLOT_SHEET> sheets = buildPlotSheets( aPrintAll );
+    bool                    blackAndWhite = getModeColor() ? false : true;
 
-    if( aPrintAll )
-        sheetList.BuildSheetList( g_RootSheet );
-    else
-        sheetList.push_back( m_parent->GetCurrentSheet() );
-
-    for( unsigned i = 0; i < sheetList.size(); i++ )
+    for( PLOT_SHEET& sheet : sheets )
     {
-        SCH_SCREEN*  screen;
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-        screen = m_parent->GetCurrentSheet().LastScreen();
-
         try
         {
-            wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
             wxString ext = SVG_PLOTTER::GetDefaultFileExtension();
-            wxFileName plotFileName = createPlotFileName( m_outputDirectoryName,
-                                                          fname, ext, &reporter );
-
-            bool success = plotOneSheetSVG( m_parent, plotFileName.GetFullPath(), screen,
-                                            getModeColor() ? false : true,
-                                            aPrintFrameRef );
-
-            if( !success )
-            {
-                msg.Printf( _( "Cannot create file '%s'.\n" ),
-                            GetChars( plotFileName.GetFullPath() ) );
-                reporter.Report( msg, REPORTER::RPT_ERROR );
-            }
-            else
-            {
-                msg.Printf( _( "Plot: '%s' OK.\n" ),
-                            GetChars( plotFileName.GetFullPath() ) );
-                reporter.Report( msg, REPORTER::RPT_ACTION );
-            }
+            sheet.m_PlotFileName = createPlotFileName( m_outputDirectoryName,
+                                                       sheet.m_FileName, ext, &reporter );
         }
         catch( const IO_ERROR& e )
+        {
+            sheet.m_Message = e.What();
+        }
+    }
+
+    plotSheets( sheets, [&]( PLOT_SHEET& aSheet )
+    {
+        if( aSheet.m_Message.IsEmpty() )
+            aSheet.m_Success = plotOneSheetSVG( aSheet, blackAndWhite, aPrintFrameRef );
+    } );
+
+    for( const PLOT_SHEET& sheet : sheets )
+    {
+        if( !sheet.m_Message.IsEmpty() )
         {
             // Cannot plot SVG file
-            msg.Printf( wxT( "SVG Plotter exception: %s" ), GetChars( e.What() ) );
+            msg.Printf( wxT( "SVG Plotter exception: %s" ), GetChars( sheet.m_Message ) );
             reporter.Report( msg, REPORTER::RPT_ERROR );
-            break;
+        }
+        else if( !sheet.m_Success )
+        {
+            msg.Printf( _( "Cannot create file '%s'.\n" ),
+                        GetChars( sheet.m_PlotFileName.GetFullPath() ) );
+            reporter.Report( msg, REPORTER::RPT_ERROR );
+        }
+        else
+        {
+            msg.Printf( _( "Plot: '%s' OK.\n" ),
+                        GetChars( sheet.m_PlotFileName.GetFullPath() ) );
+            reporter.Report( msg, REPORTER::RPT_ACTION );
         }
     }
-
-    m_parent->SetCurrentSheet( oldsheetpath );
-    m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-    m_parent->SetSheetNumberAndCount();
 }
 
 
-bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( EDA_DRAW_FRAME*    aFrame,
-                                             const wxString&    aFileName,
-                                             SCH_SCREEN*        aScreen,
+bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( const PLOT_SHEET&  aSheet,
                                              bool               aPlotBlackAndWhite,
                                              bool               aPlotFrameRef )
 {
     SVG_PLOTTER* plotter = new SVG_PLOTTER();
 
-    const PAGE_INFO&   pageInfo = aScreen->GetPageSettings();
+    const PAGE_INFO&   pageInfo = aSheet.m_Screen->GetPageSettings();
     plotter->SetPageSettings( pageInfo );
     plotter->SetDefaultLineWidth( GetDefaultLineThickness() );
     plotter->SetColorMode( aPlotBlackAndWhite ? false : true );
@@ -120,7 +110,7 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( EDA_DRAW_FRAME*    aFrame,
     // Init :
     plotter->SetCreator( wxT( "Eeschema-SVG" ) );
 
-    if( ! plotter->OpenFile( aFileName ) )
+    if( ! plotter->OpenFile( aSheet.m_PlotFileName.GetFullPath() ) )
     {
         delete plotter;
         return false;
@@ -130,17 +120,7 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( EDA_DRAW_FRAME*    aFrame,
 
     plotter->StartPlot();
 
-    if( aPlotFrameRef )
-    {
-        plotter->SetColor( BLACK );
-        PlotWorkSheet( plotter, aFrame->GetTitleBlock(),
-                       aFrame->GetPageSettings(),
-                       aScreen->m_ScreenNumber, aScreen->m_NumberOfScreens,
-                       aFrame->GetScreenDesc(),
-                       aScreen->GetFileName() );
-    }
-
-    aScreen->Plot( plotter );
+    plotSheetContent( plotter, aSheet, aPlotFrameRef );
 
     plotter->EndPlot();
     delete plotter;
@@ -63,6 +63,8 @@ static bool save_library( const wxString& aFileName, PART_LIB* aLibrary, SCH_EDI
             DisplayError( aEditFrame, msg );
             return false;
         }
+
+        formatter.Finish();
     }
     catch( ... /* IO_ERROR ioe */ )
     {
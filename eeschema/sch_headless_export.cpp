@@ -0,0 +1,256 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sch_headless_export.cpp
+ * @brief Netlist and BOM export of a schematic without a SCH_EDIT_FRAME.
+ */
+
+#include <fctsys.h>
+#include <kiway.h>
+#include <project.h>
+#include <reporter.h>
+#include <profile.h>
+#include <wildcards_and_files_ext.h>
+
+#include <general.h>
+#include <class_library.h>
+#include <class_sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <sch_reference_list.h>
+#include <sch_io_mgr.h>
+#include <netlist.h>
+#include <netlist_exporter.h>
+#include <netlist_exporter_generic.h>
+#include <sch_headless_export.h>
+
+#include <memory>
+
+//Imported function:
+int TestDuplicateSheetNames( bool aCreateMarker );
+
+
+namespace {
+
+/**
+ * Struct ROOT_SHEET_SWITCHER
+ * makes a loaded hierarchy the current one, as the connectivity and the exporters
+ * reach it through g_RootSheet, and puts the previous one back when going out of scope.
+ */
+struct ROOT_SHEET_SWITCHER
+{
+    ROOT_SHEET_SWITCHER( SCH_SHEET* aRootSheet ) :
+        m_previous( g_RootSheet )
+    {
+        g_RootSheet = aRootSheet;
+    }
+
+    ~ROOT_SHEET_SWITCHER()
+    {
+        g_RootSheet = m_previous;
+    }
+
+    SCH_SHEET*  m_previous;
+};
+
+
+/**
+ * Function defaultOutputFile
+ * @return the file written for \a aJob when no output file is given: the schematic file
+ *  name with the extension of the format.  A plugin command gets it without extension,
+ *  as from the BOM dialog, the plugin adds the one of the file it writes.
+ */
+wxFileName defaultOutputFile( const wxFileName& aSchematicFile,
+                              const SCH_HEADLESS_EXPORT_JOB& aJob )
+{
+    wxFileName fn = aSchematicFile;
+
+    switch( aJob.m_Format )
+    {
+    case NET_TYPE_PCBNEW:
+    case NET_TYPE_ORCADPCB2:
+        fn.SetExt( NetlistFileExtension );
+        break;
+
+    case NET_TYPE_CADSTAR:
+        fn.SetExt( wxT( "frp" ) );
+        break;
+
+    case NET_TYPE_SPICE:
+        fn.SetExt( wxT( "cir" ) );
+        break;
+
+    default:
+        if( aJob.m_PluginCommand.IsEmpty() )
+            fn.SetExt( GENERIC_INTERMEDIATE_NETLIST_EXT );
+        else
+            fn.ClearExt();
+        break;
+    }
+
+    return fn;
+}
+
+} // namespace
+
+
+bool SchHeadlessExport( KIWAY* aKiway, SCH_HEADLESS_EXPORT_JOB& aJob, REPORTER& aReporter )
+{
+    wxString    msg;
+    wxFileName  schematicFile( aJob.m_SchematicFile );
+
+    schematicFile.MakeAbsolute();
+
+    if( !schematicFile.FileExists() )
+    {
+        msg.Printf( _( "Schematic file '%s' not found.\n" ),
+                    GetChars( schematicFile.GetFullPath() ) );
+        aReporter.Report( msg, REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    // Load stage: the project settings and libraries, then the hierarchy.
+    PROF_COUNTER timer;
+    PROJECT&     prj = aKiway->Prj();
+    wxFileName   pro = schematicFile;
+
+    pro.SetExt( ProjectFileExtension );
+    prj.SetProjectFullName( pro.GetFullPath() );
+    prj.SetElem( PROJECT::ELEM_SCH_PART_LIBS, NULL );
+
+    PART_LIBS* libs = prj.SchLibs();
+
+    std::unique_ptr<SCH_SHEET> rootSheet;
+
+    try
+    {
+        SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+
+        rootSheet.reset( pi->Load( schematicFile.GetFullPath(), aKiway ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        msg.Printf( _( "Error loading schematic file '%s'.\n%s\n" ),
+                    GetChars( schematicFile.GetFullPath() ), GetChars( ioe.What() ) );
+        aReporter.Report( msg, REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    aJob.m_LoadTime = timer.msecs();
+
+    // Connectivity stage: the same checks as SCH_EDIT_FRAME::prepareForNetlist(), except
+    // that nothing can be asked, so a missing annotation is an error and duplicate sheet
+    // names only a warning.
+    timer.Start();
+
+    ROOT_SHEET_SWITCHER rootSwitcher( rootSheet.get() );
+    SCH_SHEET_LIST      sheets( g_RootSheet );
+    SCH_REFERENCE_LIST  components;
+    wxArrayString       annotationErrors;
+
+    sheets.AnnotatePowerSymbols( libs );
+    sheets.GetComponents( libs, components );
+
+    if( components.CheckAnnotation( &annotationErrors ) )
+    {
+        for( unsigned ii = 0; ii < annotationErrors.GetCount(); ii++ )
+            aReporter.Report( annotationErrors[ii], REPORTER::RPT_ERROR );
+
+        aReporter.Report( _( "Exporting the netlist requires a completely annotated "
+                             "schematic.\n" ), REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    if( TestDuplicateSheetNames( false ) > 0 )
+        aReporter.Report( _( "Warning: duplicate sheet names.\n" ), REPORTER::RPT_WARNING );
+
+    SCH_SCREENS screens;
+
+    screens.SchematicCleanUp();
+
+    std::unique_ptr<NETLIST_OBJECT_LIST> connectivity( new NETLIST_OBJECT_LIST() );
+
+    connectivity->BuildNetListInfo( sheets );
+
+    aJob.m_ConnectivityTime = timer.msecs();
+
+    // Export stage: the same as SCH_EDIT_FRAME::WriteNetListFile().
+    timer.Start();
+
+    wxFileName outputFile = aJob.m_OutputFile.IsEmpty() ?
+                            defaultOutputFile( schematicFile, aJob ) :
+                            wxFileName( aJob.m_OutputFile );
+
+    outputFile.MakeAbsolute();
+
+    bool        runPlugin = NETLIST_EXPORTER::IsGenericFormat( aJob.m_Format )
+                            && !aJob.m_PluginCommand.IsEmpty();
+    wxFileName  netlistFile = outputFile;
+
+    if( runPlugin )
+        netlistFile.SetExt( GENERIC_INTERMEDIATE_NETLIST_EXT );
+
+    std::unique_ptr<NETLIST_EXPORTER> exporter(
+            NETLIST_EXPORTER::Create( aJob.m_Format, connectivity.release(), libs ) );
+
+    if( !exporter->WriteNetlist( netlistFile.GetFullPath(), aJob.m_NetlistOptions ) )
+    {
+        msg.Printf( _( "Failed to create file '%s'.\n" ),
+                    GetChars( netlistFile.GetFullPath() ) );
+        aReporter.Report( msg, REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    if( runPlugin )
+    {
+        wxString prj_dir = prj.GetProjectPath();
+        wxString commandLine = NETLIST_EXPORTER::MakeCommandLine( aJob.m_PluginCommand,
+                netlistFile.GetFullPath(), outputFile.GetFullPath(),
+                prj_dir.SubString( 0, prj_dir.Len() - 2 )       // strip trailing '/'
+                );
+
+        wxArrayString output, errors;
+        int           diag = wxExecute( commandLine, output, errors, wxEXEC_SYNC );
+
+        msg.Printf( _( "Run command: %s\n" ), GetChars( commandLine ) );
+        aReporter.Report( msg, REPORTER::RPT_ACTION );
+
+        for( unsigned ii = 0; ii < output.GetCount(); ii++ )
+            aReporter.Report( output[ii] + wxT( "\n" ), REPORTER::RPT_INFO );
+
+        for( unsigned ii = 0; ii < errors.GetCount(); ii++ )
+            aReporter.Report( errors[ii] + wxT( "\n" ), REPORTER::RPT_ERROR );
+
+        if( diag != 0 )
+        {
+            msg.Printf( _( "Command error. Return code %d\n" ), diag );
+            aReporter.Report( msg, REPORTER::RPT_ERROR );
+            return false;
+        }
+    }
+
+    aJob.m_ExportTime = timer.msecs();
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SCH_HEADLESS_EXPORT_H
+#define SCH_HEADLESS_EXPORT_H
+
+#include <wx/string.h>
+
+class KIWAY;
+class REPORTER;
+
+
+/**
+ * Id of the headless export entry point, to give to KIFACE::IfaceOrAddress() of the
+ * eeschema KIFACE.  The returned address is a SCH_HEADLESS_EXPORT_FUNC*.
+ */
+#define KIFACE_ADDR_SCH_HEADLESS_EXPORT     1
+
+
+/**
+ * Struct SCH_HEADLESS_EXPORT_JOB
+ * describes one schematic to export without a SCH_EDIT_FRAME, and receives the time
+ * spent in each stage of the export.
+ */
+struct SCH_HEADLESS_EXPORT_JOB
+{
+    SCH_HEADLESS_EXPORT_JOB() :
+        m_Format( 0 ),
+        m_NetlistOptions( 0 ),
+        m_LoadTime( 0.0 ),
+        m_ConnectivityTime( 0.0 ),
+        m_ExportTime( 0.0 )
+    {
+    }
+
+    wxString    m_SchematicFile;        ///< the root sheet file of the project
+    wxString    m_OutputFile;           ///< empty to derive it from m_SchematicFile
+    int         m_Format;               ///< one of NETLIST_TYPE_ID
+    unsigned    m_NetlistOptions;       ///< given to NETLIST_EXPORTER::WriteNetlist()
+
+    /// Command line turning the generic netlist into the final file (a netlist or a BOM
+    /// plugin), see NETLIST_EXPORTER::MakeCommandLine().  Only used by the generic format.
+    wxString    m_PluginCommand;
+
+    double      m_LoadTime;             ///< loading the libraries and the hierarchy, in ms
+    double      m_ConnectivityTime;     ///< checking and building the connectivity, in ms
+    double      m_ExportTime;           ///< writing the file and running the plugin, in ms
+};
+
+
+/**
+ * Function SchHeadlessExport
+ * loads the schematic of \a aJob through SCH_IO_MGR, builds its connectivity and writes
+ * it with the exporter of the requested format, without creating any window.
+ *
+ * The project of \a aKiway is switched to the one of the schematic, and g_RootSheet is
+ * only borrowed for the duration of the call, so this must not run while a schematic
+ * editor is open in the same process, nor on several threads at once.  Projects are
+ * exported concurrently by running one process for each of them.
+ *
+ * @param aKiway gives the PROJECT, its libraries are loaded from the project file.
+ * @param aJob gives the files and the format, and receives the stage timings.
+ * @param aReporter receives the progress and the error messages.
+ * @return bool - true if the output file was written.
+ */
+bool SchHeadlessExport( KIWAY* aKiway, SCH_HEADLESS_EXPORT_JOB& aJob, REPORTER& aReporter );
+
+typedef bool SCH_HEADLESS_EXPORT_FUNC( KIWAY* aKiway, SCH_HEADLESS_EXPORT_JOB& aJob,
+                                       REPORTER& aReporter );
+
+#endif  // SCH_HEADLESS_EXPORT_H
@@ -294,6 +294,19 @@ public:
     // Temporary for testing using PART_LIB instead of SCH_PLUGIN.
     virtual void TransferCache( PART_LIB& aTarget );
 
+    /**
+     * Function TransferSymbol
+     *
+     * moves the #LIB_PART having the alias @a aAliasName, and all its other aliases,
+     * from the library last enumerated by EnumerateSymbolLib() to @a aTarget.  The part is
+     * parsed first if needed, so PART_LIB can load its parts on demand.
+     *
+     * @return the alias now owned by @a aTarget, or NULL if the library has no such alias.
+     *
+     * @throw IO_ERROR if the part cannot be parsed.
+     */
+    virtual LIB_ALIAS* TransferSymbol( PART_LIB& aTarget, const wxString& aAliasName );
+
     /**
      * Function LoadSymbol
      *
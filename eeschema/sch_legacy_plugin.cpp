@@ -22,10 +22,12 @@
 
 #include <ctype.h>
 #include <algorithm>
+#include <functional>
 
 #include <wx/mstream.h>
 #include <wx/filename.h>
 #include <wx/tokenzr.h>
+#include <wx/stdpaths.h>
 
 #include <drawtxt.h>
 #include <kiway.h>
@@ -1468,6 +1470,8 @@ void SCH_LEGACY_PLUGIN::Save( const wxString& aFileName, SCH_SCREEN* aScreen, KI
     m_out = &formatter;     // no ownership
 
     Format( aScreen );
+
+    formatter.Finish();
 }
 
 
@@ -1933,6 +1937,40 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
+    /// Where a part definition starts in the library file.  Parts are only parsed
+    /// when one of their aliases is requested, see findAlias().
+    struct PART_INDEX
+    {
+        long        m_offset;       // File offset of the DEF line.
+        int         m_lineNumber;   // Line number of the DEF line, for error messages.
+        bool        m_loaded;
+    };
+
+    /// Document file entries of aliases whose part has not been parsed yet.
+    struct ALIAS_DOC
+    {
+        wxString    m_description;
+        wxString    m_keyWords;
+        wxString    m_docFileName;
+    };
+
+    typedef std::map< wxString, size_t, AliasMapSort >     ALIAS_INDEX_MAP;
+    typedef std::map< wxString, ALIAS_DOC, AliasMapSort >  ALIAS_DOC_MAP;
+
+    std::vector< PART_INDEX >   m_index;
+    ALIAS_INDEX_MAP m_indexedAliases;   // All alias names in the file, to their m_index entry.
+    ALIAS_DOC_MAP   m_docs;
+    bool            m_isLazy;           // Some of the parts in m_index are not parsed yet.
+
+    bool            indexPart( FILE_LINE_READER& aReader, long aOffset );
+    void            loadIndexedPart( FILE* aFile, size_t aIndex );
+    void            loadAllParts();
+    LIB_ALIAS*      findAlias( const wxString& aAliasName );
+    wxFileName      getIndexFileName() const;
+    wxString        getFileStamp() const;
+    bool            readIndex();
+    void            writeIndex();
+
     LIB_PART*       loadPart( FILE_LINE_READER& aReader );
     void            loadHeader( FILE_LINE_READER& aReader );
     void            loadAliases( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
@@ -1970,6 +2008,13 @@ public:
     /// Save the entire library to file m_libFileName;
     void Save();
 
+    /**
+     * Function Load
+     * indexes the part definitions of the library file and its aliases.  The parts
+     * themselves are parsed on demand by findAlias(), or all at once by loadAllParts()
+     * when the whole library is needed.  The index is saved in the user cache directory
+     * so an unchanged library file is not scanned again.
+     */
     void Load();
 
     void AddSymbol( const LIB_PART* aPart );
@@ -1992,7 +2037,8 @@ SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFi
     m_libFileName( aFullPathAndFileName ),
     m_isWritable( true ),
     m_isModified( false ),
-    m_modHash( 1 )
+    m_modHash( 1 ),
+    m_isLazy( false )
 {
     m_versionMajor = -1;
     m_versionMinor = -1;
@@ -2088,6 +2134,8 @@ LIB_ALIAS* SCH_LEGACY_PLUGIN_CACHE::removeAlias( LIB_ALIAS* aAlias )
 
 void SCH_LEGACY_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
+    loadAllParts();
+
     // Ugly hack to fix the fact that the LIB_PART copy constructor doesn't take a const
     // reference.  I feel all dirty inside doing this.
     // @todo: fix LIB_PART copy ctor so it can take a const reference.
@@ -2117,10 +2165,18 @@ void SCH_LEGACY_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 
 void SCH_LEGACY_PLUGIN_CACHE::Load()
 {
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
-
     wxCHECK_RET( m_libFileName.IsAbsolute(), "Cannot use relative file paths in legacy plugin." );
 
+    // The file is opened here rather than by the reader so the part definitions can be
+    // located with ftell().
+    FILE* fp = wxFopen( m_libFileName.GetFullPath(), wxT( "rt" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename '%s' for reading" ),
+                                          m_libFileName.GetFullPath() ) );
+
+    FILE_LINE_READER reader( fp, m_libFileName.GetFullPath() );
+
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
 
@@ -2160,25 +2216,51 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         m_libType = LIBRARY_TYPE_EESCHEMA;
     }
 
-    while( reader.ReadLine() )
-    {
-        line = reader.Line();
+    m_index.clear();
+    m_indexedAliases.clear();
+    m_docs.clear();
 
-        if( *line == '#' || isspace( *line ) )  // Skip comments and blank lines.
-            continue;
+    bool hasDuplicates = false;
 
-        // Headers where only supported in older library file formats.
-        if( m_libType == LIBRARY_TYPE_EESCHEMA && strCompare( "$HEADER", line ) )
-            loadHeader( reader );
+    if( !readIndex() )
+    {
+        long offset = ftell( fp );
 
-        if( strCompare( "DEF", line ) )
+        while( reader.ReadLine() )
         {
-            // Read one DEF/ENDDEF part entry from library:
-            loadPart( reader );
+            line = reader.Line();
+
+            if( *line == '#' || isspace( *line ) )  // Skip comments and blank lines.
+            {
+                offset = ftell( fp );
+                continue;
+            }
+
+            // Headers where only supported in older library file formats.
+            if( m_libType == LIBRARY_TYPE_EESCHEMA && strCompare( "$HEADER", line ) )
+                loadHeader( reader );
 
+            if( strCompare( "DEF", line ) )
+            {
+                // Index one DEF/ENDDEF part entry from library:
+                if( indexPart( reader, offset ) )
+                    hasDuplicates = true;
+            }
+
+            offset = ftell( fp );
         }
+
+        // Broken libraries with duplicate alias names get the duplicates renamed while
+        // parsing, in file order, which cannot be done part by part.
+        if( !hasDuplicates )
+            writeIndex();
     }
 
+    m_isLazy = true;
+
+    if( hasDuplicates )
+        loadAllParts();
+
     ++m_modHash;
 
     // Remember the file modification time of library file when the
@@ -2191,6 +2273,322 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 }
 
 
+bool SCH_LEGACY_PLUGIN_CACHE::indexPart( FILE_LINE_READER& aReader, long aOffset )
+{
+    const char* line = aReader.Line();
+
+    wxCHECK( strCompare( "DEF", line, &line ), false );
+
+    PART_INDEX  entry = { aOffset, aReader.LineNumber(), false };
+    size_t      index = m_index.size();
+    bool        hasDuplicates = false;
+    wxString    name;
+
+    m_index.push_back( entry );
+
+    // The root alias name, mangled the same way as in loadPart().
+    parseUnquotedString( name, aReader, line, &line );
+
+    if( name[0] == '~' )
+        name = name.Right( name.Length() - 1 );
+
+    if( !m_indexedAliases.insert( std::make_pair( name, index ) ).second )
+        hasDuplicates = true;
+
+    while( ( line = aReader.ReadLine() ) != NULL )
+    {
+        if( strCompare( "ALIAS", line, &line ) )
+        {
+            wxString alias;
+            parseUnquotedString( alias, aReader, line, &line );
+
+            while( !alias.IsEmpty() )
+            {
+                if( !m_indexedAliases.insert( std::make_pair( alias, index ) ).second )
+                    hasDuplicates = true;
+
+                alias.clear();
+                parseUnquotedString( alias, aReader, line, &line, true );
+            }
+        }
+        else if( strCompare( "ENDDEF", line, &line ) )
+        {
+            return hasDuplicates;
+        }
+    }
+
+    SCH_PARSE_ERROR( "missing ENDDEF", aReader, line );
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadIndexedPart( FILE* aFile, size_t aIndex )
+{
+    PART_INDEX& entry = m_index[ aIndex ];
+
+    if( entry.m_loaded )
+        return;
+
+    if( fseek( aFile, entry.m_offset, SEEK_SET ) )
+        THROW_IO_ERROR( wxString::Format( _( "cannot seek in library file '%s'" ),
+                                          m_libFileName.GetFullPath() ) );
+
+    FILE_LINE_READER reader( aFile, m_libFileName.GetFullPath(), false,
+                             entry.m_lineNumber - 1 );
+
+    if( !reader.ReadLine() || !strCompare( "DEF", reader.Line() ) )
+        SCH_PARSE_ERROR( "library file changed while reading it", reader, reader.Line() );
+
+    LIB_PART* part = loadPart( reader );
+    entry.m_loaded = true;
+
+    wxLogTrace( traceSchLegacyPlugin, wxT( "Loaded symbol %s from library %s." ),
+                GetChars( part->GetName() ), GetChars( GetLogicalName() ) );
+
+    if( m_docs.empty() )
+        return;
+
+    for( size_t i = 0;  i < part->GetAliasCount();  i++ )
+    {
+        LIB_ALIAS*              alias = part->GetAlias( i );
+        ALIAS_DOC_MAP::iterator it = m_docs.find( alias->GetName() );
+
+        if( it == m_docs.end() )
+            continue;
+
+        alias->SetDescription( it->second.m_description );
+        alias->SetKeyWords( it->second.m_keyWords );
+        alias->SetDocFileName( it->second.m_docFileName );
+        m_docs.erase( it );
+    }
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadAllParts()
+{
+    if( !m_isLazy )
+        return;
+
+    FILE* fp = wxFopen( m_libFileName.GetFullPath(), wxT( "rt" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename '%s' for reading" ),
+                                          m_libFileName.GetFullPath() ) );
+
+    // Only used to close the file.
+    FILE_LINE_READER closer( fp, m_libFileName.GetFullPath() );
+
+    for( size_t i = 0;  i < m_index.size();  i++ )
+        loadIndexedPart( fp, i );
+
+    m_isLazy = false;
+    m_index.clear();
+    m_indexedAliases.clear();
+    m_docs.clear();
+}
+
+
+LIB_ALIAS* SCH_LEGACY_PLUGIN_CACHE::findAlias( const wxString& aAliasName )
+{
+    LIB_ALIAS_MAP::const_iterator it = m_aliases.find( aAliasName );
+
+    if( it != m_aliases.end() )
+        return it->second;
+
+    if( !m_isLazy )
+        return NULL;
+
+    ALIAS_INDEX_MAP::const_iterator indexed = m_indexedAliases.find( aAliasName );
+
+    if( indexed == m_indexedAliases.end() || m_index[ indexed->second ].m_loaded )
+        return NULL;
+
+    FILE* fp = wxFopen( m_libFileName.GetFullPath(), wxT( "rt" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename '%s' for reading" ),
+                                          m_libFileName.GetFullPath() ) );
+
+    FILE_LINE_READER closer( fp, m_libFileName.GetFullPath() );
+
+    loadIndexedPart( fp, indexed->second );
+
+    it = m_aliases.find( aAliasName );
+
+    return it != m_aliases.end() ? it->second : NULL;
+}
+
+
+wxFileName SCH_LEGACY_PLUGIN_CACHE::getIndexFileName() const
+{
+    // Library indices go to the user's cache directory, the library folder may not
+    // be writable:
+    //
+    // 1. OSX: ~/Library/Caches/kicad/symbols/
+    // 2. Linux: ${XDG_CACHE_HOME}/kicad/symbols/ or ~/.cache/kicad/symbols/
+    // 3. MSWin: AppData\Local\kicad\symbols
+    wxString cacheDir;
+
+#if defined( __WINDOWS__ )
+    cacheDir = wxStandardPaths::Get().GetUserLocalDataDir() + "\\kicad\\symbols";
+#elif defined( __WXMAC__ )
+    cacheDir = ExpandEnvVarSubstitutions( "${HOME}/Library/Caches/kicad/symbols" );
+#else
+    cacheDir = ExpandEnvVarSubstitutions( "${XDG_CACHE_HOME}" );
+
+    if( cacheDir.IsEmpty() || cacheDir == "${XDG_CACHE_HOME}" )
+        cacheDir = ExpandEnvVarSubstitutions( "${HOME}/.cache" );
+
+    cacheDir += "/kicad/symbols";
+#endif
+
+    // The library path is hashed so libraries with the same name do not collide.
+    std::string path = TO_UTF8( m_libFileName.GetFullPath() );
+    unsigned long long hash = std::hash< std::string >()( path );
+
+    return wxFileName( cacheDir, wxString::Format( "%s-%016llx.idx",
+                                                   m_libFileName.GetName(), hash ) );
+}
+
+
+wxString SCH_LEGACY_PLUGIN_CACHE::getFileStamp() const
+{
+    // Modification times have a resolution of one second on some file systems, so a
+    // library rewritten with the same size within a second is told apart by the hash
+    // (FNV-1a) of its content.  Hashing is much cheaper than parsing the library.
+    unsigned long long hash = 14695981039346656037ULL;
+    FILE* fp = wxFopen( m_libFileName.GetFullPath(), wxT( "rb" ) );
+
+    if( fp )
+    {
+        std::vector< unsigned char > buffer( 65536 );
+        size_t count;
+
+        while( ( count = fread( &buffer[0], 1, buffer.size(), fp ) ) > 0 )
+        {
+            for( size_t i = 0;  i < count;  i++ )
+            {
+                hash ^= buffer[i];
+                hash *= 1099511628211ULL;
+            }
+        }
+
+        fclose( fp );
+    }
+
+    return wxString::Format( "FILE %lld %llu %016llx",
+            (long long) m_libFileName.GetModificationTime().GetValue().GetValue(),
+            (unsigned long long) m_libFileName.GetSize().GetValue(), hash );
+}
+
+
+#define LIB_INDEX_IDENT "EESchema-LIBRARY-INDEX 2"
+
+
+bool SCH_LEGACY_PLUGIN_CACHE::readIndex()
+{
+    wxFileName fn = getIndexFileName();
+
+    if( !fn.FileExists() )
+        return false;
+
+    try
+    {
+        FILE_LINE_READER reader( fn.GetFullPath() );
+        const char* line = reader.ReadLine();
+
+        if( !line || !strCompare( LIB_INDEX_IDENT, line ) )
+            return false;
+
+        // The index is only valid for the library file it was made from.
+        line = reader.ReadLine();
+
+        if( !line || FROM_UTF8( line ).Trim() != getFileStamp() )
+            return false;
+
+        while( ( line = reader.ReadLine() ) != NULL )
+        {
+            if( strCompare( "END", line ) )
+            {
+                wxLogTrace( traceSchLegacyPlugin, wxT( "Read index of library %s from %s." ),
+                            GetChars( GetLogicalName() ), GetChars( fn.GetFullPath() ) );
+                return true;
+            }
+
+            if( !strCompare( "DEF", line, &line ) )
+                break;
+
+            PART_INDEX  entry;
+            wxString    alias;
+
+            entry.m_offset = parseInt( reader, line, &line );
+            entry.m_lineNumber = parseInt( reader, line, &line );
+            entry.m_loaded = false;
+            m_index.push_back( entry );
+
+            parseUnquotedString( alias, reader, line, &line );
+
+            while( !alias.IsEmpty() )
+            {
+                m_indexedAliases[ alias ] = m_index.size() - 1;
+                alias.clear();
+                parseUnquotedString( alias, reader, line, &line, true );
+            }
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+    }
+
+    // A broken index file is not an error, the library file gets scanned again.
+    m_index.clear();
+    m_indexedAliases.clear();
+    return false;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::writeIndex()
+{
+    wxFileName fn = getIndexFileName();
+
+    if( !fn.DirExists() && !fn.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return;
+
+    // Group the alias names by part, in file order.
+    std::vector< wxArrayString > aliases( m_index.size() );
+
+    for( ALIAS_INDEX_MAP::const_iterator it = m_indexedAliases.begin();
+         it != m_indexedAliases.end();  ++it )
+        aliases[ it->second ].Add( it->first );
+
+    try
+    {
+        FILE_OUTPUTFORMATTER formatter( fn.GetFullPath() );
+
+        formatter.Print( 0, "%s\n", LIB_INDEX_IDENT );
+        formatter.Print( 0, "%s\n", TO_UTF8( getFileStamp() ) );
+
+        for( size_t i = 0;  i < m_index.size();  i++ )
+        {
+            formatter.Print( 0, "DEF %ld %d", m_index[i].m_offset, m_index[i].m_lineNumber );
+
+            for( size_t j = 0;  j < aliases[i].size();  j++ )
+                formatter.Print( 0, " %s", TO_UTF8( aliases[i][j] ) );
+
+            formatter.Print( 0, "\n" );
+        }
+
+        formatter.Print( 0, "END\n" );
+        formatter.Finish();
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        // Not fatal, the library is scanned again next time.
+        wxLogTrace( traceSchLegacyPlugin, wxT( "Cannot write library index %s: %s" ),
+                    GetChars( fn.GetFullPath() ), GetChars( ioe.What() ) );
+    }
+}
+
+
 void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 {
     const char* line;
@@ -2233,15 +2631,18 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
         parseUnquotedString( aliasName, reader, line, &line );    // Alias name.
 
         LIB_ALIAS_MAP::iterator it = m_aliases.find( aliasName );
+        ALIAS_DOC*  doc = NULL;
 
-        if( it == m_aliases.end() )
+        if( it != m_aliases.end() )
+            alias = it->second;
+        else if( m_isLazy && m_indexedAliases.count( aliasName ) )
+            doc = &m_docs[ aliasName ];     // Applied when the part gets loaded.
+        else
             wxLogWarning( "Alias '%s' not found in library:\n\n"
                           "'%s'\n\nat line %d offset %d", aliasName, fn.GetFullPath(),
                           reader.LineNumber(), (int) (line - reader.Line() ) );
-        else
-            alias = it->second;
 
-        if( alias )
+        if( alias || doc )
         {
             while( reader.ReadLine() )
             {
@@ -2259,15 +2660,24 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
                 switch( line[0] )
                 {
                 case 'D':
-                    alias->SetDescription( text );
+                    if( doc )
+                        doc->m_description = text;
+                    else
+                        alias->SetDescription( text );
                     break;
 
                 case 'K':
-                    alias->SetKeyWords( text );
+                    if( doc )
+                        doc->m_keyWords = text;
+                    else
+                        alias->SetKeyWords( text );
                     break;
 
                 case 'F':
-                    alias->SetDocFileName( text );
+                    if( doc )
+                        doc->m_docFileName = text;
+                    else
+                        alias->SetDocFileName( text );
                     break;
 
                 case '#':
@@ -3227,6 +3637,8 @@ void SCH_LEGACY_PLUGIN_CACHE::Save()
     if( !m_isModified )
         return;
 
+    loadAllParts();
+
     FILE_OUTPUTFORMATTER formatter( m_libFileName.GetFullPath() );
     formatter.Print( 0, "%s %d.%d\n", LIBFILE_IDENT, LIB_VERSION_MAJOR, LIB_VERSION_MINOR );
     formatter.Print( 0, "#encoding utf-8\n");
@@ -3240,6 +3652,8 @@ void SCH_LEGACY_PLUGIN_CACHE::Save()
     }
 
     formatter.Print( 0, "#\n#End Library\n" );
+    formatter.Finish();
+
     m_fileModTime = m_libFileName.GetModificationTime();
     m_isModified = false;
 }
@@ -3247,6 +3661,8 @@ void SCH_LEGACY_PLUGIN_CACHE::Save()
 
 void SCH_LEGACY_PLUGIN_CACHE::DeleteAlias( const wxString& aAliasName )
 {
+    loadAllParts();
+
     LIB_ALIAS_MAP::iterator it = m_aliases.find( aAliasName );
 
     if( it == m_aliases.end() )
@@ -3282,6 +3698,8 @@ void SCH_LEGACY_PLUGIN_CACHE::DeleteAlias( const wxString& aAliasName )
 
 void SCH_LEGACY_PLUGIN_CACHE::DeleteSymbol( const wxString& aAliasName )
 {
+    loadAllParts();
+
     LIB_ALIAS_MAP::iterator it = m_aliases.find( aAliasName );
 
     if( it == m_aliases.end() )
@@ -3331,6 +3749,18 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aAliasNameList,
 
     cacheLib( aLibraryPath );
 
+    // Listing the names does not need the parts to be parsed.
+    if( m_cache->m_isLazy )
+    {
+        const SCH_LEGACY_PLUGIN_CACHE::ALIAS_INDEX_MAP& aliases = m_cache->m_indexedAliases;
+
+        for( SCH_LEGACY_PLUGIN_CACHE::ALIAS_INDEX_MAP::const_iterator it = aliases.begin();
+             it != aliases.end();  ++it )
+            aAliasNameList.Add( it->first );
+
+        return;
+    }
+
     const LIB_ALIAS_MAP& aliases = m_cache->m_aliases;
 
     for( LIB_ALIAS_MAP::const_iterator it = aliases.begin();  it != aliases.end();  ++it )
@@ -3340,6 +3770,9 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aAliasNameList,
 
 void SCH_LEGACY_PLUGIN::TransferCache( PART_LIB& aTarget )
 {
+    // PART_LIB holds the parts themselves so the whole library is parsed here.
+    m_cache->loadAllParts();
+
     aTarget.m_amap = m_cache->m_aliases;
 
     for( LIB_ALIAS_MAP::iterator it = aTarget.m_amap.begin();  it != aTarget.m_amap.end();  ++it )
@@ -3356,6 +3789,37 @@ void SCH_LEGACY_PLUGIN::TransferCache( PART_LIB& aTarget )
 }
 
 
+LIB_ALIAS* SCH_LEGACY_PLUGIN::TransferSymbol( PART_LIB& aTarget, const wxString& aAliasName )
+{
+    LOCALE_IO toggle;     // toggles on, then off, the C locale.
+
+    wxCHECK_MSG( m_cache, NULL, "No library was enumerated before transferring a symbol." );
+
+    aTarget.type = m_cache->m_libType;
+    aTarget.versionMajor = m_cache->m_versionMajor;
+    aTarget.versionMinor = m_cache->m_versionMinor;
+
+    LIB_ALIAS* alias = m_cache->findAlias( aAliasName );
+
+    if( !alias )
+        return NULL;
+
+    LIB_PART* part = alias->GetPart();
+
+    for( size_t i = 0;  i < part->GetAliasCount();  i++ )
+    {
+        LIB_ALIAS* partAlias = part->GetAlias( i );
+
+        m_cache->m_aliases.erase( partAlias->GetName() );
+        aTarget.m_amap[ partAlias->GetName() ] = partAlias;
+    }
+
+    part->SetLib( &aTarget );
+
+    return alias;
+}
+
+
 LIB_ALIAS* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                                           const PROPERTIES* aProperties )
 {
@@ -3365,12 +3829,7 @@ LIB_ALIAS* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wx
 
     cacheLib( aLibraryPath );
 
-    LIB_ALIAS_MAP::const_iterator it = m_cache->m_aliases.find( TO_UTF8( aAliasName ) );
-
-    if( it == m_cache->m_aliases.end() )
-        return NULL;
-
-    return it->second;
+    return m_cache->findAlias( aAliasName );
 }
 
 
@@ -103,6 +103,7 @@ public:
 
     // Temporary for testing using PART_LIB instead of SCH_PLUGIN.
     void TransferCache( PART_LIB& aTarget ) override;
+    LIB_ALIAS* TransferSymbol( PART_LIB& aTarget, const wxString& aAliasName ) override;
 
 private:
     void loadHierarchy( SCH_SHEET* aSheet );
@@ -73,6 +73,14 @@ void SCH_PLUGIN::TransferCache( PART_LIB& aTarget )
 }
 
 
+LIB_ALIAS* SCH_PLUGIN::TransferSymbol( PART_LIB& aTarget, const wxString& aAliasName )
+{
+    // not pure virtual so that plugins only have to implement subset of the SCH_PLUGIN interface.
+    not_implemented( this, __FUNCTION__ );
+    return NULL;
+}
+
+
 LIB_ALIAS* SCH_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aSymbolName,
                                    const PROPERTIES* aProperties )
 {
@@ -328,10 +328,12 @@ public:
      * <li>Time stamp.</li>
      * </ul>
      * </p>
+     * @param aNewOnly Set to true to sort only the references not annotated yet.  The
+     *                 annotated ones are moved ahead of them, in their current order.
      */
-    void SortByXCoordinate()
+    void SortByXCoordinate( bool aNewOnly = false )
     {
-        sort( componentFlatList.begin(), componentFlatList.end(), sortByXPosition );
+        sort( partitionNew( aNewOnly ), componentFlatList.end(), sortByXPosition );
     }
 
     /**
@@ -347,10 +349,12 @@ public:
      * <li>Time stamp.</li>
      * </ul>
      * </p>
+     * @param aNewOnly Set to true to sort only the references not annotated yet.  The
+     *                 annotated ones are moved ahead of them, in their current order.
      */
-    void SortByYCoordinate()
+    void SortByYCoordinate( bool aNewOnly = false )
     {
-        sort( componentFlatList.begin(), componentFlatList.end(), sortByYPosition );
+        sort( partitionNew( aNewOnly ), componentFlatList.end(), sortByYPosition );
     }
 
     /**
@@ -471,6 +475,15 @@ private:
 
     static bool sortByReferenceOnly( const SCH_REFERENCE& item1, const SCH_REFERENCE& item2 );
 
+    /**
+     * Function partitionNew
+     * moves the annotated references ahead of the references to annotate, which includes
+     * the ones with an invisible reference designator, when \a aPartition is true.
+     * @return The first reference to sort: the first one to annotate when \a aPartition
+     *         is true, otherwise the beginning of the list.
+     */
+    std::vector<SCH_REFERENCE>::iterator partitionNew( bool aPartition );
+
     /**
      * Function CreateFirstFreeRefId
      * searches for the first free reference number in \a aListId of reference numbers in use.
@@ -53,10 +53,136 @@
 #include <sch_component.h>
 #include <sch_text.h>
 #include <lib_pin.h>
+#include <geometry/rtree.h>
+
+#include <algorithm>
+#include <unordered_map>
 
 
 #define EESCHEMA_FILE_STAMP   "EESchema"
 
+
+/**
+ * R-trees of connection points, used to find the items connected at a position without
+ * testing all the items of the screen.  They are built by the operations which test the
+ * connections of many items (TestDanglingEnds(), GetConnection()), because items can be
+ * moved without the screen being notified.  Single lookups use the SCH_POSITION_INDEX of
+ * the screen instead, which is checked against the change stamp of the screen.
+ */
+typedef RTree<int, int, 2, double>          END_POINT_TREE;   // indexes of DANGLING_END_ITEMs
+typedef RTree<SCH_ITEM*, int, 2, double>    ITEM_TREE;
+
+
+static void insertInTree( ITEM_TREE& aTree, SCH_ITEM* aItem, const wxPoint& aStart,
+                          const wxPoint& aEnd )
+{
+    const int mmin[2] = { std::min( aStart.x, aEnd.x ), std::min( aStart.y, aEnd.y ) };
+    const int mmax[2] = { std::max( aStart.x, aEnd.x ), std::max( aStart.y, aEnd.y ) };
+
+    aTree.Insert( mmin, mmax, aItem );
+}
+
+
+/**
+ * Class SCH_POSITION_INDEX
+ * indexes the items of a screen by their bounding boxes, and the connection points of the
+ * component pins by position, so GetItem() and GetPin() do not have to test all the items
+ * of the screen for each position.
+ */
+class SCH_POSITION_INDEX
+{
+public:
+    struct PIN_REF
+    {
+        SCH_COMPONENT*  m_Component;
+        LIB_PIN*        m_Pin;
+    };
+
+    struct POINT_HASH
+    {
+        size_t operator()( const wxPoint& aPoint ) const
+        {
+            return std::hash<int>()( aPoint.x ) ^ ( std::hash<int>()( aPoint.y ) * 31 );
+        }
+    };
+
+    typedef std::unordered_map< wxPoint, std::vector<PIN_REF>, POINT_HASH > PIN_MAP;
+
+    SCH_POSITION_INDEX() :
+        m_ChangeStamp( 0 ),
+        m_LibsHash( 0 ),
+        m_Valid( false )
+    {
+    }
+
+    unsigned                    m_ChangeStamp;  ///< Change stamp of the screen when built.
+    int                         m_LibsHash;     ///< PART_LIBS::GetModifyHash() when built.
+    bool                        m_Valid;
+
+    std::vector<SCH_ITEM*>      m_Items;        ///< Items in draw list order.
+    RTree<int, int, 2, double>  m_Tree;         ///< Indexes in m_Items, by bounding box.
+    std::vector<int>            m_Unindexed;    ///< Indexes in m_Items always to be tested.
+    PIN_MAP                     m_PinEnds;      ///< Pins by connection point.
+};
+
+
+// Slack added to the boxes of the index, for hit tests which slightly exceed the bounding
+// box of the item they test (pen widths, pin texts).
+#define POSITION_INDEX_SLACK    50
+
+
+// Returns the item hit by GetItem() when testing aItem, or NULL.
+static SCH_ITEM* hitTestItem( SCH_ITEM* aItem, const wxPoint& aPosition, int aAccuracy,
+                              KICAD_T aType )
+{
+    if( aItem->HitTest( aPosition, aAccuracy ) && (aType == NOT_USED) )
+        return aItem;
+
+    if( (aType == SCH_FIELD_T) && (aItem->Type() == SCH_COMPONENT_T) )
+    {
+        SCH_COMPONENT* component = (SCH_COMPONENT*) aItem;
+
+        for( int i = REFERENCE; i < component->GetFieldCount(); i++ )
+        {
+            SCH_FIELD* field = component->GetField( i );
+
+            if( field->HitTest( aPosition, aAccuracy ) )
+                return (SCH_ITEM*) field;
+        }
+    }
+    else if( (aType == SCH_SHEET_PIN_T) && (aItem->Type() == SCH_SHEET_T) )
+    {
+        SCH_SHEET* sheet = (SCH_SHEET*) aItem;
+
+        SCH_SHEET_PIN* label = sheet->GetPin( aPosition );
+
+        if( label )
+            return (SCH_ITEM*) label;
+    }
+    else if( (aItem->Type() == aType) && aItem->HitTest( aPosition, aAccuracy ) )
+    {
+        return aItem;
+    }
+
+    return NULL;
+}
+
+
+// Returns true if aPin is used by the unit and the body style of aComponent.
+static bool isPinUsed( SCH_COMPONENT* aComponent, LIB_PIN* aPin )
+{
+    if( aComponent->GetUnit() && aPin->GetUnit() &&
+        ( aPin->GetUnit() != aComponent->GetUnit() ) )
+        return false;
+
+    if( aComponent->GetConvert() && aPin->GetConvert() &&
+        ( aPin->GetConvert() != aComponent->GetConvert() ) )
+        return false;
+
+    return true;
+}
+
+
 /* Default zoom values. Limited to these values to keep a decent size
  * to menus
  */
@@ -98,6 +224,7 @@ SCH_SCREEN::SCH_SCREEN( KIWAY* aKiway ) :
     m_paper( wxT( "A4" ) )
 {
     m_modification_sync = 0;
+    m_positionIndex = NULL;
 
     SetZoom( 32 );
 
@@ -121,6 +248,7 @@ SCH_SCREEN::~SCH_SCREEN()
 {
     ClearUndoRedoList();
     FreeDrawList();
+    delete m_positionIndex;
 }
 
 
@@ -152,12 +280,14 @@ void SCH_SCREEN::Clear()
 void SCH_SCREEN::FreeDrawList()
 {
     m_drawList.DeleteAll();
+    UpdateChangeStamp();
 }
 
 
 void SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     m_drawList.Remove( aItem );
+    UpdateChangeStamp();
 }
 
 
@@ -202,36 +332,39 @@ bool SCH_SCREEN::CheckIfOnDrawList( SCH_ITEM* aItem )
 
 SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T aType ) const
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
-    {
-        if( item->HitTest( aPosition, aAccuracy ) && (aType == NOT_USED) )
-            return item;
+    SCH_POSITION_INDEX* index = getPositionIndex();
 
-        if( (aType == SCH_FIELD_T) && (item->Type() == SCH_COMPONENT_T) )
+    if( !index )
+    {
+        for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
         {
-            SCH_COMPONENT* component = (SCH_COMPONENT*) item;
+            if( SCH_ITEM* found = hitTestItem( item, aPosition, aAccuracy, aType ) )
+                return found;
+        }
 
-            for( int i = REFERENCE; i < component->GetFieldCount(); i++ )
-            {
-                SCH_FIELD* field = component->GetField( i );
+        return NULL;
+    }
 
-                if( field->HitTest( aPosition, aAccuracy ) )
-                    return (SCH_ITEM*) field;
-            }
-        }
-        else if( (aType == SCH_SHEET_PIN_T) && (item->Type() == SCH_SHEET_T) )
-        {
-            SCH_SHEET* sheet = (SCH_SHEET*)item;
+    std::vector<int> candidates = index->m_Unindexed;
 
-            SCH_SHEET_PIN* label = sheet->GetPin( aPosition );
+    auto collect = [&candidates]( int aIndex ) -> bool
+    {
+        candidates.push_back( aIndex );
+        return true;
+    };
 
-            if( label )
-                return (SCH_ITEM*) label;
-        }
-        else if( (item->Type() == aType) && item->HitTest( aPosition, aAccuracy ) )
-        {
-            return item;
-        }
+    const int mmin[2] = { aPosition.x - aAccuracy, aPosition.y - aAccuracy };
+    const int mmax[2] = { aPosition.x + aAccuracy, aPosition.y + aAccuracy };
+
+    index->m_Tree.Search( mmin, mmax, collect );
+
+    // Keep the draw list order, so the same item is found as by walking the list.
+    std::sort( candidates.begin(), candidates.end() );
+
+    for( int i : candidates )
+    {
+        if( SCH_ITEM* found = hitTestItem( index->m_Items[i], aPosition, aAccuracy, aType ) )
+            return found;
     }
 
     return NULL;
@@ -263,6 +396,8 @@ void SCH_SCREEN::ExtractWires( DLIST< SCH_ITEM >& aList, bool aCreateCopy )
             break;
         }
     }
+
+    UpdateChangeStamp();
 }
 
 
@@ -289,15 +424,29 @@ void SCH_SCREEN::ReplaceWires( DLIST< SCH_ITEM >& aWireList )
     }
 
     m_drawList.Append( aWireList );
+    UpdateChangeStamp();
 }
 
 
-void SCH_SCREEN::MarkConnections( SCH_LINE* aSegment )
+// Flags the wires and junctions connected to aSegment, using aTree which holds the wires and
+// the junctions of aScreen by their end points.
+static void markConnections( SCH_SCREEN* aScreen, SCH_LINE* aSegment, ITEM_TREE& aTree )
 {
-    wxCHECK_RET( (aSegment) && (aSegment->Type() == SCH_LINE_T),
-                 wxT( "Invalid object pointer." ) );
+    std::vector<SCH_ITEM*> items;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    auto collect = [&items]( SCH_ITEM* aItem ) -> bool
+    {
+        items.push_back( aItem );
+        return true;
+    };
+
+    for( const wxPoint& end : { aSegment->GetStartPoint(), aSegment->GetEndPoint() } )
+    {
+        const int pos[2] = { end.x, end.y };
+        aTree.Search( pos, pos, collect );
+    }
+
+    for( SCH_ITEM* item : items )
     {
         if( item->GetFlags() & CANDIDATE )
             continue;
@@ -312,28 +461,53 @@ void SCH_SCREEN::MarkConnections( SCH_LINE* aSegment )
             continue;
         }
 
-        if( item->Type() != SCH_LINE_T )
-            continue;
-
         SCH_LINE* segment = (SCH_LINE*) item;
 
         if( aSegment->IsEndPoint( segment->GetStartPoint() )
-            && !GetPin( segment->GetStartPoint(), NULL, true ) )
+            && !aScreen->GetPin( segment->GetStartPoint(), NULL, true ) )
         {
             item->SetFlags( CANDIDATE );
-            MarkConnections( segment );
+            markConnections( aScreen, segment, aTree );
         }
 
         if( aSegment->IsEndPoint( segment->GetEndPoint() )
-            && !GetPin( segment->GetEndPoint(), NULL, true ) )
+            && !aScreen->GetPin( segment->GetEndPoint(), NULL, true ) )
         {
             item->SetFlags( CANDIDATE );
-            MarkConnections( segment );
+            markConnections( aScreen, segment, aTree );
         }
     }
 }
 
 
+void SCH_SCREEN::MarkConnections( SCH_LINE* aSegment )
+{
+    wxCHECK_RET( (aSegment) && (aSegment->Type() == SCH_LINE_T),
+                 wxT( "Invalid object pointer." ) );
+
+    ITEM_TREE tree;
+
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    {
+        if( item->Type() == SCH_JUNCTION_T )
+        {
+            SCH_JUNCTION* junction = (SCH_JUNCTION*) item;
+
+            insertInTree( tree, item, junction->GetPosition(), junction->GetPosition() );
+        }
+        else if( item->Type() == SCH_LINE_T )
+        {
+            SCH_LINE* segment = (SCH_LINE*) item;
+
+            insertInTree( tree, item, segment->GetStartPoint(), segment->GetStartPoint() );
+            insertInTree( tree, item, segment->GetEndPoint(), segment->GetEndPoint() );
+        }
+    }
+
+    markConnections( this, aSegment, tree );
+}
+
+
 bool SCH_SCREEN::IsJunctionNeeded( const wxPoint& aPosition )
 {
     if( GetItem( aPosition, 0, SCH_JUNCTION_T ) )
@@ -631,46 +805,74 @@ void SCH_SCREEN::ClearDrawingState()
 LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponent,
                              bool aEndPointOnly ) const
 {
-    SCH_ITEM*       item;
+    SCH_POSITION_INDEX* index = getPositionIndex();
     SCH_COMPONENT*  component = NULL;
     LIB_PIN*        pin = NULL;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    if( index && aEndPointOnly )
     {
-        if( item->Type() != SCH_COMPONENT_T )
-            continue;
+        SCH_POSITION_INDEX::PIN_MAP::const_iterator it = index->m_PinEnds.find( aPosition );
 
-        component = (SCH_COMPONENT*) item;
+        if( it != index->m_PinEnds.end() )
+        {
+            component = it->second.front().m_Component;
+            pin = it->second.front().m_Pin;
+        }
+    }
+    else if( index )
+    {
+        std::vector<int> candidates;
 
-        if( aEndPointOnly )
+        auto collect = [&candidates]( int aIndex ) -> bool
         {
-            pin = NULL;
+            candidates.push_back( aIndex );
+            return true;
+        };
 
-            LIB_PART* part = Prj().SchLibs()->FindLibPart( component->GetPartName() );
+        const int pos[2] = { aPosition.x, aPosition.y };
 
-            if( !part )
-                continue;
+        index->m_Tree.Search( pos, pos, collect );
+        std::sort( candidates.begin(), candidates.end() );
 
-            for( pin = part->GetNextPin(); pin; pin = part->GetNextPin( pin ) )
-            {
-                // Skip items not used for this part.
-                if( component->GetUnit() && pin->GetUnit() &&
-                    ( pin->GetUnit() != component->GetUnit() ) )
-                    continue;
+        for( int i : candidates )
+        {
+            if( index->m_Items[i]->Type() != SCH_COMPONENT_T )
+                continue;
 
-                if( component->GetConvert() && pin->GetConvert() &&
-                    ( pin->GetConvert() != component->GetConvert() ) )
-                    continue;
+            component = (SCH_COMPONENT*) index->m_Items[i];
+            pin = (LIB_PIN*) component->GetDrawItem( aPosition, LIB_PIN_T );
 
-                if(component->GetPinPhysicalPosition( pin ) == aPosition )
-                    break;
-            }
             if( pin )
                 break;
         }
-        else
+    }
+    else
+    {
+        for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
         {
-            pin = (LIB_PIN*) component->GetDrawItem( aPosition, LIB_PIN_T );
+            if( item->Type() != SCH_COMPONENT_T )
+                continue;
+
+            component = (SCH_COMPONENT*) item;
+
+            if( aEndPointOnly )
+            {
+                LIB_PART* part = Prj().SchLibs()->FindLibPart( component->GetPartName() );
+
+                if( !part )
+                    continue;
+
+                for( pin = part->GetNextPin(); pin; pin = part->GetNextPin( pin ) )
+                {
+                    if( isPinUsed( component, pin )
+                        && component->GetPinPhysicalPosition( pin ) == aPosition )
+                        break;
+                }
+            }
+            else
+            {
+                pin = (LIB_PIN*) component->GetDrawItem( aPosition, LIB_PIN_T );
+            }
 
             if( pin )
                 break;
@@ -684,6 +886,92 @@ LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponen
 }
 
 
+SCH_POSITION_INDEX* SCH_SCREEN::getPositionIndex() const
+{
+    // An item being moved or resized changes in place, and only updates the change stamp of
+    // the screen once it is placed.  Block operations move their items just before calling
+    // OnModify(), so they do not need this.
+    EDA_ITEM* curItem = GetCurItem();
+
+    if( curItem && ( curItem->GetFlags() & ( IS_MOVED | IS_NEW | IS_RESIZED | IS_DRAGGED ) ) )
+        return NULL;
+
+    PART_LIBS*  libs = Prj().SchLibs();
+    int         libsHash = libs->GetModifyHash();
+
+    if( !m_positionIndex )
+        m_positionIndex = new SCH_POSITION_INDEX;
+
+    SCH_POSITION_INDEX* index = m_positionIndex;
+
+    if( index->m_Valid && index->m_ChangeStamp == GetChangeStamp()
+        && index->m_LibsHash == libsHash )
+        return index;
+
+    index->m_Items.clear();
+    index->m_Tree.RemoveAll();
+    index->m_Unindexed.clear();
+    index->m_PinEnds.clear();
+
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    {
+        int i = (int) index->m_Items.size();
+
+        index->m_Items.push_back( item );
+
+        // The marker hit test does not match its bounding box.
+        if( item->Type() == SCH_MARKER_T )
+        {
+            index->m_Unindexed.push_back( i );
+            continue;
+        }
+
+        // Component boxes include the fields and the pins, sheet boxes have to be extended
+        // to the sheet pins, which are outside of the sheet outline.
+        EDA_RECT box = item->GetBoundingBox();
+
+        if( item->Type() == SCH_SHEET_T )
+        {
+            for( const SCH_SHEET_PIN& sheetPin : ( (SCH_SHEET*) item )->GetPins() )
+                box.Merge( sheetPin.GetBoundingBox() );
+        }
+
+        box.Normalize();
+        box.Inflate( POSITION_INDEX_SLACK );
+
+        const int mmin[2] = { box.GetX(), box.GetY() };
+        const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+        index->m_Tree.Insert( mmin, mmax, i );
+
+        if( item->Type() != SCH_COMPONENT_T )
+            continue;
+
+        SCH_COMPONENT* component = (SCH_COMPONENT*) item;
+        LIB_PART* part = libs->FindLibPart( component->GetPartName() );
+
+        if( !part )
+            continue;
+
+        for( LIB_PIN* pin = part->GetNextPin(); pin; pin = part->GetNextPin( pin ) )
+        {
+            if( !isPinUsed( component, pin ) )
+                continue;
+
+            SCH_POSITION_INDEX::PIN_REF ref = { component, pin };
+
+            index->m_PinEnds[ component->GetPinPhysicalPosition( pin ) ].push_back( ref );
+        }
+    }
+
+    index->m_ChangeStamp = GetChangeStamp();
+    index->m_LibsHash = libsHash;
+    index->m_Valid = true;
+
+    return index;
+}
+
+
 SCH_SHEET* SCH_SCREEN::GetSheet( const wxString& aName )
 {
     for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
@@ -919,14 +1207,80 @@ bool SCH_SCREEN::TestDanglingEnds()
 {
     SCH_ITEM* item;
     std::vector< DANGLING_END_ITEM > endPoints;
+    std::vector< size_t > firstEndPoint;        // index of the first end point of each item
     bool hasStateChanged = false;
 
     for( item = m_drawList.begin(); item; item = item->Next() )
+    {
+        firstEndPoint.push_back( endPoints.size() );
         item->GetEndPoints( endPoints );
+    }
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    firstEndPoint.push_back( endPoints.size() );
+
+    // Index the end points.  Wires and buses are stored in the list as a pair, start and
+    // end, which is indexed as a whole so items connected along the segment are found.
+    auto isSegmentStart = [&endPoints]( size_t aIndex ) -> bool
+    {
+        return ( endPoints[aIndex].GetType() == WIRE_START_END
+                 || endPoints[aIndex].GetType() == BUS_START_END )
+               && aIndex + 1 < endPoints.size();
+    };
+
+    END_POINT_TREE tree;
+
+    for( size_t ii = 0; ii < endPoints.size(); ii++ )
+    {
+        size_t  first = ii;
+        wxPoint start = endPoints[ii].GetPosition();
+        wxPoint end = start;
+
+        if( isSegmentStart( ii ) )
+            end = endPoints[++ii].GetPosition();
+
+        const int mmin[2] = { std::min( start.x, end.x ), std::min( start.y, end.y ) };
+        const int mmax[2] = { std::max( start.x, end.x ), std::max( start.y, end.y ) };
+
+        tree.Insert( mmin, mmax, (int) first );
+    }
+
+    // Each item is only tested against the end points found at its own end points, which
+    // are the only ones able to change its dangling state.
+    std::vector< int > found;
+    std::vector< DANGLING_END_ITEM > nearEndPoints;
+
+    auto collect = [&found]( int aIndex ) -> bool
     {
-        if( item->IsDanglingStateChanged( endPoints ) )
+        found.push_back( aIndex );
+        return true;
+    };
+
+    size_t itemIndex = 0;
+
+    for( item = m_drawList.begin(); item; item = item->Next(), itemIndex++ )
+    {
+        found.clear();
+        nearEndPoints.clear();
+
+        for( size_t ii = firstEndPoint[itemIndex]; ii < firstEndPoint[itemIndex + 1]; ii++ )
+        {
+            const int pos[2] = { endPoints[ii].GetPosition().x, endPoints[ii].GetPosition().y };
+            tree.Search( pos, pos, collect );
+        }
+
+        // Keep the order of the full list, and the pairs of segment ends.
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+        for( int ii : found )
+        {
+            nearEndPoints.push_back( endPoints[ii] );
+
+            if( isSegmentStart( ii ) )
+                nearEndPoints.push_back( endPoints[ii + 1] );
+        }
+
+        if( item->IsDanglingStateChanged( nearEndPoints ) )
             hasStateChanged = true;
     }
 
@@ -959,6 +1313,9 @@ bool SCH_SCREEN::BreakSegment( const wxPoint& aPoint )
         brokenSegments = true;
     }
 
+    if( brokenSegments )
+        UpdateChangeStamp();
+
     return brokenSegments;
 }
 
@@ -358,6 +358,9 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
     m_dlgFindReplace = NULL;
     m_findReplaceData = new wxFindReplaceData( wxFR_DOWN );
     m_undoItem = NULL;
+    m_connectivity = NULL;
+    m_connectivityStamp = 0;
+    m_connectivityLibHash = 0;
     m_hasAutoSave = true;
 
     SetForceHVLines( true );
@@ -445,11 +448,13 @@ SCH_EDIT_FRAME::~SCH_EDIT_FRAME()
 
     delete m_CurrentSheet;          // a SCH_SHEET_PATH, on the heap.
     delete m_undoItem;
+    delete m_connectivity;
     delete g_RootSheet;
     delete m_findReplaceData;
 
     m_CurrentSheet = NULL;
     m_undoItem = NULL;
+    m_connectivity = NULL;
     g_RootSheet = NULL;
     m_findReplaceData = NULL;
 }
@@ -64,6 +64,7 @@ class DIALOG_SCH_FIND;
 class wxFindDialogEvent;
 class wxFindReplaceData;
 class SCHLIB_FILTER;
+class NETLIST_OBJECT_LIST;
 
 
 /// enum used in RotationMiroir()
@@ -158,6 +159,15 @@ private:
     /// An index to the last find item in the found items list #m_foundItems.
     int         m_foundItemIndex;
 
+    /// The connected items of the whole schematic, built on demand by GetConnectivity().
+    NETLIST_OBJECT_LIST* m_connectivity;
+
+    /// The greatest change stamp of the screens when #m_connectivity was built.
+    unsigned    m_connectivityStamp;
+
+    /// The library modification hash when #m_connectivity was built.
+    int         m_connectivityLibHash;
+
     /// Flag to indicate show hidden pins.
     bool        m_showAllPins;
 
@@ -508,6 +518,18 @@ public:
      */
     NETLIST_OBJECT_LIST* BuildNetListBase( bool updateStatusText = true );
 
+    /**
+     * Function GetConnectivity
+     * returns the list of connected items of the whole schematic, in the same form as
+     * BuildNetListBase().  The list is kept between calls and is only built again after
+     * the schematic or the libraries are modified, so it is cheap to use for queries like
+     * net highlighting.
+     * @param updateStatusText = decides if window StatusText should be modified
+     * @return the list, owned by the frame and valid until the schematic is modified.
+     *         Callers which need to modify the list must use BuildNetListBase().
+     */
+    const NETLIST_OBJECT_LIST* GetConnectivity( bool updateStatusText = true );
+
     /**
      * Function CreateNetlist
      * <ul>
@@ -575,7 +597,9 @@ public:
      * @param aSortOption Define the annotation order.  See #ANNOTATE_ORDER_T.
      * @param aAlgoOption Define the annotation style.  See #ANNOTATE_OPTION_T.
      * @param aResetAnnotation Clear any previous annotation if true.  Otherwise, keep the
-     *                         existing component annotation.
+     *                         existing component annotation and only sort and annotate
+     *                         the components which are not annotated yet.  The missing
+     *                         units of the existing packages are used first.
      * @param aRepairTimestamps Test for and repair any duplicate time stamps if true.
      *                          Otherwise, keep the existing time stamps.  This option
      *                          could change previous annotation because time stamps are
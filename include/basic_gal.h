@@ -158,6 +158,8 @@ private:
 };
 
 
-extern BASIC_GAL basic_gal;
+// One instance per thread, since its state is set for each text: texts can then be
+// plotted on several threads, for instance when plotting schematic sheets.
+extern thread_local BASIC_GAL basic_gal;
 
 #endif      // define BASIC_GAL_H
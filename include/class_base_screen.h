@@ -79,6 +79,7 @@ private:
     GRIDS       m_grids;            ///< List of valid grid sizes.
     bool        m_FlagModified;     ///< Indicates current drawing has been modified.
     bool        m_FlagSave;         ///< Indicates automatic file save.
+    unsigned    m_changeStamp;      ///< Changes each time the drawing is modified.
     EDA_ITEM*   m_CurrentItem;      ///< Currently selected object
     GRID_TYPE   m_Grid;             ///< Current grid selection.
     wxPoint     m_scrollCenter;     ///< Current scroll center point in logical units.
@@ -94,6 +95,8 @@ private:
 
     double      m_Zoom;             ///< Current zoom coefficient.
 
+    static unsigned s_lastChangeStamp;  ///< Last value given to a #m_changeStamp.
+
     //----< Old public API now is private, and migratory>------------------------
     // called only from EDA_DRAW_FRAME
     friend class EDA_DRAW_FRAME;
@@ -321,13 +324,29 @@ public:
         }
     }
 
-    void SetModify()        { m_FlagModified = true; }
+    void SetModify()        { m_FlagModified = true;  UpdateChangeStamp(); }
     void ClrModify()        { m_FlagModified = false; }
     void SetSave()          { m_FlagSave = true; }
     void ClrSave()          { m_FlagSave = false; }
     bool IsModify() const   { return m_FlagModified; }
     bool IsSave() const     { return m_FlagSave; }
 
+    /**
+     * Function GetChangeStamp
+     * @return a value which is changed each time the drawing is modified.  Stamps are
+     *         increasing and unique among all the screens, so data built from the drawing
+     *         (a connectivity list for instance) is out of date when the greatest stamp of
+     *         the screens it was built from has changed.
+     */
+    unsigned GetChangeStamp() const { return m_changeStamp; }
+
+    /**
+     * Function UpdateChangeStamp
+     * gives a new change stamp to the screen, without setting the modified flag.
+     * Used for changes which do not need to be saved, like a clean up of the wires.
+     */
+    void UpdateChangeStamp() { m_changeStamp = ++s_lastChangeStamp; }
+
 
     //----<zoom stuff>---------------------------------------------------------
 
@@ -196,6 +196,22 @@ public:
      */
     virtual void OnShow() {}
 
+    /**
+     * Function ShowRenderStats()
+     * Turns on/off collecting the rendering statistics and displaying them on the canvas.
+     * The collected statistics are kept after turning it off, so they may be exported.
+     */
+    void ShowRenderStats( bool aShow );
+
+    /**
+     * Function IsRenderStatsShown()
+     * Returns true if the rendering statistics are displayed on the canvas.
+     */
+    bool IsRenderStatsShown() const
+    {
+        return m_showRenderStats;
+    }
+
 protected:
     void onPaint( wxPaintEvent& WXUNUSED( aEvent ) );
     void onSize( wxSizeEvent& aEvent );
@@ -205,6 +221,9 @@ protected:
     void onRefreshTimer( wxTimerEvent& aEvent );
     void onShowTimer( wxTimerEvent& aEvent );
 
+    ///> Draws the rendering statistics in the top left corner of the canvas
+    void drawRenderStats();
+
     static const int MinRefreshPeriod = 17;             ///< 60 FPS.
 
     /// Pointer to the parent window
@@ -254,6 +273,9 @@ protected:
     /// for cases when the panel loses keyboard focus, so it does not react to hotkeys anymore.
     bool                     m_lostFocus;
 
+    /// Are the rendering statistics displayed on the canvas?
+    bool                     m_showRenderStats;
+
     /// Grid style setting string
     static const wxChar GRID_STYLE_CFG[];
 };
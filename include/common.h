@@ -43,6 +43,11 @@
 #include <colors.h>
 
 #include <atomic>
+#include <locale.h>
+
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
 
 // C++11 "polyfill" for the C++14 std::make_unique function
 #include "make_unique.h"
@@ -191,6 +196,10 @@ extern EDA_COLOR_T  g_GhostColor;
  * to read/print files with fp numbers.
  * Its destructor insures that the default locale is restored if an exception
  * is thrown, or not.
+ * <p>
+ * On the main thread the process wide locale is switched.  On any other thread only
+ * the locale of that thread is switched, so a file can be read or written in background
+ * without changing the number format under the GUI.
  */
 class LOCALE_IO
 {
@@ -207,6 +216,16 @@ private:
     // The locale in use before switching to the "C" locale
     // (the locale can be set by user, and is not always the system locale)
     std::string m_user_locale;
+
+    // true when only the locale of the current (worker) thread was switched
+    bool        m_thread_only;
+
+#if defined( _WIN32 )
+    int         m_thread_config;    ///< _configthreadlocale() setting to restore
+#else
+    locale_t    m_c_locale;         ///< "C" locale of the current thread
+    locale_t    m_prev_locale;      ///< locale of the current thread to restore
+#endif
 };
 
 
@@ -0,0 +1,103 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file eda_search_index.h
+ * @brief N-gram index narrowing the items to give to the pattern matchers.
+ */
+
+#ifndef EDA_SEARCH_INDEX_H
+#define EDA_SEARCH_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+
+/**
+ * Class EDA_SEARCH_INDEX
+ * is an inverted index of the trigrams found in the texts of a list of items, e.g. the
+ * names and keywords of the footprints or symbols of the libraries.
+ *
+ * A text matching a pattern contains the strings the pattern requires, so it has all
+ * their trigrams.  The index gives the items having them, which are the only ones the
+ * exact matcher (see EDA_PATTERN_MATCH) needs to check.  The index does not fold the
+ * case: give it and search it with texts of the same case.
+ */
+class EDA_SEARCH_INDEX
+{
+public:
+    /// The kind of pattern, as matched by the EDA_PATTERN_MATCH of the same name.
+    enum MATCH_TYPE
+    {
+        MATCH_SUBSTR,
+        MATCH_WILDCARD,
+        MATCH_REGEX
+    };
+
+    EDA_SEARCH_INDEX() {}
+
+    /**
+     * Function Clear
+     * forgets all the items.
+     */
+    void Clear()
+    {
+        m_postings.clear();
+    }
+
+    /**
+     * Function AddText
+     * indexes \a aText as one of the texts of item \a aItem.  The items must be added in
+     * increasing order, all the texts of an item one after the other.  The texts of an
+     * item are indexed separately, so a pattern is not found across two of them.
+     */
+    void AddText( unsigned aItem, const wxString& aText );
+
+    /**
+     * Function FindCandidates
+     * gives the items whose texts may match \a aPattern: all the items a matcher of
+     * \a aType would find \a aPattern in, and maybe a few more.
+     *
+     * @param aCandidates receives the candidate items, in increasing order.
+     * @return bool - false if \a aPattern requires nothing the index can use (too short,
+     *  or too complex for a regex), all the items are candidates then.
+     */
+    bool FindCandidates( const wxString& aPattern, MATCH_TYPE aType,
+                         std::vector<unsigned>& aCandidates ) const;
+
+    /**
+     * Function RequiredStrings
+     * stores in \a aStrings strings found in any text matching \a aPattern.  A regex
+     * using alternatives, groups, bracket expressions or escapes requires nothing here.
+     */
+    static void RequiredStrings( const wxString& aPattern, MATCH_TYPE aType,
+                                 std::vector<std::wstring>& aStrings );
+
+private:
+    std::unordered_map<uint64_t, std::vector<unsigned>> m_postings;
+};
+
+#endif  // EDA_SEARCH_INDEX_H
@@ -34,6 +34,7 @@
 
 #include <ki_mutex.h>
 #include <kicad_string.h>
+#include <eda_search_index.h>
 
 
 #define USE_FPI_LAZY            0   // 1:yes lazy,  0:no early
@@ -172,6 +173,9 @@ class FOOTPRINT_LIST
     MUTEX   m_errors_lock;
     MUTEX   m_list_lock;
 
+    EDA_SEARCH_INDEX    m_name_index;       ///< see GetNameIndex()
+    bool                m_name_index_valid;
+
     /**
      * Function loader_job
      * loads footprints from @a aNicknameList and calls AddItem() on to help fill
@@ -196,7 +200,8 @@ public:
 
     FOOTPRINT_LIST() :
         m_lib_table( 0 ),
-        m_error_count( 0 )
+        m_error_count( 0 ),
+        m_name_index_valid( false )
     {
     }
 
@@ -223,6 +228,15 @@ public:
      */
     FOOTPRINT_INFO& GetItem( unsigned aIdx )            { return m_list[aIdx]; }
 
+    /**
+     * Function GetNameIndex
+     * returns the search index of the lowercased footprint names, whose items are the
+     * indices in this list.  It is built on the first call after reading the list, so
+     * filtering the list again and again, e.g. as the user types, only scans the
+     * footprints which may match.
+     */
+    const EDA_SEARCH_INDEX& GetNameIndex();
+
     /**
      * Function AddItem
      * add aItem in list
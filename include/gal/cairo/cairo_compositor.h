@@ -74,6 +74,37 @@ public:
     /// @copydoc COMPOSITOR::Present()
     virtual void Present() override;
 
+    /**
+     * Function ScrollBuffer()
+     * Moves the contents of a buffer by a number of pixels and clears the uncovered part.
+     *
+     * @param aBufferHandle is the buffer to be moved.
+     * @param aDx is the horizontal offset in pixels.
+     * @param aDy is the vertical offset in pixels.
+     */
+    void ScrollBuffer( unsigned int aBufferHandle, int aDx, int aDy );
+
+    /**
+     * Function CopyBuffer()
+     * Copies the contents of a buffer to another buffer.
+     *
+     * @param aSourceHandle is the buffer to be copied.
+     * @param aDestHandle is the buffer that receives the copy.
+     */
+    void CopyBuffer( unsigned int aSourceHandle, unsigned int aDestHandle );
+
+    /**
+     * Function DrawScaledBuffer()
+     * Draws a buffer on the main context, scaled and moved.
+     *
+     * @param aBufferHandle is the buffer to be drawn.
+     * @param aScale is the scale of the buffer contents.
+     * @param aOffsetX is the horizontal position of the buffer contents in pixels.
+     * @param aOffsetY is the vertical position of the buffer contents in pixels.
+     */
+    void DrawScaledBuffer( unsigned int aBufferHandle, double aScale,
+                           double aOffsetX, double aOffsetY );
+
     /**
      * Function SetMainContext()
      * Sets a context to be treated as the main context (ie. as a target of buffers rendering and
@@ -114,7 +145,7 @@ protected:
     CAIRO_BUFFERS           m_buffers;
 
     unsigned int m_stride;              ///< Stride to use given the desired format and width
-    unsigned int m_bufferSize;          ///< Amount of memory needed to store a buffer
+    size_t       m_bufferSize;          ///< Number of 32 bit pixels in a buffer, with padding
 
     /**
      * Function clean()
@@ -63,33 +63,18 @@ namespace KIGFX
 {
 class CAIRO_COMPOSITOR;
 
-class CAIRO_GAL : public GAL, public wxWindow
+/**
+ * @brief Class CAIRO_GAL_BASE holds the drawing code shared by the cairo based GALs.
+ *
+ * It renders to an image buffer in memory and does not depend on a window, so the derived
+ * classes only decide where the finished image goes.
+ */
+class CAIRO_GAL_BASE : public GAL
 {
 public:
-    /**
-     * Constructor CAIRO_GAL
-     *
-     * @param aParent is the wxWidgets immediate wxWindow parent of this object.
-     *
-     * @param aMouseListener is the wxEvtHandler that should receive the mouse events,
-     *  this can be can be any wxWindow, but is often a wxFrame container.
-     *
-     * @param aPaintListener is the wxEvtHandler that should receive the paint
-     *  event.  This can be any wxWindow, but is often a derived instance
-     *  of this class or a containing wxFrame.  The "paint event" here is
-     *  a wxCommandEvent holding EVT_GAL_REDRAW, as sent by PostPaint().
-     *
-     * @param aName is the name of this window for use by wxWindow::FindWindowByName()
-     */
-    CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener = NULL,
-               wxEvtHandler* aPaintListener = NULL, const wxString& aName = wxT( "CairoCanvas" ) );
+    CAIRO_GAL_BASE();
 
-    virtual ~CAIRO_GAL();
-
-    ///> @copydoc GAL::IsVisible()
-    bool IsVisible() const override {
-        return IsShownOnScreen();
-    }
+    virtual ~CAIRO_GAL_BASE();
 
     // ---------------
     // Drawing methods
@@ -122,6 +107,9 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override { drawPoly( aPointList, aListSize ); }
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override { drawPoly( aLineChain ); }
 
+    /// @copydoc GAL::DrawGlyphs()
+    virtual void DrawGlyphs( const GLYPH_RUN& aGlyphs ) override;
+
     /// @copydoc GAL::DrawPolygon()
     virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override { drawPoly( aPointList ); }
     virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override { drawPoly( aPointList, aListSize ); }
@@ -138,9 +126,6 @@ public:
     /// @brief Resizes the canvas.
     virtual void ResizeScreen( int aWidth, int aHeight ) override;
 
-    /// @brief Shows/hides the GAL canvas
-    virtual bool Show( bool aShow ) override;
-
     /// @copydoc GAL::Flush()
     virtual void Flush() override;
 
@@ -235,44 +220,43 @@ public:
     /// @copydoc GAL::ClearTarget()
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
-    // -------
-    // Cursor
-    // -------
+    /// @copydoc GAL::IsPartialRedrawSupported()
+    virtual bool IsPartialRedrawSupported() const override
+    {
+        return true;
+    }
 
-    /// @copydoc GAL::SetCursorSize()
-    virtual void SetCursorSize( unsigned int aCursorSize ) override;
+    /// @copydoc GAL::BeginPartialRedraw()
+    virtual void BeginPartialRedraw( const BOX2I& aArea ) override;
 
-    /// @copydoc GAL::DrawCursor()
-    virtual void DrawCursor( const VECTOR2D& aCursorPosition ) override;
+    /// @copydoc GAL::EndPartialRedraw()
+    virtual void EndPartialRedraw() override;
 
-    /**
-     * Function PostPaint
-     * posts an event to m_paint_listener.  A post is used so that the actual drawing
-     * function can use a device context type that is not specific to the wxEVT_PAINT event.
-     */
-    void PostPaint()
-    {
-        if( paintListener )
-        {
-            wxPaintEvent redrawEvent;
-            wxPostEvent( paintListener, redrawEvent );
-        }
-    }
+    /// @copydoc GAL::ScrollTarget()
+    virtual bool ScrollTarget( RENDER_TARGET aTarget, const VECTOR2I& aDelta ) override;
 
-    void SetMouseListener( wxEvtHandler* aMouseListener )
-    {
-        mouseListener = aMouseListener;
-    }
+    /// @copydoc GAL::ShowTargetPreview()
+    virtual bool ShowTargetPreview( RENDER_TARGET aTarget, double aScale,
+                                    const VECTOR2D& aOffset ) override;
 
-    void SetPaintListener( wxEvtHandler* aPaintListener )
-    {
-        paintListener = aPaintListener;
-    }
+    /// @copydoc GAL::HideTargetPreview()
+    virtual void HideTargetPreview() override;
+
+    /// @copydoc GAL::IsTargetPreviewSupported()
+    virtual bool IsTargetPreviewSupported() const override;
+
+    /// @copydoc GAL::IsParallelRenderingSupported()
+    virtual bool IsParallelRenderingSupported() const override;
+
+    /// @copydoc GAL::DrawLayerBatches()
+    virtual void DrawLayerBatches( const std::vector<LAYER_BATCH>& aBatches ) override;
+
+    /// @copydoc GAL::DrawCursor()
+    virtual void DrawCursor( const VECTOR2D& aCursorPosition ) override;
 
 protected:
     virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
 
-private:
     /// Super class definition
     typedef GAL super;
 
@@ -280,22 +264,15 @@ private:
     std::shared_ptr<CAIRO_COMPOSITOR> compositor;   ///< Object for layers compositing
     unsigned int            mainBuffer;             ///< Handle to the main buffer
     unsigned int            overlayBuffer;          ///< Handle to the overlay buffer
+    unsigned int            previewBuffer;          ///< Handle to the main buffer preview copy
+    bool                    isPreviewShown;         ///< Preview is displayed instead of main buffer
+    double                  previewScale;           ///< Scale of the displayed preview
+    VECTOR2D                previewOffset;          ///< Position of the displayed preview
     RENDER_TARGET           currentTarget;          ///< Current rendering target
     bool                    validCompositor;        ///< Compositor initialization flag
 
-    // Variables related to wxWidgets
-    wxWindow*               parentWindow;           ///< Parent window
-    wxEvtHandler*           mouseListener;          ///< Mouse listener
-    wxEvtHandler*           paintListener;          ///< Paint listener
-    unsigned int            bufferSize;             ///< Size of buffers cairoOutput, bitmapBuffers
-    unsigned char*          wxOutput;               ///< wxImage comaptible buffer
-
-    // Cursor variables
-    std::deque<wxColour>    savedCursorPixels;      ///< Saved pixels of the cursor
+    size_t                  bufferSize;             ///< Number of 32 bit pixels in bitmapBuffers
     bool                    isDeleteSavedPixels;    ///< True, if the saved pixels can be discarded
-    wxPoint                 savedCursorPosition;    ///< The last cursor position
-    wxBitmap*               cursorPixels;           ///< Cursor pixels
-    wxBitmap*               cursorPixelsSaved;      ///< Saved cursor pixels
 
     /// Maximum number of arguments for one command
     static const int MAX_CAIRO_ARGUMENTS = 4;
@@ -339,6 +316,20 @@ private:
     unsigned int                groupCounter;       ///< Counter used for generating keys for groups
     GROUP*                      currentGroup;       ///< Currently used group
 
+    /// Drawing attributes changed by the commands stored in groups
+    struct GROUP_STATE
+    {
+        bool    isFillEnabled;
+        bool    isStrokeEnabled;
+        COLOR4D fillColor;
+        COLOR4D strokeColor;
+    };
+
+    // Variables for the parallel rendering
+    std::vector<cairo_surface_t*> layerSurfaces;    ///< Surfaces for layers rendered on threads
+    BOX2I                       partialRedrawArea;  ///< Area set by BeginPartialRedraw()
+    bool                        isPartialRedraw;    ///< Is a partial redraw in progress ?
+
     // Variables related to Cairo <-> wxWidgets
     cairo_matrix_t      cairoWorldScreenMatrix; ///< Cairo world to screen transformation matrix
     cairo_t*            currentContext;         ///< Currently used Cairo context for drawing
@@ -346,41 +337,17 @@ private:
     cairo_surface_t*    surface;                ///< Cairo surface
     unsigned int*       bitmapBuffer;           ///< Storage of the cairo image
     unsigned int*       bitmapBufferBackup;     ///< Backup storage of the cairo image
+    bool                useBackupBuffer;        ///< Allocate bitmapBufferBackup
     int                 stride;                 ///< Stride value for Cairo
     bool                isInitialized;          ///< Are Cairo image & surface ready to use
     COLOR4D             backgroundColor;        ///< Background color
 
-    int wxBufferWidth;
+    int bufferWidth;                            ///< Width of the image buffer in pixels
 
     void flushPath();
     // Methods
     void storePath();                           ///< Store the actual path
 
-    // Event handlers
-    /**
-     * @brief Paint event handler.
-     *
-     * @param aEvent is the paint event.
-     */
-    void onPaint( wxPaintEvent& aEvent );
-
-    /**
-     * @brief Mouse event handler, forwards the event to the child.
-     *
-     * @param aEvent is the mouse event to be forwarded.
-     */
-    void skipMouseEvent( wxMouseEvent& aEvent );
-
-    /**
-     * @brief Prepares cursor bitmap.
-     */
-    virtual void initCursor();
-
-    /**
-     * @brief Blits cursor into the current screen.
-     */
-    virtual void blitCursor( wxMemoryDC& clientDC );
-
     /// Prepare Cairo surfaces for drawing
     void initSurface();
 
@@ -390,12 +357,26 @@ private:
     /// Allocate the bitmaps for drawing
     void allocateBitmaps();
 
-    /// Allocate the bitmaps for drawing
+    /// Free the bitmaps used for drawing
     void deleteBitmaps();
 
     /// Prepare the compositor
     void setCompositor();
 
+    /// Destroy the surfaces used for parallel rendering
+    void deleteLayerSurfaces();
+
+    /**
+     * @brief Executes the commands stored in a group. Nested groups are executed as well.
+     *
+     * Only reads the GAL, so several groups may be drawn at the same time to different contexts.
+     *
+     * @param aContext is the context to draw to.
+     * @param aGroupNumber is the group number.
+     * @param aState is the drawing state, updated by the group commands.
+     */
+    void drawGroup( cairo_t* aContext, int aGroupNumber, GROUP_STATE& aState ) const;
+
     /// Drawing polygons & polylines is the same in cairo, so here is the common code
     void drawPoly( const std::deque<VECTOR2D>& aPointList );
     void drawPoly( const VECTOR2D aPointList[], int aListSize );
@@ -414,6 +395,153 @@ private:
     ///> Opacity of a single layer
     static const float LAYER_ALPHA;
 };
+
+
+/**
+ * @brief Class CAIRO_GAL is the cairo GAL displayed in a wxWindow.
+ */
+class CAIRO_GAL : public CAIRO_GAL_BASE, public wxWindow
+{
+public:
+    /**
+     * Constructor CAIRO_GAL
+     *
+     * @param aParent is the wxWidgets immediate wxWindow parent of this object.
+     *
+     * @param aMouseListener is the wxEvtHandler that should receive the mouse events,
+     *  this can be can be any wxWindow, but is often a wxFrame container.
+     *
+     * @param aPaintListener is the wxEvtHandler that should receive the paint
+     *  event.  This can be any wxWindow, but is often a derived instance
+     *  of this class or a containing wxFrame.  The "paint event" here is
+     *  a wxCommandEvent holding EVT_GAL_REDRAW, as sent by PostPaint().
+     *
+     * @param aName is the name of this window for use by wxWindow::FindWindowByName()
+     */
+    CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener = NULL,
+               wxEvtHandler* aPaintListener = NULL, const wxString& aName = wxT( "CairoCanvas" ) );
+
+    virtual ~CAIRO_GAL();
+
+    ///> @copydoc GAL::IsVisible()
+    bool IsVisible() const override {
+        return IsShownOnScreen();
+    }
+
+    /// @copydoc GAL::EndDrawing()
+    virtual void EndDrawing() override;
+
+    /// @brief Resizes the canvas.
+    virtual void ResizeScreen( int aWidth, int aHeight ) override;
+
+    /// @brief Shows/hides the GAL canvas
+    virtual bool Show( bool aShow ) override;
+
+    /// @copydoc GAL::SetCursorSize()
+    virtual void SetCursorSize( unsigned int aCursorSize ) override;
+
+    /**
+     * Function PostPaint
+     * posts an event to m_paint_listener.  A post is used so that the actual drawing
+     * function can use a device context type that is not specific to the wxEVT_PAINT event.
+     */
+    void PostPaint()
+    {
+        if( paintListener )
+        {
+            wxPaintEvent redrawEvent;
+            wxPostEvent( paintListener, redrawEvent );
+        }
+    }
+
+    void SetMouseListener( wxEvtHandler* aMouseListener )
+    {
+        mouseListener = aMouseListener;
+    }
+
+    void SetPaintListener( wxEvtHandler* aPaintListener )
+    {
+        paintListener = aPaintListener;
+    }
+
+private:
+    // Variables related to wxWidgets
+    wxWindow*               parentWindow;           ///< Parent window
+    wxEvtHandler*           mouseListener;          ///< Mouse listener
+    wxEvtHandler*           paintListener;          ///< Paint listener
+    unsigned char*          wxOutput;               ///< wxImage comaptible buffer
+
+    // Cursor variables
+    std::deque<wxColour>    savedCursorPixels;      ///< Saved pixels of the cursor
+    wxPoint                 savedCursorPosition;    ///< The last cursor position
+    wxBitmap*               cursorPixels;           ///< Cursor pixels
+    wxBitmap*               cursorPixelsSaved;      ///< Saved cursor pixels
+
+    // Event handlers
+    /**
+     * @brief Paint event handler.
+     *
+     * @param aEvent is the paint event.
+     */
+    void onPaint( wxPaintEvent& aEvent );
+
+    /**
+     * @brief Mouse event handler, forwards the event to the child.
+     *
+     * @param aEvent is the mouse event to be forwarded.
+     */
+    void skipMouseEvent( wxMouseEvent& aEvent );
+
+    /**
+     * @brief Prepares cursor bitmap.
+     */
+    virtual void initCursor();
+
+    /**
+     * @brief Blits cursor into the current screen.
+     */
+    virtual void blitCursor( wxMemoryDC& clientDC );
+};
+
+
+/**
+ * @brief Class CAIRO_IMAGE_GAL is a cairo GAL rendering to an image in memory.
+ *
+ * It needs neither a window nor a running event loop, so it can be used to render previews
+ * from command line tools and scripts. Every instance has its own buffers, so several images
+ * may be rendered at the same time on different threads.
+ */
+class CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    /**
+     * Constructor CAIRO_IMAGE_GAL
+     *
+     * @param aWidth is the image width in pixels.
+     * @param aHeight is the image height in pixels.
+     */
+    CAIRO_IMAGE_GAL( int aWidth, int aHeight );
+
+    /**
+     * Function SetBackgroundColor
+     * sets the color the image is filled with by BeginDrawing().
+     *
+     * @param aColor is the background color.
+     */
+    void SetBackgroundColor( const COLOR4D& aColor )
+    {
+        backgroundColor = aColor;
+    }
+
+    /**
+     * Function SaveImage
+     * writes the image rendered by the last BeginDrawing()/EndDrawing() pair to a PNG file.
+     *
+     * @param aFileName is the name of the file to be written.
+     * @return true on success.
+     */
+    bool SaveImage( const wxString& aFileName ) const;
+};
 } // namespace KIGFX
 
 #endif  // CAIROGAL_H_
@@ -28,9 +28,12 @@
 #define GRAPHICSABSTRACTIONLAYER_H_
 
 #include <deque>
+#include <vector>
 #include <stack>
 #include <limits>
+#include <cstdint>
 
+#include <math/box2.h>
 #include <math/matrix3x3.h>
 
 #include <gal/color4d.h>
@@ -53,6 +56,19 @@ enum GRID_STYLE
 };
 
 
+/**
+ * Struct LAYER_BATCH
+ * holds what is drawn on a single layer by GAL::DrawLayerBatches(): cached groups and
+ * filled rectangles (simplified items), drawn in this order.
+ */
+struct LAYER_BATCH
+{
+    double                                      depth;      ///< Layer depth
+    std::vector<int>                            groups;     ///< Groups to be drawn
+    std::vector< std::pair<BOX2D, COLOR4D> >    rects;      ///< Filled rectangles
+};
+
+
 /**
  * @brief Class GAL is the abstract interface for drawing on a 2D-surface.
  *
@@ -122,6 +138,13 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) {};
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) {};
 
+    /**
+     * @brief Draw a run of stroke font glyphs, each glyph being a set of polylines.
+     *
+     * @param aGlyphs is the list of glyphs together with the positions of their origins.
+     */
+    virtual void DrawGlyphs( const GLYPH_RUN& aGlyphs );
+
     /**
      * @brief Draw a circle using world coordinates.
      *
@@ -523,6 +546,22 @@ public:
      */
     virtual void DrawGroup( int aGroupNumber ) {};
 
+    /**
+     * @brief Returns true if DrawLayerBatches() rasterizes the layers on several threads.
+     */
+    virtual bool IsParallelRenderingSupported() const { return false; };
+
+    /**
+     * @brief Draws a sequence of layers, one after another, on the current target.
+     *
+     * The result is the same as drawing the groups and rectangles of each batch in order,
+     * but GALs supporting parallel rendering rasterize the layers on separate threads and
+     * composite them afterwards.
+     *
+     * @param aBatches are the layers to be drawn, from the bottom one to the top one.
+     */
+    virtual void DrawLayerBatches( const std::vector<LAYER_BATCH>& aBatches );
+
     /**
      * @brief Changes the color used to draw the group.
      *
@@ -551,6 +590,11 @@ public:
      */
     virtual void ClearCache() {};
 
+    /**
+     * @brief Returns the total amount of vertex data sent to the GPU so far (for statistics).
+     */
+    virtual uint64_t GetUploadedBytes() const { return 0; };
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -744,6 +788,60 @@ public:
      */
     virtual void ClearTarget( RENDER_TARGET aTarget ) {};
 
+    /**
+     * @brief Returns true if the GAL keeps the rendered image of the cached and noncached
+     * targets between frames, so only the changed areas of the screen have to be redrawn.
+     */
+    virtual bool IsPartialRedrawSupported() const { return false; };
+
+    /**
+     * @brief Begins redrawing an area of the cached and noncached targets. The area is cleared
+     * and drawing is restricted to it until EndPartialRedraw() is called.
+     *
+     * @param aArea is the area to be redrawn, in screen pixels.
+     */
+    virtual void BeginPartialRedraw( const BOX2I& aArea ) {};
+
+    /**
+     * @brief Ends redrawing an area started with BeginPartialRedraw().
+     */
+    virtual void EndPartialRedraw() {};
+
+    /**
+     * @brief Moves the already rendered contents of a target, used when the view is panned.
+     * The uncovered part of the target is cleared.
+     *
+     * @param aTarget is the target to be moved.
+     * @param aDelta is the offset in screen pixels.
+     * @return true if the target was moved, false if it has to be redrawn from scratch.
+     */
+    virtual bool ScrollTarget( RENDER_TARGET aTarget, const VECTOR2I& aDelta ) { return false; };
+
+    /**
+     * @brief Displays the already rendered contents of a target, scaled and moved, instead of the
+     * target itself. The contents are saved by the first call, the following calls only change
+     * the transformation, so the target may be redrawn meanwhile. Used to show the previous image
+     * while a changed viewport is redrawn over several frames.
+     *
+     * @param aTarget is the target to be previewed.
+     * @param aScale is the scale of the saved contents.
+     * @param aOffset is the screen position of the top left corner of the saved contents.
+     * @return true if the preview is displayed, false if it is not supported.
+     */
+    virtual bool ShowTargetPreview( RENDER_TARGET aTarget, double aScale,
+                                    const VECTOR2D& aOffset ) { return false; };
+
+    /**
+     * @brief Displays the target contents again instead of the preview.
+     */
+    virtual void HideTargetPreview() {};
+
+    /**
+     * @brief Returns true if ShowTargetPreview() is implemented. Without it, the layers that are
+     * not redrawn yet are missing from the frames of a redraw spread over several frames.
+     */
+    virtual bool IsTargetPreviewSupported() const { return false; };
+
     // -------------
     // Grid methods
     // -------------
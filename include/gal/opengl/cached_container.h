@@ -33,7 +33,7 @@
 #define CACHED_CONTAINER_H_
 
 #include <gal/opengl/vertex_container.h>
-#include <map>
+#include <gal/opengl/free_chunk_list.h>
 #include <set>
 
 namespace KIGFX
@@ -41,6 +41,23 @@ namespace KIGFX
 class VERTEX_ITEM;
 class SHADER;
 
+/**
+ * Struct CACHED_CONTAINER_STATS
+ * describes the memory usage of a CACHED_CONTAINER. Sizes are expressed in vertices.
+ */
+struct CACHED_CONTAINER_STATS
+{
+    unsigned int size;              ///< Current container size
+    unsigned int used;              ///< Space used by the stored items
+    unsigned int freeChunks;        ///< Number of free chunks
+    unsigned int largestFreeChunk;  ///< Size of the largest free chunk
+    double       fragmentation;     ///< 0.0 for contiguous free space, up to 1.0 if scattered
+    unsigned int resizeCount;       ///< Number of times the container has been enlarged
+    unsigned int compactCount;      ///< Number of times the items were compacted without resizing
+    double       compactTime;       ///< Total time spent on moving items (resizing & compacting), in ms
+    uint64_t     written;           ///< Total number of vertices written to the buffer
+};
+
 class CACHED_CONTAINER : public VERTEX_CONTAINER
 {
 public:
@@ -86,16 +103,18 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     void Unmap() override;
 
-protected:
-    ///> Maps size of free memory chunks to their offsets
-    typedef std::pair<unsigned int, unsigned int> CHUNK;
-    typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
+    /**
+     * Function GetStats()
+     * returns the memory usage statistics of the container.
+     */
+    CACHED_CONTAINER_STATS GetStats() const;
 
+protected:
     /// List of all the stored items
     typedef std::set<VERTEX_ITEM*> ITEMS;
 
     ///> Stores size & offset of free chunks.
-    FREE_CHUNK_MAP      m_freeChunks;
+    FREE_CHUNK_LIST     m_freeChunks;
 
     ///> Stored VERTEX_ITEMs
     ITEMS               m_items;
@@ -119,6 +138,14 @@ protected:
     ///> Flag saying whether it is safe to use glCopyBufferSubData
     bool m_useCopyBuffer;
 
+    ///> Statistics: number of resizes & compactions, and the time they took (in ms)
+    unsigned int m_resizeCount;
+    unsigned int m_compactCount;
+    double       m_compactTime;
+
+    ///> Statistics: number of vertices written to the buffer
+    uint64_t     m_written;
+
     /**
      * Function init()
      * performs the GL vertex buffer initialization. It can be invoked only when an OpenGL context
@@ -148,13 +175,6 @@ protected:
     bool defragmentResize( unsigned int aNewSize );
     bool defragmentResizeMemcpy( unsigned int aNewSize );
 
-    /**
-     * Function mergeFreeChunks()
-     * looks for consecutive free memory chunks and merges them, decreasing fragmentation of
-     * memory.
-     */
-    void mergeFreeChunks();
-
     /**
      * Function getPowerOf2()
      * returns the nearest power of 2, bigger than aNumber.
@@ -164,28 +184,6 @@ protected:
     unsigned int getPowerOf2( unsigned int aNumber ) const;
 
 private:
-    /**
-     * Function getChunkSize()
-     * returns size of the given chunk.
-     *
-     * @param aChunk is the chunk.
-     */
-    inline int getChunkSize( const CHUNK& aChunk ) const
-    {
-        return aChunk.first;
-    }
-
-    /**
-     * Function getChunkOffset()
-     * returns offset of the chunk.
-     *
-     * @param aChunk is the chunk.
-     */
-    inline unsigned int getChunkOffset( const CHUNK& aChunk ) const
-    {
-        return aChunk.second;
-    }
-
     /**
      * Function addFreeChunk
      * Adds a chunk marked as free.
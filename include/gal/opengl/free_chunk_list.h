@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file free_chunk_list.h
+ * @brief Bookkeeping of the free space in a CACHED_CONTAINER.
+ */
+
+#ifndef FREE_CHUNK_LIST_H_
+#define FREE_CHUNK_LIST_H_
+
+#include <map>
+#include <set>
+
+namespace KIGFX
+{
+
+/**
+ * Class FREE_CHUNK_LIST
+ * keeps track of free memory chunks in a linear buffer. Adjacent free chunks are merged as
+ * soon as they are returned, so the free space does not break up into small pieces over long
+ * sessions. Allocations take the smallest chunk that fits (the one with the lowest offset among
+ * chunks of the same size), which keeps the stored data packed at the beginning of the buffer.
+ */
+class FREE_CHUNK_LIST
+{
+public:
+    FREE_CHUNK_LIST() :
+        m_freeSpace( 0 )
+    {
+    }
+
+    /**
+     * Function Clear()
+     * removes all the free chunks.
+     */
+    void Clear();
+
+    /**
+     * Function Add()
+     * marks a chunk as free, merging it with the neighbouring free chunks.
+     * @param aOffset is the chunk offset.
+     * @param aSize is the chunk size.
+     */
+    void Add( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Function Take()
+     * removes the smallest free chunk that can hold aSize units from the list.
+     * @param aSize is the requested size.
+     * @param aOffset is set to the offset of the taken chunk.
+     * @param aChunkSize is set to the size of the taken chunk (it may be bigger than aSize).
+     * @return false if there is no chunk big enough.
+     */
+    bool Take( unsigned int aSize, unsigned int& aOffset, unsigned int& aChunkSize );
+
+    /**
+     * Function GetFreeSpace()
+     * returns the total size of the free chunks.
+     */
+    unsigned int GetFreeSpace() const
+    {
+        return m_freeSpace;
+    }
+
+    /**
+     * Function GetChunkCount()
+     * returns the number of free chunks.
+     */
+    unsigned int GetChunkCount() const
+    {
+        return m_chunksByOffset.size();
+    }
+
+    /**
+     * Function GetLargestChunk()
+     * returns the size of the largest free chunk.
+     */
+    unsigned int GetLargestChunk() const
+    {
+        return m_chunksBySize.empty() ? 0 : m_chunksBySize.rbegin()->first;
+    }
+
+    /**
+     * Function GetFragmentation()
+     * returns 0.0 when all the free space is contiguous, approaching 1.0 as it is scattered
+     * in small chunks.
+     */
+    double GetFragmentation() const
+    {
+        return m_freeSpace == 0 ? 0.0 : 1.0 - (double) GetLargestChunk() / m_freeSpace;
+    }
+
+    /**
+     * Function Check()
+     * verifies that the free chunks do not overlap and that all the adjacent ones are merged.
+     * @return true if the list is consistent.
+     */
+    bool Check() const;
+
+private:
+    ///> Free chunks as offset -> size
+    std::map<unsigned int, unsigned int> m_chunksByOffset;
+
+    ///> Free chunks as (size, offset), for the best fit lookup
+    std::set< std::pair<unsigned int, unsigned int> > m_chunksBySize;
+
+    ///> Sum of the free chunk sizes
+    unsigned int m_freeSpace;
+};
+} // namespace KIGFX
+
+#endif /* FREE_CHUNK_LIST_H_ */
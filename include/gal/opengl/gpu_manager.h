@@ -80,6 +80,15 @@ public:
      */
     virtual void SetShader( SHADER& aShader );
 
+    /**
+     * Function GetUploadedBytes()
+     * returns the total amount of data sent to the GPU by the manager.
+     */
+    uint64_t GetUploadedBytes() const
+    {
+        return m_uploadedBytes;
+    }
+
 protected:
     GPU_MANAGER( VERTEX_CONTAINER* aContainer );
 
@@ -94,6 +103,9 @@ protected:
 
     ///> Location of shader attributes (for glVertexAttribPointer)
     int m_shaderAttrib;
+
+    ///> Amount of data sent to the GPU
+    uint64_t m_uploadedBytes;
 };
 
 
@@ -139,6 +139,9 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
 
+    /// @copydoc GAL::DrawGlyphs()
+    virtual void DrawGlyphs( const GLYPH_RUN& aGlyphs ) override;
+
     /// @copydoc GAL::DrawPolygon()
     virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
     virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
@@ -218,6 +221,9 @@ public:
     /// @copydoc GAL::ClearCache()
     virtual void ClearCache() override;
 
+    /// @copydoc GAL::GetUploadedBytes()
+    virtual uint64_t GetUploadedBytes() const override;
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
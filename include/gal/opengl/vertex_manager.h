@@ -335,6 +335,12 @@ public:
      */
     void EndDrawing() const;
 
+    /**
+     * Function GetUploadedBytes()
+     * returns the total amount of vertex & index data sent to the GPU so far.
+     */
+    uint64_t GetUploadedBytes() const;
+
 protected:
     /**
      * Function putVertex()
@@ -30,6 +30,8 @@
 #define STROKE_FONT_H_
 
 #include <deque>
+#include <map>
+#include <unordered_map>
 #include <utf8.h>
 
 #include <eda_text.h>
@@ -43,6 +45,9 @@ class GAL;
 typedef std::deque< std::deque<VECTOR2D> > GLYPH;
 typedef std::vector<GLYPH>                 GLYPH_LIST;
 
+///> Glyphs to be drawn together with the positions of their origins
+typedef std::vector< std::pair<const GLYPH*, VECTOR2D> > GLYPH_RUN;
+
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
  *
@@ -59,6 +64,9 @@ public:
     /**
      * @brief Load the new stroke font.
      *
+     * The font data is parsed the first time it is loaded, the following loads share the
+     * parsed glyphs.  It is safe to load fonts from several threads.
+     *
      * @param aNewStrokeFont is the pointer to the font data.
      * @param aNewStrokeFontSize is the size of the font data.
      * @return True, if the font was successfully loaded, else false.
@@ -123,9 +131,66 @@ public:
 
 
 private:
-    GAL*                m_gal;                  ///< Pointer to the GAL
-    GLYPH_LIST          m_glyphs;               ///< Glyph list
-    std::vector<BOX2D>  m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+    GAL*                        m_gal;                  ///< Pointer to the GAL
+
+    ///> Glyph list and bounding boxes of the glyphs.  They are parsed once for each font data
+    ///> and shared read-only by all the STROKE_FONTs, including the ones of other threads.
+    const GLYPH_LIST*           m_glyphs;
+    const std::vector<BOX2D>*   m_glyphBoundingBoxes;
+
+    /**
+     * Struct GLYPH_CACHE_KEY
+     * identifies the transformation applied to the glyphs stored in the glyph cache.
+     */
+    struct GLYPH_CACHE_KEY
+    {
+        VECTOR2D size;          ///< Glyph size (X is negative for mirrored text)
+        bool     italic;
+        bool     mirrored;
+
+        bool operator<( const GLYPH_CACHE_KEY& aOther ) const
+        {
+            if( size.x != aOther.size.x )
+                return size.x < aOther.size.x;
+
+            if( size.y != aOther.size.y )
+                return size.y < aOther.size.y;
+
+            if( italic != aOther.italic )
+                return italic < aOther.italic;
+
+            return mirrored < aOther.mirrored;
+        }
+    };
+
+    ///> Glyphs already scaled and slanted for a given size and style, by glyph index.  Only
+    ///> the glyphs actually drawn are stored.
+    typedef std::unordered_map<int, GLYPH> GLYPH_CACHE;
+
+    ///> Glyph caches by size and style, filled on demand
+    std::map<GLYPH_CACHE_KEY, GLYPH_CACHE> m_glyphCache;
+
+    /**
+     * Function getGlyphCache
+     * returns the cache of transformed glyphs for a glyph size and style. Glyphs are
+     * transformed and added the first time they are requested with getCachedGlyph().
+     * @param aGlyphSize is the glyph size, with negative X for mirrored text.
+     * @param aItalic tells if the glyphs are slanted.
+     * @param aMirrored tells if the text is mirrored.
+     */
+    GLYPH_CACHE& getGlyphCache( const VECTOR2D& aGlyphSize, bool aItalic, bool aMirrored );
+
+    /**
+     * Function getCachedGlyph
+     * returns a glyph from a cache obtained with getGlyphCache(), transforming it if needed.
+     * @param aCache is the cache of transformed glyphs.
+     * @param aIndex is the glyph index.
+     * @param aGlyphSize is the glyph size, with negative X for mirrored text.
+     * @param aItalic tells if the glyph is slanted.
+     * @param aMirrored tells if the text is mirrored.
+     */
+    const GLYPH& getCachedGlyph( GLYPH_CACHE& aCache, int aIndex, const VECTOR2D& aGlyphSize,
+                                 bool aItalic, bool aMirrored ) const;
 
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
@@ -197,6 +262,9 @@ private:
 
     ///> Factor that determines the pitch between 2 lines.
     static const double INTERLINE_PITCH_RATIO;
+
+    ///> Number of glyph sizes kept in the glyph cache before it is flushed.
+    static const unsigned int GLYPH_CACHE_SIZE;
 };
 } // namespace KIGFX
 
@@ -30,6 +30,9 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <vector>
+
 #define ASSERT assert    // RTree uses ASSERT( condition )
 #ifndef rMin
   #define rMin std::min
@@ -167,6 +170,16 @@ public:
     /// Remove all entries from tree
     void    RemoveAll();
 
+    /// Insert many entries at once. An empty tree is packed with the Sort-Tile-Recursive
+    /// algorithm, which is much faster than inserting the entries one by one and gives nodes
+    /// with less overlap. Entries are inserted the usual way into a tree that is not empty.
+    /// \param a_min Mins of bounding rects, NUMDIMS values per entry
+    /// \param a_max Maxs of bounding rects, NUMDIMS values per entry
+    /// \param a_dataIds Ids of data, one per entry
+    /// \param a_count Number of entries
+    void    BulkLoad( const ELEMTYPE* a_min, const ELEMTYPE* a_max, const DATATYPE* a_dataIds,
+                      int a_count );
+
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int     Count();
 
@@ -514,6 +527,9 @@ protected:
 
     void    RemoveAllRec( Node* a_node );
     void    Reset();
+    void    PackBranches( typename std::vector<Branch>::iterator a_first,
+                          typename std::vector<Branch>::iterator a_last,
+                          int a_axis, int a_level, std::vector<Branch>& a_parents );
     void    CountRec( Node* a_node, int& a_count );
 
     bool    SaveRec( Node* a_node, RTFileStream& a_stream );
@@ -1000,6 +1016,99 @@ void RTREE_QUAL::RemoveAll()
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( const ELEMTYPE* a_min, const ELEMTYPE* a_max,
+                           const DATATYPE* a_dataIds, int a_count )
+{
+    if( a_count <= 0 )
+        return;
+
+    if( m_root->m_count > 0 )
+    {
+        for( int index = 0; index < a_count; ++index )
+            Insert( &a_min[index * NUMDIMS], &a_max[index * NUMDIMS], a_dataIds[index] );
+
+        return;
+    }
+
+    std::vector<Branch> branches( a_count );
+
+    for( int index = 0; index < a_count; ++index )
+    {
+        for( int axis = 0; axis < NUMDIMS; ++axis )
+        {
+            branches[index].m_rect.m_min[axis] = a_min[index * NUMDIMS + axis];
+            branches[index].m_rect.m_max[axis] = a_max[index * NUMDIMS + axis];
+        }
+
+        branches[index].m_data = a_dataIds[index];
+    }
+
+    // Pack the entries into leaves, then the nodes of every level into their parents,
+    // until everything fits in the root
+    int level = 0;
+
+    while( branches.size() > (size_t) MAXNODES )
+    {
+        std::vector<Branch> parents;
+        parents.reserve( ( branches.size() + MAXNODES - 1 ) / MAXNODES );
+
+        PackBranches( branches.begin(), branches.end(), 0, level, parents );
+        branches.swap( parents );
+        ++level;
+    }
+
+    RemoveAll();
+    m_root->m_level = level;
+    m_root->m_count = (int) branches.size();
+    std::copy( branches.begin(), branches.end(), m_root->m_branch );
+}
+
+
+// Sort-Tile-Recursive packing: the branches are sorted along an axis and cut into slabs,
+// each slab is packed the same way along the next axis, the last axis is cut into nodes.
+RTREE_TEMPLATE
+void RTREE_QUAL::PackBranches( typename std::vector<Branch>::iterator a_first,
+                               typename std::vector<Branch>::iterator a_last,
+                               int a_axis, int a_level, std::vector<Branch>& a_parents )
+{
+    const size_t count = a_last - a_first;
+    const size_t nodeCount = ( count + MAXNODES - 1 ) / MAXNODES;
+
+    std::sort( a_first, a_last, [a_axis]( const Branch& a, const Branch& b )
+    {
+        return (double) a.m_rect.m_min[a_axis] + a.m_rect.m_max[a_axis]
+               < (double) b.m_rect.m_min[a_axis] + b.m_rect.m_max[a_axis];
+    } );
+
+    if( a_axis == NUMDIMS - 1 )
+    {
+        for( auto it = a_first; it < a_last; it += std::min<size_t>( MAXNODES, a_last - it ) )
+        {
+            Node* node = AllocNode();
+            node->m_level = a_level;
+            node->m_count = (int) std::min<size_t>( MAXNODES, a_last - it );
+            std::copy( it, it + node->m_count, node->m_branch );
+
+            Branch parent;
+            parent.m_rect  = NodeCover( node );
+            parent.m_child = node;
+            a_parents.push_back( parent );
+        }
+
+        return;
+    }
+
+    // Number of slabs, so every remaining axis gets about the same number of cuts
+    size_t slabCount = (size_t) ceil( pow( (double) nodeCount, 1.0 / ( NUMDIMS - a_axis ) ) );
+    size_t slabSize  = MAXNODES * ( ( nodeCount + slabCount - 1 ) / slabCount );
+
+    for( auto it = a_first; it < a_last; it += std::min<size_t>( slabSize, a_last - it ) )
+        PackBranches( it, it + std::min<size_t>( slabSize, a_last - it ), a_axis + 1, a_level,
+                      a_parents );
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::Reset()
 {
@@ -305,9 +305,12 @@ public:
      *  - fonts
      * <p>
      * But nothing relating to DSOs or projects.
+     * @param aSingleInstance is false for the programs which are meant to run several
+     *  times at once, like the command line exporters, they are not asked whether to
+     *  continue when another instance is running.
      * @return bool - true if success, false if failure and program is to terminate.
      */
-    bool InitPgm();
+    bool InitPgm( bool aSingleInstance = true );
 
     // The PGM_* classes can have difficulties at termination if they
     // are not destroyed soon enough.  Relying on a static destructor can be
@@ -33,6 +33,7 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <string>
 #include <math/box2.h>
 #include <drawtxt.h>
 #include <class_page_info.h>
@@ -796,6 +797,9 @@ public:
         pageTreeHandle = 0;
     }
 
+    /// Removes the temporary file of a page stream left open, e.g. if plotting failed
+    virtual ~PDF_PLOTTER();
+
     virtual PlotFormat GetPlotterType() const override
     {
         return PLOT_FORMAT_PDF;
@@ -823,6 +827,32 @@ public:
     virtual void SetCurrentLineWidth( int width, void* aData = NULL ) override;
     virtual void SetDash( bool dashed ) override;
 
+    /**
+     * Starts the document like StartPlot, but without opening the first page:
+     * all the pages are then added with AddPage
+     */
+    bool StartDocument();
+
+    /**
+     * Starts the content of a page plotted without an output file, for instance
+     * on another thread, to be added later to a document with AddPage.
+     * The page settings and the viewport must be set as for StartPage
+     * @param aWorkFilename = the temporary file used to accumulate the content
+     */
+    void StartPageStream( const wxString& aWorkFilename );
+
+    /**
+     * Finishes the page content started by StartPageStream
+     * @return the content, compressed as needed by AddPage
+     */
+    std::string ClosePageStream();
+
+    /**
+     * Adds a page with the content returned by ClosePageStream, using the
+     * current page settings. No page must be open
+     */
+    void AddPage( const std::string& aPageStream );
+
     /** PDF can have multiple pages, so SetPageSettings can be called
      * with the outputFile open (but not inside a page stream!) */
     virtual void SetPageSettings( const PAGE_INFO& aPageSettings ) override;
@@ -865,6 +895,12 @@ protected:
     void closePdfObject();
     int startPdfStream(int handle = -1);
     void closePdfStream();
+    int startPdfStreamObject( int handle = -1 );
+    void closePdfStreamObject( const std::string& aStream );
+    void openWorkFile( const wxString& aWorkFilename );
+    std::string compressWorkFile();
+    void startPageContent();
+    void emitPageObject();
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
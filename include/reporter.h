@@ -162,4 +162,20 @@ class NULL_REPORTER : public REPORTER
         REPORTER& Report( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override;
 };
 
+/**
+ * Class STDIO_REPORTER
+ * reports to the console, for the programs running without a window.  Warnings and
+ * errors go to stderr, everything else to stdout.
+ */
+class STDIO_REPORTER : public REPORTER
+{
+public:
+    STDIO_REPORTER() :
+        REPORTER()
+    {
+    }
+
+    REPORTER& Report( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override;
+};
+
 #endif     // _REPORTER_H_
@@ -0,0 +1,189 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file render_stats.h
+ * @brief Timings and counters of the frames drawn by a VIEW.
+ */
+
+#ifndef RENDER_STATS_H_
+#define RENDER_STATS_H_
+
+#include <deque>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+#include <wx/string.h>
+#include <profile.h>
+
+namespace KIGFX
+{
+
+/**
+ * Class RENDER_STATS
+ * collects the draw time and item counters of every layer, vertex data uploads and tool event
+ * latency for the recent frames. It is available in release builds, but does nothing until
+ * enabled, so slow boards may be diagnosed in the field.
+ */
+class RENDER_STATS
+{
+public:
+    ///> Counters of a single layer (or of a whole frame)
+    struct LAYER_STATS
+    {
+        LAYER_STATS() :
+            time( 0.0 ), drawn( 0 ), culled( 0 ), cacheHits( 0 ), cacheMisses( 0 )
+        {
+        }
+
+        double       time;          ///< Time spent on drawing, in ms
+        unsigned int drawn;         ///< Number of drawn items
+        unsigned int culled;        ///< Items skipped (invisible, too small to be drawn in detail)
+        unsigned int cacheHits;     ///< Items drawn from their cached groups
+        unsigned int cacheMisses;   ///< Items that had to be cached before drawing
+    };
+
+    ///> Statistics of a single frame
+    struct FRAME_STATS
+    {
+        FRAME_STATS() :
+            number( 0 ), time( 0.0 ), redrawTime( 0.0 ), uploadedBytes( 0 ), eventLatency( 0.0 )
+        {
+        }
+
+        unsigned int number;        ///< Frame number
+        double       time;          ///< Whole frame time, in ms
+        double       redrawTime;    ///< Time spent in VIEW::Redraw(), in ms
+        LAYER_STATS  total;         ///< Sum of the layer counters
+        uint64_t     uploadedBytes; ///< Vertex data sent to the GPU
+        double       eventLatency;  ///< Longest tool event handling since the previous frame, in ms
+
+        ///> Counters of the layers that were drawn, by layer id
+        std::vector< std::pair<int, LAYER_STATS> > layers;
+    };
+
+    RENDER_STATS();
+
+    /**
+     * Function SetEnabled()
+     * turns the statistics collection on or off.
+     */
+    void SetEnabled( bool aEnabled );
+
+    /**
+     * Function IsEnabled()
+     * returns true if the statistics are collected.
+     */
+    bool IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    /**
+     * Function Clear()
+     * removes all the collected statistics.
+     */
+    void Clear();
+
+    /**
+     * Function BeginFrame()
+     * starts collecting the statistics of a new frame.
+     */
+    void BeginFrame();
+
+    /**
+     * Function EndFrame()
+     * stores the statistics of the current frame in the history.
+     * @param aUploadedBytes is the total amount of data sent to the GPU so far
+     * (see GAL::GetUploadedBytes()).
+     */
+    void EndFrame( uint64_t aUploadedBytes );
+
+    /**
+     * Function Layer()
+     * returns the counters of a layer in the current frame. Valid only between BeginFrame()
+     * and EndFrame().
+     */
+    LAYER_STATS& Layer( int aLayer )
+    {
+        return m_layers[aLayer];
+    }
+
+    /**
+     * Function AddRedrawTime()
+     * adds time spent in VIEW::Redraw() to the current frame.
+     */
+    void AddRedrawTime( double aMsecs )
+    {
+        m_current.redrawTime += aMsecs;
+    }
+
+    /**
+     * Function AddEventLatency()
+     * records the time it took to handle a tool event.
+     */
+    void AddEventLatency( double aMsecs );
+
+    /**
+     * Function GetHistory()
+     * returns the statistics of the recent frames, the most recent one at the end.
+     */
+    const std::deque<FRAME_STATS>& GetHistory() const
+    {
+        return m_history;
+    }
+
+    /**
+     * Function FormatSummary()
+     * returns a short multiline description of the last frames, to be displayed on the canvas.
+     */
+    wxString FormatSummary() const;
+
+    /**
+     * Function ExportCSV()
+     * writes the frame history to a CSV file, one line per frame total and per drawn layer.
+     * @param aFileName is the output file name.
+     * @throw IO_ERROR if the file cannot be written.
+     */
+    void ExportCSV( const wxString& aFileName ) const;
+
+    ///> Number of frames kept in the history
+    static const unsigned int HISTORY_SIZE;
+
+private:
+    bool                        m_enabled;
+    bool                        m_inFrame;
+    unsigned int                m_frameCount;
+    uint64_t                    m_lastUploadedBytes;    ///< To compute the per frame uploads
+    double                      m_pendingLatency;       ///< Event latency since the last frame
+
+    PROF_COUNTER                m_frameTimer;
+    FRAME_STATS                 m_current;
+    std::map<int, LAYER_STATS>  m_layers;
+    std::deque<FRAME_STATS>     m_history;
+};
+
+} // namespace KIGFX
+
+#endif /* RENDER_STATS_H_ */
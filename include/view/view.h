@@ -30,7 +30,9 @@
 #include <unordered_map>
 
 #include <math/box2.h>
+#include <math/matrix3x3.h>
 #include <gal/definitions.h>
+#include <view/render_stats.h>
 
 namespace KIGFX
 {
@@ -83,6 +85,15 @@ public:
      */
     void Add( VIEW_ITEM* aItem );
 
+    /**
+     * Function AddItems()
+     * Adds many VIEW_ITEMs to the view at once, e.g. when a whole board is loaded.
+     * The layer R-trees are bulk loaded instead of growing item by item. As with Add(), the
+     * items are cached in the GAL by the next UpdateItems().
+     * @param aItems: items to be added. No ownership is given
+     */
+    void AddItems( const std::vector<VIEW_ITEM*>& aItems );
+
     /**
      * Function Remove()
      * Removes a VIEW_ITEM from the view.
@@ -155,8 +166,7 @@ public:
     void CopySettings( const VIEW* aOtherView );
 
     /*
-     *  Convenience wrappers for adding multiple items
-     *  template <class T> void AddItems( const T& aItems );
+     *  Convenience wrappers for removing multiple items
      *  template <class T> void RemoveItems( const T& aItems );
      */
 
@@ -298,6 +308,109 @@ public:
         m_maxScale = aMaximum;
     }
 
+    /**
+     * Function SetLODThreshold()
+     * Sets the screen size below which items are not drawn in detail. Such items are merged
+     * into filled cells of the same size, one per screen area, which keeps zoomed out views
+     * of dense boards fast. Overlay layers are not affected.
+     * @param aPixels is the threshold in screen pixels, 0 draws every item in full detail.
+     */
+    void SetLODThreshold( double aPixels )
+    {
+        m_lodThreshold = aPixels;
+        MarkDirty();
+    }
+
+    /**
+     * Function GetLODThreshold()
+     * @return The screen size (in pixels) below which items are drawn as simplified cells.
+     */
+    double GetLODThreshold() const
+    {
+        return m_lodThreshold;
+    }
+
+    /**
+     * Function SetParallelRendering()
+     * Enables handing over consecutive cached layers to the GAL at once, so GALs that support
+     * it (see GAL::IsParallelRenderingSupported()) rasterize them on several threads.
+     * @param aEnabled tells if the parallel rendering should be used.
+     */
+    void SetParallelRendering( bool aEnabled )
+    {
+        m_parallelRendering = aEnabled;
+        MarkDirty();
+    }
+
+    /**
+     * Function IsParallelRendering()
+     * @return True if the cached layers are handed over to the GAL for parallel rendering.
+     */
+    bool IsParallelRendering() const
+    {
+        return m_parallelRendering;
+    }
+
+    /**
+     * Function SetProgressiveRedraw()
+     * Enables spreading redraws of the cached and noncached targets over several frames, so
+     * input is processed meanwhile. Each Redraw() call draws layers in the rendering order until
+     * its time budget is used up, while the GAL keeps displaying the previous image moved to
+     * the current viewport until the redraw is complete. Any change of the targets starts the
+     * redraw over. Only enable it for GALs for which GAL::IsTargetPreviewSupported() is true.
+     * @param aEnabled tells if the redraws should be progressive.
+     */
+    void SetProgressiveRedraw( bool aEnabled );
+
+    /**
+     * Function IsProgressiveRedraw()
+     * @return True if redraws are spread over several frames.
+     */
+    bool IsProgressiveRedraw() const
+    {
+        return m_progressiveRedraw;
+    }
+
+    /**
+     * Function SetRedrawBudget()
+     * Sets the time a single Redraw() call may spend drawing layers when the redraw is
+     * progressive. At least one layer is drawn per call, whatever the budget is.
+     * @param aMilliseconds is the time budget in milliseconds.
+     */
+    void SetRedrawBudget( double aMilliseconds )
+    {
+        m_redrawBudget = aMilliseconds;
+    }
+
+    /**
+     * Function GetRedrawBudget()
+     * @return The time (in milliseconds) a single progressive Redraw() call may spend.
+     */
+    double GetRedrawBudget() const
+    {
+        return m_redrawBudget;
+    }
+
+    /**
+     * Function IsRedrawPending()
+     * @return True if a progressive redraw has not drawn all layers yet, so Redraw() has to be
+     * called again.
+     */
+    bool IsRedrawPending() const
+    {
+        return m_redrawPending;
+    }
+
+    /**
+     * Function GetRenderStats()
+     * Returns the rendering statistics collector. Statistics of the layers drawn by Redraw()
+     * are gathered when it is enabled, the frame boundaries are set by the VIEW owner.
+     */
+    RENDER_STATS& GetRenderStats()
+    {
+        return m_renderStats;
+    }
+
     /**
      * Function SetCenter()
      * Sets the center point of the VIEW (i.e. the point in world space that will be drawn in the middle
@@ -522,7 +635,8 @@ public:
 
     /**
      * Function RecacheAllItems()
-     * Rebuilds GAL display lists.
+     * Rebuilds GAL display lists. The lists are dropped at once and regenerated by the next
+     * UpdateItems() call.
      */
     void RecacheAllItems();
 
@@ -549,7 +663,7 @@ public:
                 return true;
         }
 
-        return false;
+        return !m_dirtyAreas.empty() || m_redrawPending;
     }
 
     /**
@@ -639,7 +753,6 @@ private:
 
     // Function objects that need to access VIEW/VIEW_ITEM private/protected members
     struct clearLayerCache;
-    struct recacheItem;
     struct drawItem;
     struct unlinkItem;
     struct updateItemsColor;
@@ -647,8 +760,42 @@ private:
     struct extentsVisitor;
 
 
-    ///* Redraws contents within rect aRect
-    void redrawRect( const BOX2I& aRect );
+    /**
+     * Function redrawRect()
+     * Redraws contents within rect aRect.
+     *
+     * @param aRect is the area to be redrawn, in world coordinates.
+     * @param aDirtyArea tells that aRect is a dirty area of the cached and noncached targets,
+     * so their layers are drawn regardless of the target dirty flags.
+     * @param aFirstLayer is the index (in m_orderedLayers) of the first cached or noncached
+     * layer to be drawn, the previous ones were drawn by an earlier progressive redraw.
+     * @param aTimeBudget is the time (in milliseconds) after which no more cached and noncached
+     * layers are drawn, 0 draws all of them.
+     * @return Index of the first cached or noncached layer left undrawn, or the number of
+     * layers if all of them were drawn.
+     */
+    unsigned int redrawRect( const BOX2I& aRect, bool aDirtyArea = false,
+                             unsigned int aFirstLayer = 0, double aTimeBudget = 0.0 );
+
+    /**
+     * Function markAreaDirty()
+     * Marks an area of a target as changed. GALs that keep the rendered image between frames
+     * redraw only the changed areas, for the others the whole target is marked dirty.
+     *
+     * @param aTarget is the target containing the area.
+     * @param aArea is the changed area, in world coordinates.
+     */
+    void markAreaDirty( int aTarget, const BOX2I& aArea );
+
+    /// Marks an area of the cached and noncached targets, given in screen pixels, as changed
+    void markScreenAreaDirty( const BOX2D& aArea );
+
+    /// Redraws the screen tiles covered by the dirty areas
+    void redrawDirtyAreas();
+
+    /// Displays the last complete image moved to the current viewport, before the cached and
+    /// noncached targets are cleared for a progressive redraw
+    void showRedrawPreview();
 
     inline void markTargetClean( int aTarget )
     {
@@ -701,8 +848,9 @@ private:
      * Manages dirty flags & redraw queueing when updating an item.
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aBBox is the new bounding box of the item, used for GEOMETRY and LAYERS updates.
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags, const BOX2I& aBBox );
 
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
@@ -710,11 +858,11 @@ private:
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
-    /// Updates bounding box of an item
-    void updateBbox( VIEW_ITEM* aItem );
+    /// Moves an item to its new bounding box aBBox in the R-trees
+    void updateBbox( VIEW_ITEM* aItem, const BOX2I& aBBox );
 
-    /// Updates set of layers that an item occupies
-    void updateLayers( VIEW_ITEM* aItem );
+    /// Updates set of layers that an item occupies, indexing it with bounding box aBBox
+    void updateLayers( VIEW_ITEM* aItem, const BOX2I& aBBox );
 
     /// Determines rendering order of layers. Used in display order sorting function.
     static bool compareRenderingOrder( VIEW_LAYER* aI, VIEW_LAYER* aJ )
@@ -758,6 +906,33 @@ private:
     ///> Vertical flip flag
     bool m_mirrorY;
 
+    /// Screen size (in pixels) below which items are drawn as simplified cells
+    double m_lodThreshold;
+
+    /// Hand over consecutive cached layers to the GAL for parallel rendering
+    bool m_parallelRendering;
+
+    /// Spread redraws of the cached and noncached targets over several frames
+    bool m_progressiveRedraw;
+
+    /// Time (in milliseconds) a single progressive Redraw() call may spend
+    double m_redrawBudget;
+
+    /// A progressive redraw has not drawn all layers yet
+    bool m_redrawPending;
+
+    /// Index (in m_orderedLayers) of the layer a pending progressive redraw continues with
+    unsigned int m_redrawLayer;
+
+    /// World to screen transformation of the last complete image
+    MATRIX3x3D m_imageMatrix;
+
+    /// The last complete image is still kept by the GAL, in the targets or as a preview
+    bool m_imageValid;
+
+    /// Rendering statistics
+    RENDER_STATS m_renderStats;
+
     /// PAINTER contains information how do draw items
     PAINTER* m_painter;
 
@@ -774,6 +949,15 @@ private:
     /// Rendering order modifier for layers that are marked as top layers
     static const int TOP_LAYER_MODIFIER;
 
+    /// Size (in pixels) of the screen tiles that dirty areas are rounded up to
+    static const int DIRTY_TILE_SIZE;
+
+    /// Number of dirty areas above which the whole target is redrawn instead
+    static const unsigned int MAX_DIRTY_AREAS;
+
+    /// Changed areas (in world coordinates) of the cached and noncached targets
+    std::vector<BOX2I> m_dirtyAreas;
+
     /// Flat list of all items
     std::vector<VIEW_ITEM*> m_allItems;
 };
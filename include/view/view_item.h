@@ -56,6 +56,7 @@ enum VIEW_UPDATE_FLAGS {
     COLOR       = 0x02,     /// Color has changed
     GEOMETRY    = 0x04,     /// Position or shape has changed
     LAYERS      = 0x08,     /// Layers have changed
+    REPAINT     = 0x10,     /// Cached geometry has to be regenerated
     ALL         = 0xff
 };
 
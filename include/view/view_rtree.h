@@ -29,6 +29,8 @@
 
 #include <geometry/rtree.h>
 
+#include <vector>
+
 namespace KIGFX
 {
 typedef RTree<VIEW_ITEM*, int, 2, float> VIEW_RTREE_BASE;
@@ -48,13 +50,46 @@ public:
      */
     void Insert( VIEW_ITEM* aItem )
     {
-        const BOX2I&    bbox    = aItem->ViewBBox();
-        const int       mmin[2] = { bbox.GetX(), bbox.GetY() };
-        const int       mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+        Insert( aItem, aItem->ViewBBox() );
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item into the tree using an already computed bounding box.
+     */
+    void Insert( VIEW_ITEM* aItem, const BOX2I& aBBox )
+    {
+        const int       mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int       mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
 
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Inserts many items at once. An empty tree is packed in a single pass, which is much faster
+     * than inserting the items one by one.
+     * @param aItems are the items with their already computed bounding boxes.
+     */
+    void BulkLoad( const std::vector< std::pair<VIEW_ITEM*, BOX2I> >& aItems )
+    {
+        std::vector<int>        mins( aItems.size() * 2 ), maxs( aItems.size() * 2 );
+        std::vector<VIEW_ITEM*> ids( aItems.size() );
+
+        for( unsigned i = 0; i < aItems.size(); ++i )
+        {
+            const BOX2I& bbox = aItems[i].second;
+
+            mins[2 * i]     = bbox.GetX();
+            mins[2 * i + 1] = bbox.GetY();
+            maxs[2 * i]     = bbox.GetRight();
+            maxs[2 * i + 1] = bbox.GetBottom();
+            ids[i]          = aItems[i].first;
+        }
+
+        VIEW_RTREE_BASE::BulkLoad( mins.data(), maxs.data(), ids.data(), (int) aItems.size() );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
@@ -71,6 +106,19 @@ public:
         VIEW_RTREE_BASE::Remove( mmin, mmax, aItem );
     }
 
+    /**
+     * Function Remove()
+     * Removes an item from the tree, searching only the nodes that overlap aBBox. It has to be
+     * the bounding box the item was inserted with, otherwise the item will not be found.
+     */
+    void Remove( VIEW_ITEM* aItem, const BOX2I& aBBox )
+    {
+        const int       mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int       mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+        VIEW_RTREE_BASE::Remove( mmin, mmax, aItem );
+    }
+
     /**
      * Function Query()
      * Executes a function object aVisitor for each item whose bounding box intersects
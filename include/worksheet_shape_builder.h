@@ -665,6 +665,7 @@ public:
     /**
      * Save the description in a file
      * @param aFullFileName the filename of the file to created
+     * @throw IO_ERROR if the file cannot be written
      */
     void Save( const wxString& aFullFileName );
 
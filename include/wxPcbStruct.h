@@ -34,6 +34,7 @@
 #include <config_params.h>
 #include <class_undoredo_container.h>
 #include <zones.h>
+#include <memory>
 
 
 /*  Forward declarations of classes. */
@@ -65,6 +66,7 @@ class REPORTER;
 struct PARSE_ERROR;
 class IO_ERROR;
 class FP_LIB_TABLE;
+class BOARD_SAVE_JOB;
 
 namespace PCB { struct IFACE; }     // KIFACE_I is in pcbnew.cpp
 
@@ -98,6 +100,8 @@ protected:
 
     wxString          m_lastNetListRead;        ///< Last net list read with relative path.
 
+    std::unique_ptr<BOARD_SAVE_JOB> m_saveJob;  ///< The board save running in background, if any.
+
     // The Tool Framework initalization
     void setupTools();
 
@@ -191,12 +195,24 @@ protected:
     /**
      * Function doAutoSave
      * performs auto save when the board has been modified and not saved within the
-     * auto save interval.
+     * auto save interval.  The file is written in background, see finishBoardSave().
      *
-     * @return true if the auto save was successful.
+     * @return true if the auto save was successfully started.
      */
     virtual bool doAutoSave() override;
 
+    /**
+     * Function finishBoardSave
+     * waits for the background board save, if any, and reports its result: the message
+     * panel is updated, or an error is displayed and the board is marked modified.
+     *
+     * @return false if the background save failed.
+     */
+    bool finishBoardSave();
+
+    /// Event handler for EVT_BOARD_SAVE_DONE, see finishBoardSave().
+    void onBoardSaveDone( wxCommandEvent& aEvent );
+
     /**
      * Function isautoSaveRequired
      * returns true if the board has been modified.
@@ -863,9 +879,13 @@ public:
      * @param aCreateBackupFile Creates a back of \a aFileName if true.  Helper
      *                          definitions #CREATE_BACKUP_FILE and #NO_BACKUP_FILE
      *                          are defined for improved code readability.
-     * @return True if file was saved successfully.
+     * @param aInBackground Writes a snapshot of the board on a worker thread so editing
+     *                      can go on during the save.  The result is reported when the
+     *                      save is done, see finishBoardSave().
+     * @return True if file was saved successfully, or if the background save was started.
      */
-    bool SavePcbFile( const wxString& aFileName, bool aCreateBackupFile = CREATE_BACKUP_FILE );
+    bool SavePcbFile( const wxString& aFileName, bool aCreateBackupFile = CREATE_BACKUP_FILE,
+                      bool aInBackground = false );
 
     /**
      * Function SavePcbCopy
@@ -0,0 +1,165 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef XML_STREAM_H_
+#define XML_STREAM_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <ptree.h>
+
+/**
+ * Class XML_STREAM
+ * is a pull reader for XML files which reads the file in blocks instead of loading
+ * it at once.  It lets a caller walk a large document element by element and turn
+ * only the elements it is interested in into a PTREE, which has the same layout as
+ * one made by boost::property_tree::read_xml() with the no_comments flag: attributes
+ * are children of a "<xmlattr>" node and the text content is the node data.  Code
+ * written for read_xml() documents can then be reused on each element.
+ * <p>
+ * Comments, processing instructions and the DOCTYPE declaration are skipped.
+ * Errors are thrown as boost::property_tree::xml_parser::xml_parser_error, with the file name
+ * and line number.
+ * <p>
+ * Typical usage, reading all the children of the root element one at a time:
+ * <code>
+ *  XML_STREAM  xml( filename );
+ *
+ *  if( xml.NextChild() )           // the root element
+ *  {
+ *      while( xml.NextChild() )    // its children
+ *      {
+ *          PTREE   tree;
+ *          CPTREE& child = xml.ReadElement( tree );
+ *          ...
+ *      }
+ *  }
+ * </code>
+ */
+class XML_STREAM
+{
+public:
+    /**
+     * Constructor
+     * opens \a aFileName for reading.
+     * @param aFileName is encoded according to the file system, as in read_xml().
+     * @throw boost::property_tree::xml_parser::xml_parser_error if the file cannot be opened.
+     */
+    XML_STREAM( const std::string& aFileName );
+
+    ~XML_STREAM();
+
+    /**
+     * Function NextChild
+     * reads up to the next child element start tag of the current element, skipping
+     * text.  The child becomes the current element.  It must then be walked to its end
+     * with NextChild(), or read with ReadElement() or SkipElement().
+     *
+     * @return true if a child start tag was read, false if the end tag of the current
+     *         element was read instead, or the end of the document was reached.
+     */
+    bool NextChild();
+
+    /**
+     * Function ReadElement
+     * reads the rest of the element whose start tag was just read by NextChild(), and
+     * appends it to \a aParent.
+     * @return the new child of aParent holding the element.
+     */
+    PTREE& ReadElement( PTREE& aParent );
+
+    /**
+     * Function SkipElement
+     * skips the rest of the element whose start tag was just read by NextChild().
+     */
+    void SkipElement();
+
+    /// @return the name of the element whose start or end tag was read last.
+    const std::string& Name() const { return m_name; }
+
+    int LineNumber() const { return m_line; }
+
+private:
+    enum TOKEN
+    {
+        T_START,        ///< an element start tag, m_name and m_attributes are set
+        T_END,          ///< an element end tag, m_name is set
+        T_TEXT,         ///< text or CDATA content, m_text is set
+        T_EOF
+    };
+
+    typedef std::vector< std::pair<std::string, std::string> > ATTRIBUTES;
+
+    TOKEN next();
+
+    int peek()
+    {
+        if( m_pos == m_len && !fill() )
+            return EOF;
+
+        return (unsigned char) m_buffer[m_pos];
+    }
+
+    int get()
+    {
+        int c = peek();
+
+        if( c != EOF )
+        {
+            ++m_pos;
+
+            if( c == '\n' )
+                ++m_line;
+        }
+
+        return c;
+    }
+
+    bool fill();
+    void skipSpace();
+    void expect( char aChar );
+    void readName( std::string& aName );
+    void readUntil( const char* aTerminator, std::string* aOut );
+    void skipDeclaration();
+    void decode( const std::string& aRaw, std::string& aOut );
+    void error( const char* aMessage );
+
+    FILE*               m_fp;
+    std::string         m_fileName;
+    int                 m_line;
+
+    std::vector<char>   m_buffer;       ///< block of the file being parsed
+    size_t              m_pos;          ///< next char in m_buffer
+    size_t              m_len;          ///< valid chars in m_buffer
+
+    int                 m_depth;        ///< number of open elements
+    bool                m_pendingEnd;   ///< last start tag was an empty element <x/>
+
+    std::string         m_name;
+    ATTRIBUTES          m_attributes;
+    std::string         m_text;
+    std::string         m_raw;          ///< scratch buffer for undecoded text
+};
+
+#endif  // XML_STREAM_H_
@@ -248,7 +248,16 @@ bool PL_EDITOR_FRAME::SavePageLayoutDescrFile( const wxString& aFullFileName )
 {
     if( ! aFullFileName.IsEmpty() )
     {
-        WORKSHEET_LAYOUT::GetTheInstance().Save( aFullFileName );
+        try
+        {
+            WORKSHEET_LAYOUT::GetTheInstance().Save( aFullFileName );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxMessageBox( ioe.What(), _( "Error writing page layout descr file" ) );
+            return false;
+        }
+
         GetScreen()->ClrModify();
         return true;
     }
@@ -95,6 +95,8 @@ public:
     WORKSHEET_LAYOUT_FILEIO( const wxString& aFilename ):
         WORKSHEET_LAYOUT_IO()
     {
+        m_fileout = NULL;
+
         try
         {
             m_fileout = new FILE_OUTPUTFORMATTER( aFilename );
@@ -110,6 +112,13 @@ public:
     {
         delete m_fileout;
     }
+
+    /// Writes the buffered output and closes the file, throws IO_ERROR on failure
+    void Finish() throw( IO_ERROR )
+    {
+        if( m_fileout )
+            m_fileout->Finish();
+    }
 };
 
 
@@ -149,6 +158,7 @@ void WORKSHEET_LAYOUT::Save( const wxString& aFullFileName )
 {
     WORKSHEET_LAYOUT_FILEIO writer( aFullFileName );
     writer.Format( this );
+    writer.Finish();
 }
 
 
@@ -0,0 +1,75 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+#include <io_mgr.h>
+#include <class_board.h>
+#include <board_save_job.h>
+
+
+wxDEFINE_EVENT( EVT_BOARD_SAVE_DONE, wxCommandEvent );
+
+
+BOARD_SAVE_JOB::BOARD_SAVE_JOB( BOARD* aSnapshot, const wxString& aFileName,
+                                wxEvtHandler* aHandler ) :
+    m_UpdateHistory( false ),
+    m_board( aSnapshot ),
+    m_fileName( aFileName ),
+    m_handler( aHandler )
+{
+    // Start the thread last, all the members it uses must be initialized.
+    m_thread = std::thread( &BOARD_SAVE_JOB::run, this );
+}
+
+
+BOARD_SAVE_JOB::~BOARD_SAVE_JOB()
+{
+    Wait();
+}
+
+
+void BOARD_SAVE_JOB::Wait()
+{
+    if( m_thread.joinable() )
+        m_thread.join();
+}
+
+
+void BOARD_SAVE_JOB::run()
+{
+    try
+    {
+        PLUGIN::RELEASER    pi( IO_MGR::PluginFind( IO_MGR::KICAD ) );
+
+        pi->Save( m_fileName, m_board.get(), NULL );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        m_error = ioe.What();
+    }
+
+    // Free the snapshot here rather than on the GUI thread.
+    m_board.reset();
+
+    wxQueueEvent( m_handler, new wxCommandEvent( EVT_BOARD_SAVE_DONE ) );
+}
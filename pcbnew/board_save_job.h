@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef BOARD_SAVE_JOB_H
+#define BOARD_SAVE_JOB_H
+
+#include <memory>
+#include <thread>
+#include <wx/event.h>
+#include <wx/string.h>
+
+class BOARD;
+
+/// Queued to the handler of a BOARD_SAVE_JOB when its worker thread is done.
+wxDECLARE_EVENT( EVT_BOARD_SAVE_DONE, wxCommandEvent );
+
+/**
+ * Class BOARD_SAVE_JOB
+ * writes a board snapshot (see BOARD::Snapshot()) to a file on a worker thread,
+ * so the board being edited is not blocked during the save.
+ * <p>
+ * When the file is written, or the save failed, an #EVT_BOARD_SAVE_DONE event is
+ * queued to the handler given to the constructor.  Call Wait() before reading the
+ * result with GetError().
+ * <p>
+ * The "C" locale needed to write numbers is set by the plugin on the worker thread
+ * only (see LOCALE_IO), the locale of the GUI thread is left alone during the save.
+ */
+class BOARD_SAVE_JOB
+{
+public:
+    /**
+     * Constructor
+     * starts writing \a aSnapshot to \a aFileName on a worker thread.
+     *
+     * @param aSnapshot is the board to write, the job takes ownership.  It must not be
+     *                  shared with anything used by other threads.
+     * @param aFileName is the full path of the board file to write.
+     * @param aHandler receives #EVT_BOARD_SAVE_DONE when the job is done.
+     */
+    BOARD_SAVE_JOB( BOARD* aSnapshot, const wxString& aFileName, wxEvtHandler* aHandler );
+
+    /// Waits for the worker thread if it is still running.
+    ~BOARD_SAVE_JOB();
+
+    /**
+     * Function Wait
+     * blocks until the worker thread has finished.
+     */
+    void Wait();
+
+    const wxString& GetFileName() const { return m_fileName; }
+
+    /**
+     * Function GetError
+     * @return the error message if the save failed, or an empty string.  Only valid
+     *         after Wait().
+     */
+    const wxString& GetError() const { return m_error; }
+
+    wxString    m_BackupFileName;   ///< backup file made before the save, if any
+    bool        m_UpdateHistory;    ///< add the file to the file history once saved
+
+private:
+    void run();
+
+    std::unique_ptr<BOARD>  m_board;
+    wxString                m_fileName;
+    wxString                m_error;
+    wxEvtHandler*           m_handler;  ///< no ownership
+    std::thread             m_thread;
+};
+
+#endif  // BOARD_SAVE_JOB_H
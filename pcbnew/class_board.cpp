@@ -2869,6 +2869,124 @@ BOARD_ITEM* BOARD::Duplicate( const BOARD_ITEM* aItem,
 }
 
 
+BOARD* BOARD::Snapshot() const
+{
+    // The snapshot is only written to a file.  Its items are not registered in its
+    // ratsnest, which stays empty, but ~BOARD() still needs one to remove them from.
+    BOARD* copy = new BOARD();
+
+    copy->m_fileName                = m_fileName;
+    copy->m_fileFormatVersionAtLoad = m_fileFormatVersionAtLoad;
+    copy->m_BoundingBox             = m_BoundingBox;
+    copy->m_zoneSettings            = m_zoneSettings;
+    copy->m_paper                   = m_paper;
+    copy->m_titles                  = m_titles;
+    copy->m_plotOptions             = m_plotOptions;
+    copy->m_nodeCount               = m_nodeCount;
+    copy->m_unconnectedNetCount     = m_unconnectedNetCount;
+
+    // Only the size of the ratsnest list is saved.
+    copy->m_FullRatsnest            = m_FullRatsnest;
+
+    for( int layer = 0;  layer < LAYER_ID_COUNT;  ++layer )
+        copy->m_Layer[layer] = m_Layer[layer];
+
+    // The net classes are shared by pointer, give the snapshot its own copies.
+    copy->m_designSettings = m_designSettings;
+
+    NETCLASSES& netclasses = copy->m_designSettings.m_NetClasses;
+
+    netclasses.Clear();
+    netclasses.Add( std::make_shared<NETCLASS>( *m_designSettings.GetDefault() ) );
+
+    for( NETCLASSES::const_iterator it = m_designSettings.m_NetClasses.begin();
+         it != m_designSettings.m_NetClasses.end();  ++it )
+    {
+        netclasses.Add( std::make_shared<NETCLASS>( *it->second ) );
+    }
+
+    // Copy the nets in net code order.  NETINFO_LIST renumbers them if there are
+    // gaps, so keep a map from the original codes to the snapshot ones.
+    std::map<int, NETINFO_ITEM*> nets;
+    std::map<int, int>           netcodes;
+
+    for( NETINFO_LIST::iterator net = m_NetInfo.begin();  net != m_NetInfo.end();  ++net )
+        nets[net->GetNet()] = *net;
+
+    netcodes[NETINFO_LIST::UNCONNECTED] = NETINFO_LIST::UNCONNECTED;
+
+    for( std::map<int, NETINFO_ITEM*>::const_iterator it = nets.begin();  it != nets.end();  ++it )
+    {
+        if( it->first == NETINFO_LIST::UNCONNECTED )
+            continue;
+
+        NETINFO_ITEM* netcopy = new NETINFO_ITEM( copy, it->second->GetNetname(), it->first );
+
+        copy->m_NetInfo.AppendNet( netcopy );
+        netcodes[it->first] = netcopy->GetNet();
+    }
+
+    // Items are cloned with pointers to the nets of this board, rebind them.
+    auto rebind = [&]( BOARD_CONNECTED_ITEM* aItem )
+    {
+        std::map<int, int>::const_iterator code = netcodes.find( aItem->GetNetCode() );
+
+        aItem->SetNetCode( code != netcodes.end() ? code->second : NETINFO_LIST::ORPHANED );
+    };
+
+    for( MODULE* module = m_Modules;  module;  module = module->Next() )
+    {
+        MODULE* clone = new MODULE( *module );
+
+        copy->m_Modules.PushBack( clone );
+        clone->SetParent( copy );
+
+        for( D_PAD* pad = clone->Pads();  pad;  pad = pad->Next() )
+            rebind( pad );
+    }
+
+    for( BOARD_ITEM* item = m_Drawings;  item;  item = item->Next() )
+    {
+        BOARD_ITEM* clone = static_cast<BOARD_ITEM*>( item->Clone() );
+
+        copy->m_Drawings.PushBack( clone );
+        clone->SetParent( copy );
+    }
+
+    for( TRACK* track = m_Track;  track;  track = track->Next() )
+    {
+        TRACK* clone = static_cast<TRACK*>( track->Clone() );
+
+        copy->m_Track.PushBack( clone );
+        clone->SetParent( copy );
+        rebind( clone );
+    }
+
+    for( SEGZONE* segzone = m_Zone;  segzone;  segzone = segzone->Next() )
+    {
+        SEGZONE* clone = static_cast<SEGZONE*>( segzone->Clone() );
+
+        copy->m_Zone.PushBack( clone );
+        clone->SetParent( copy );
+        rebind( clone );
+    }
+
+    for( unsigned i = 0;  i < m_ZoneDescriptorList.size();  ++i )
+    {
+        ZONE_CONTAINER* clone = new ZONE_CONTAINER( *m_ZoneDescriptorList[i] );
+
+        copy->m_ZoneDescriptorList.push_back( clone );
+        clone->SetParent( copy );
+        rebind( clone );
+    }
+
+    // Node counts of the nets are needed to filter the saved net classes.
+    copy->BuildListOfNets();
+
+    return copy;
+}
+
+
 /* Extracts the board outlines and build a closed polygon
  * from lines, arcs and circle items on edge cut layer
  * Any closed outline inside the main outline is a hole
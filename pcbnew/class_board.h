@@ -280,6 +280,17 @@ public:
 
     BOARD_ITEM* Duplicate( const BOARD_ITEM* aItem, bool aAddToBoard = false );
 
+    /**
+     * Function Snapshot
+     * creates a detached copy of the board holding clones of everything written to a
+     * board file: settings, nets, net classes, modules, drawings, tracks and zones.
+     * Nothing is shared with this board, so the copy can be saved by a worker thread
+     * while this board is being edited.  Markers are not copied and the copy has no
+     * ratsnest.
+     * @return BOARD* - the new board, owned by the caller.
+     */
+    BOARD* Snapshot() const;
+
     /**
      * Function GetRatsnest()
      * returns list of missing connections between components/tracks.
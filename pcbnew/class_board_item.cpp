@@ -88,82 +88,45 @@ wxString BOARD_ITEM::GetLayerName() const
 
 std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 {
-#if 1
-
-    char    buf[50];
-    int     len;
-    double  mm = aValue / IU_PER_MM;
-
-    if( mm != 0.0 && fabs( mm ) <= 0.0001 )
-    {
-        len = sprintf( buf, "%.10f", mm );
-
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
-
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
-            ++len;
-    }
-    else
+    // aValue is in nanometers and the result is wanted in millimeters, so the conversion
+    // is exact in decimal.  Build the digits right to left, inserting the decimal point
+    // 6 positions from the end and dropping trailing zeros.  This gives the same text as
+    // the former "%.10g" sprintf() based algorithm without any floating point formatting,
+    // which is a large part of the cost of saving a board.
+    static_assert( IU_PER_MM == 1e6, "FormatInternalUnits() expects nanometer internal units" );
+
+    char        buf[24];
+    char*       end = buf + sizeof( buf );
+    char*       p = end;
+    unsigned    value = aValue < 0 ? 0u - (unsigned) aValue : (unsigned) aValue;
+    bool        trailing = true;    // still dropping trailing zeros of the fraction
+
+    for( int i = 0;  i < 6;  ++i )
     {
-        len = sprintf( buf, "%.10g", mm );
-    }
+        int digit = value % 10;
 
-    return std::string( buf, len );
+        value /= 10;
 
-#else
+        if( trailing && digit == 0 )
+            continue;
 
-    // Assume aValue is in nanometers, and that we want the result in millimeters,
-    // and that int is 32 bits wide.  Then perform an alternative algorithm.
-    // Can be used to verify that the above algorithm is correctly generating text.
-    // Convert aValue into an integer string, then insert a decimal point manually.
-    // Results are the same as above general purpose algorithm.
+        trailing = false;
+        *--p = '0' + digit;
+    }
 
-    wxASSERT( sizeof(int) == 4 );
+    if( !trailing )
+        *--p = '.';
 
-    if( aValue == 0 )
-        return std::string( 1, '0' );
-    else
+    do
     {
-        char    buf[50];
-        int     len = sprintf( buf, aValue > 0 ? "%06d" : "%07d", aValue );     // optionally pad w/leading zeros
+        *--p = '0' + value % 10;
+        value /= 10;
+    } while( value );
 
-        std::string ret( buf, len );
-
-        std::string::iterator it = ret.end() - 1;           // last byte
-
-        // insert '.' at 6 positions from end, dividing by 10e6 (a million), nm => mm
-        std::string::iterator decpoint = ret.end() - 6;
-
-        // truncate trailing zeros, up to decimal point position
-        for(  ; *it=='0' && it >= decpoint;  --it )
-            ret.erase( it );    // does not invalidate iterators it or decpoint
-
-        if( it >= decpoint )
-        {
-            ret.insert( decpoint, '.' );
-
-            // decpoint is invalidated here, after insert()
-
-#if 1       // want a leading zero when decimal point is in first position?
-            if( ret[0] == '.' )
-            {
-                // insert leading zero ahead of decimal point.
-                ret.insert( ret.begin(), '0' );
-            }
-            else if( ret[0]=='-' && ret[1]=='.' )
-            {
-                ret.insert( ret.begin() + 1, '0' );
-            }
-#endif
-        }
-
-        return ret;
-    }
+    if( aValue < 0 )
+        *--p = '-';
 
-#endif
+    return std::string( p, end - p );
 }
 
 
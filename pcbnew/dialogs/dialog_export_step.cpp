@@ -187,7 +187,7 @@ void PCB_EDIT_FRAME::OnExportSTEP( wxCommandEvent& event )
 
     if( GetScreen()->IsModify() || brdFile.GetFullPath().empty() )
     {
-        if( !doAutoSave() )
+        if( !doAutoSave() || !finishBoardSave() )
         {
             wxMessageBox( _( "STEP export failed; please save the PCB and try again" ),
                           _( "STEP Export" ) );
@@ -58,6 +58,7 @@ Load() TODO's
 #include <boost/property_tree/xml_parser.hpp>
 
 #include <eagle_plugin.h>
+#include <xml_stream.h>
 
 #include <common.h>
 #include <macros.h>
@@ -1183,7 +1184,6 @@ wxSize inline EAGLE_PLUGIN::kicad_fontz( double d ) const
 BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const PROPERTIES* aProperties )
 {
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-    PTREE       doc;
 
     init( aProperties );
 
@@ -1203,13 +1203,13 @@ BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const
         // and is not necessarily utf8.
         string filename = (const char*) aFileName.char_str( wxConvFile );
 
-        read_xml( filename, doc, xml_parser::no_comments );
+        XML_STREAM reader( filename );
 
         m_min_trace    = INT_MAX;
         m_min_via      = INT_MAX;
         m_min_via_hole = INT_MAX;
 
-        loadAllSections( doc );
+        loadAllSections( reader );
 
         BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
 
@@ -1282,6 +1282,8 @@ void EAGLE_PLUGIN::init( const PROPERTIES* aProperties )
     m_min_via_hole = 0;
     m_xpath->clear();
     m_pads_to_nets.clear();
+    m_netcode = 1;
+    m_placed.clear();
 
     // m_templates.clear();     this is the FOOTPRINT cache too
 
@@ -1305,50 +1307,110 @@ void EAGLE_PLUGIN::clear_cu_map()
 }
 
 
-void EAGLE_PLUGIN::loadAllSections( CPTREE& aDoc )
+void EAGLE_PLUGIN::loadAllSections( XML_STREAM& aReader )
 {
-    CPTREE& drawing = aDoc.get_child( "eagle.drawing" );
-    CPTREE& board   = drawing.get_child( "board" );
+    if( !aReader.NextChild() || aReader.Name() != "eagle" )
+        throw ptree_bad_path( "No such node", "eagle" );
 
-    m_xpath->push( "eagle.drawing" );
+    bool    sawDrawing = false;
+    bool    sawBoard = false;
 
+    while( aReader.NextChild() )
     {
-        m_xpath->push( "board" );
+        if( aReader.Name() != "drawing" )
+        {
+            aReader.SkipElement();
+            continue;
+        }
 
-        CPTREE& designrules = board.get_child( "designrules" );
-        loadDesignRules( designrules );
+        sawDrawing = true;
+        m_xpath->push( "eagle.drawing" );
 
-        m_xpath->pop();
-    }
+        while( aReader.NextChild() )
+        {
+            if( aReader.Name() == "layers" )
+            {
+                PTREE   section;
+                CPTREE& layers = aReader.ReadElement( section );
 
-    {
-        m_xpath->push( "layers" );
+                m_xpath->push( "layers" );
+                loadLayerDefs( layers );
+                m_xpath->pop();
+            }
+            else if( aReader.Name() == "board" )
+            {
+                sawBoard = true;
+                m_xpath->push( "board" );
 
-        CPTREE& layers = drawing.get_child( "layers" );
-        loadLayerDefs( layers );
+                // Packages depend on the design rules, which come after the libraries
+                // in the file, so the libraries are held until the rules are known.
+                PTREE   libs;
+                bool    libsLoaded = false;
 
-        m_xpath->pop();
-    }
+                while( aReader.NextChild() )
+                {
+                    const string& name = aReader.Name();
 
-    {
-        m_xpath->push( "board" );
+                    if( name == "plain" || name == "elements" || name == "signals" )
+                    {
+                        // load these one item at a time, they are the bulk of a board
+                        string section = name;
 
-        CPTREE& plain = board.get_child( "plain" );
-        loadPlain( plain );
+                        if( section == "elements" && !libsLoaded )
+                        {
+                            loadLibraries( libs );
+                            libs.clear();
+                            libsLoaded = true;
+                        }
 
-        CPTREE&  signals = board.get_child( "signals" );
-        loadSignals( signals );
+                        while( aReader.NextChild() )
+                        {
+                            PTREE item;
+                            aReader.ReadElement( item );
+
+                            if( section == "plain" )
+                                loadPlain( item );
+                            else if( section == "elements" )
+                                loadElements( item );
+                            else
+                                loadSignals( item );
+                        }
+                    }
+                    else if( name == "libraries" )
+                    {
+                        while( aReader.NextChild() )
+                            aReader.ReadElement( libs );
+                    }
+                    else if( name == "designrules" )
+                    {
+                        PTREE   section;
+                        CPTREE& designrules = aReader.ReadElement( section );
 
-        CPTREE&  libs = board.get_child( "libraries" );
-        loadLibraries( libs );
+                        loadDesignRules( designrules );
+                    }
+                    else
+                        aReader.SkipElement();
+                }
+
+                if( !libsLoaded )
+                    loadLibraries( libs );
 
-        CPTREE& elems = board.get_child( "elements" );
-        loadElements( elems );
+                assignPadNets();
 
-        m_xpath->pop();     // "board"
+                m_xpath->pop();     // "board"
+            }
+            else
+                aReader.SkipElement();
+        }
+
+        m_xpath->pop();     // "eagle.drawing"
     }
 
-    m_xpath->pop();     // "eagle.drawing"
+    if( !sawDrawing )
+        throw ptree_bad_path( "No such node", "eagle.drawing" );
+
+    if( !sawBoard )
+        throw ptree_bad_path( "No such node", "board" );
 }
 
 
@@ -1831,18 +1893,9 @@ void EAGLE_PLUGIN::loadElements( CPTREE& aElements )
         MODULE* m = new MODULE( *mi->second );
         m_board->Add( m, ADD_APPEND );
 
-        // update the nets within the pads of the clone
-        for( D_PAD* pad = m->Pads();  pad;  pad = pad->Next() )
-        {
-            string pn_key  = makeKey( e.name, TO_UTF8( pad->GetPadName() ) );
-
-            NET_MAP_CITER ni = m_pads_to_nets.find( pn_key );
-            if( ni != m_pads_to_nets.end() )
-            {
-                const ENET* enet = &ni->second;
-                pad->SetNetCode( enet->netcode );
-            }
-        }
+        // the nets within the pads of the clone are set by assignPadNets(),
+        // the signals follow the elements in the file.
+        m_placed.push_back( std::make_pair( e.name, m ) );
 
         refanceNamePresetInPackageLayout = true;
         valueNamePresetInPackageLayout = true;
@@ -1995,6 +2048,30 @@ void EAGLE_PLUGIN::loadElements( CPTREE& aElements )
 }
 
 
+void EAGLE_PLUGIN::assignPadNets()
+{
+    for( unsigned i = 0;  i < m_placed.size();  ++i )
+    {
+        const string&   name = m_placed[i].first;
+        MODULE*         m = m_placed[i].second;
+
+        for( D_PAD* pad = m->Pads();  pad;  pad = pad->Next() )
+        {
+            string pn_key  = makeKey( name, TO_UTF8( pad->GetPadName() ) );
+
+            NET_MAP_CITER ni = m_pads_to_nets.find( pn_key );
+            if( ni != m_pads_to_nets.end() )
+            {
+                const ENET* enet = &ni->second;
+                pad->SetNetCode( enet->netcode );
+            }
+        }
+    }
+
+    m_placed.clear();
+}
+
+
 void EAGLE_PLUGIN::orientModuleAndText( MODULE* m, const EELEMENT& e,
                     const EATTR* nameAttr, const EATTR* valueAttr )
 {
@@ -2611,7 +2688,7 @@ void EAGLE_PLUGIN::loadSignals( CPTREE& aSignals )
 
     m_xpath->push( "signals.signal", "name" );
 
-    int netCode = 1;
+    int& netCode = m_netcode;     // continues across calls, see loadAllSections()
 
     for( CITER net = aSignals.begin();  net != aSignals.end();  ++net )
     {
@@ -35,6 +35,7 @@
 #include <boost/property_tree/ptree_fwd.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
 #include <map>
+#include <vector>
 
 
 class MODULE;
@@ -67,6 +68,7 @@ class XPATH;
 struct ERULES;
 struct EATTR;
 class TEXTE_MODULE;
+class XML_STREAM;
 
 
 /**
@@ -127,6 +129,11 @@ private:
     int         m_hole_count;       ///< generates unique module names from eagle "hole"s.
 
     NET_MAP     m_pads_to_nets;     ///< net list
+    int         m_netcode;          ///< next net code given by loadSignals()
+
+    /// modules placed by loadElements(), keyed by element name, whose pads get
+    /// their nets in assignPadNets() once all the signals are known.
+    std::vector< std::pair<std::string, MODULE*> >  m_placed;
 
     MODULE_MAP  m_templates;        ///< is part of a MODULE factory that operates
                                     ///< using copy construction.
@@ -175,7 +182,13 @@ private:
 
     // all these loadXXX() throw IO_ERROR or ptree_error exceptions:
 
-    void loadAllSections( CPTREE& aDocument );
+    /**
+     * Function loadAllSections
+     * reads the board file one section at a time.  Only the section (or the item
+     * within "plain", "elements" and "signals") being loaded is kept in memory as a
+     * ptree, so the whole document never is.
+     */
+    void loadAllSections( XML_STREAM& aReader );
     void loadDesignRules( CPTREE& aDesignRules );
     void loadLayerDefs( CPTREE& aLayers );
     void loadPlain( CPTREE& aPlain );
@@ -197,6 +210,9 @@ private:
     void loadLibraries( CPTREE& aLibs );
     void loadElements( CPTREE& aElements );
 
+    /// set the net of every pad of the modules placed by loadElements().
+    void assignPadNets();
+
     void orientModuleAndText( MODULE* m, const EELEMENT& e, const EATTR* nameAttr, const EATTR* valueAttr );
     void orientModuleText( MODULE* m, const EELEMENT& e, TEXTE_MODULE* txt, const EATTR* a );
 
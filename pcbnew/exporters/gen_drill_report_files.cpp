@@ -384,6 +384,8 @@ bool EXCELLON_WRITER::GenDrillReportFile( const wxString& aFullFileName )
     totalHoleCount = printToolSummary( out, true );
     out.Print( 0, "    Total unplated holes count %u\n", totalHoleCount );
 
+    out.Finish();
+
     return true;
 }
 
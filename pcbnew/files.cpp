@@ -52,6 +52,7 @@
 #include <build_version.h>      // LEGACY_BOARD_FILE_VERSION
 #include <module_editor_frame.h>
 #include <modview_frame.h>
+#include <board_save_job.h>
 
 #include <wx/stdpaths.h>
 
@@ -338,7 +339,8 @@ void PCB_EDIT_FRAME::Files_io_from_id( int id )
     case ID_SAVE_BOARD:
         if( ! GetBoard()->GetFileName().IsEmpty() )
         {
-            SavePcbFile( Prj().AbsolutePath( GetBoard()->GetFileName() ) );
+            SavePcbFile( Prj().AbsolutePath( GetBoard()->GetFileName() ), CREATE_BACKUP_FILE,
+                         true );
             break;
         }
     // Fall through
@@ -672,10 +674,14 @@ static wxString create_backup_file( const wxString& aFileName )
 }
 
 
-bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupFile )
+bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupFile,
+                                  bool aInBackground )
 {
     // please, keep it simple.  prompting goes elsewhere.
 
+    // Never let two saves write at the same time.
+    finishBoardSave();
+
     wxFileName  pcbFileName = aFileName;
 
     if( pcbFileName.GetExt() == LegacyPcbFileExtension )
@@ -714,6 +720,29 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     wxString    upperTxt;
     wxString    lowerTxt;
 
+    if( aInBackground )
+    {
+        wxASSERT( pcbFileName.IsAbsolute() );
+
+        // The job writes a copy of the board, so it can be edited while the file is
+        // written.  Changes made from now on mark the board as modified again.
+        m_saveJob.reset( new BOARD_SAVE_JOB( GetBoard()->Snapshot(), pcbFileName.GetFullPath(),
+                                             this ) );
+        m_saveJob->m_BackupFileName = backupFileName;
+        m_saveJob->m_UpdateHistory  = aCreateBackupFile;
+
+        GetBoard()->SetFileName( pcbFileName.GetFullPath() );
+        UpdateTitle();
+
+        lowerTxt.Printf( _( "Writing board file: '%s'" ), GetChars( pcbFileName.GetFullPath() ) );
+
+        AppendMsgPanel( upperTxt, lowerTxt, CYAN );
+
+        GetScreen()->ClrModify();
+        GetScreen()->ClrSave();
+        return true;
+    }
+
     try
     {
         PLUGIN::RELEASER    pi( IO_MGR::PluginFind( IO_MGR::KICAD ) );
@@ -769,6 +798,71 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
 }
 
 
+bool PCB_EDIT_FRAME::finishBoardSave()
+{
+    if( !m_saveJob )
+        return true;
+
+    // Take the job first: this can be re-entered through the event loop while an
+    // error is displayed.
+    std::unique_ptr<BOARD_SAVE_JOB> job( m_saveJob.release() );
+
+    job->Wait();
+
+    wxFileName  pcbFileName = job->GetFileName();
+    wxString    upperTxt;
+    wxString    lowerTxt;
+
+    ClearMsgPanel();
+
+    if( !job->GetError().IsEmpty() )
+    {
+        wxString msg = wxString::Format( _(
+                "Error saving board file '%s'.\n%s" ),
+                GetChars( pcbFileName.GetFullPath() ),
+                GetChars( job->GetError() )
+                );
+
+        // The file on disk does not match the board.
+        GetScreen()->SetModify();
+
+        lowerTxt.Printf( _( "Failed to create '%s'" ), GetChars( pcbFileName.GetFullPath() ) );
+
+        AppendMsgPanel( upperTxt, lowerTxt, CYAN );
+
+        DisplayError( this, msg );
+        return false;
+    }
+
+    if( job->m_UpdateHistory )
+        UpdateFileHistory( pcbFileName.GetFullPath() );
+
+    // Delete auto save file on successful save.
+    wxFileName autoSaveFileName = pcbFileName;
+
+    autoSaveFileName.SetName( wxString( autosavePrefix ) + pcbFileName.GetName() );
+
+    if( autoSaveFileName.FileExists() )
+        wxRemoveFile( autoSaveFileName.GetFullPath() );
+
+    if( !!job->m_BackupFileName )
+        upperTxt.Printf( _( "Backup file: '%s'" ), GetChars( job->m_BackupFileName ) );
+
+    lowerTxt.Printf( _( "Wrote board file: '%s'" ), GetChars( pcbFileName.GetFullPath() ) );
+
+    AppendMsgPanel( upperTxt, lowerTxt, CYAN );
+
+    return true;
+}
+
+
+void PCB_EDIT_FRAME::onBoardSaveDone( wxCommandEvent& aEvent )
+{
+    // The job may already have been finished by a later save or by closing the frame.
+    finishBoardSave();
+}
+
+
 bool PCB_EDIT_FRAME::SavePcbCopy( const wxString& aFileName )
 {
     wxFileName  pcbFileName = aFileName;
@@ -856,7 +950,7 @@ bool PCB_EDIT_FRAME::doAutoSave()
 
     wxLogTrace( traceAutoSave, "Creating auto save file <" + autoSaveFileName.GetFullPath() + ">" );
 
-    if( SavePcbFile( autoSaveFileName.GetFullPath(), NO_BACKUP_FILE ) )
+    if( SavePcbFile( autoSaveFileName.GetFullPath(), NO_BACKUP_FILE, true ) )
     {
         GetScreen()->SetModify();
         GetBoard()->SetFileName( tmpFileName.GetFullPath() );
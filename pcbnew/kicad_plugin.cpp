@@ -82,12 +82,15 @@ void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
  * that contain a single module per file.  This class is a helper only for the
  * footprint portion of the PLUGIN API, and only for the #PCB_IO plugin.  It is
  * private to this implementation file so it is not placed into a header.
+ *
+ * The footprint itself is only parsed the first time it is requested so enumerating
+ * a library only costs a directory scan.  Until then #GetModule() returns NULL.
  */
 class FP_CACHE_ITEM
 {
     wxFileName              m_file_name; ///< The the full file name and path of the footprint to cache.
     wxDateTime              m_mod_time;  ///< The last file modified time stamp.
-    std::unique_ptr<MODULE> m_module;
+    std::unique_ptr<MODULE> m_module;    ///< NULL until the footprint file has been parsed.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName );
@@ -99,6 +102,8 @@ public:
     bool        IsModified() const;
 
     MODULE*     GetModule() const { return m_module.get(); }
+    void        SetModule( MODULE* aModule ) { m_module.reset( aModule ); }
+    bool        IsLoaded() const { return m_module != NULL; }
     void        UpdateModificationTime() { m_mod_time = m_file_name.GetModificationTime(); }
 };
 
@@ -157,8 +162,24 @@ public:
     /// save the entire legacy library to m_lib_name;
     void Save();
 
+    /**
+     * Function Load
+     * scans the library path for footprint files.  Only the file names are indexed, the
+     * footprints are parsed on demand by #GetModule().
+     */
     void Load();
 
+    /**
+     * Function GetModule
+     * returns the footprint \a aFootprintName, parsing its file if this is the first
+     * time it has been requested.
+     *
+     * @param aFootprintName is the footprint name, i.e. the file name without extension.
+     * @return the cached footprint or NULL if \a aFootprintName is not in the library.
+     * @throw IO_ERROR or PARSE_ERROR if the footprint file cannot be read.
+     */
+    MODULE* GetModule( const std::string& aFootprintName );
+
     void Remove( const wxString& aFootprintName );
 
     wxDateTime GetLibModificationTime() const;
@@ -227,6 +248,11 @@ void FP_CACHE::Save()
         if( fn.FileExists() && !it->second->IsModified() )
             continue;
 
+        // A footprint that was never parsed has not been changed here, the file on
+        // disk is still the reference.
+        if( !it->second->IsLoaded() )
+            continue;
+
         wxString tempFileName =
 #ifdef USE_TMP_FILE
         fn.CreateTempFileName( fn.GetPath() );
@@ -243,6 +269,7 @@ void FP_CACHE::Save()
 
             m_owner->SetOutputFormatter( &formatter );
             m_owner->Format( (BOARD_ITEM*) it->second->GetModule() );
+            formatter.Finish();
         }
 
 #ifdef USE_TMP_FILE
@@ -292,16 +319,10 @@ void FP_CACHE::Load()
             // prepend the libpath into fullPath
             wxFileName fullPath( m_lib_path.GetPath(), fpFileName );
 
-            FILE_LINE_READER    reader( fullPath.GetFullPath() );
-
-            m_owner->m_parser->SetLineReader( &reader );
-
+            // The footprint name is the file name without the extension.  The file
+            // itself is not parsed until the footprint is requested.
             std::string name = TO_UTF8( fullPath.GetName() );
-            MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-
-            // The footprint name is the file name without the extension.
-            footprint->SetFPID( LIB_ID( fullPath.GetName() ) );
-            m_modules.insert( name, new FP_CACHE_ITEM( footprint, fullPath ) );
+            m_modules.insert( name, new FP_CACHE_ITEM( NULL, fullPath ) );
 
         } while( dir.GetNext( &fpFileName ) );
 
@@ -313,6 +334,35 @@ void FP_CACHE::Load()
 }
 
 
+MODULE* FP_CACHE::GetModule( const std::string& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( aFootprintName );
+
+    if( it == m_modules.end() )
+        return NULL;
+
+    FP_CACHE_ITEM* item = it->second;
+
+    if( !item->IsLoaded() )
+    {
+        wxFileName          fullPath = item->GetFileName();
+        FILE_LINE_READER    reader( fullPath.GetFullPath() );
+
+        wxLogTrace( traceFootprintLibrary, wxT( "Parsing footprint file '%s'." ),
+                    GetChars( fullPath.GetFullPath() ) );
+
+        m_owner->m_parser->SetLineReader( &reader );
+
+        MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
+
+        footprint->SetFPID( LIB_ID( fullPath.GetName() ) );
+        item->SetModule( footprint );
+    }
+
+    return item->GetModule();
+}
+
+
 void FP_CACHE::Remove( const wxString& aFootprintName )
 {
     std::string footprintName = TO_UTF8( aFootprintName );
@@ -413,6 +463,8 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     Format( aBoard, 1 );
 
     m_out->Print( 0, ")\n" );
+
+    formatter.Finish();
 }
 
 
@@ -1822,29 +1874,15 @@ wxArrayString PCB_IO::FootprintEnumerate( const wxString&   aLibraryPath,
 
     init( aProperties );
 
-#if 1                         // Set to 0 to only read directory contents, not load cache.
+    // Only the directory contents are read here, footprints are parsed on demand.
     cacheLib( aLibraryPath );
 
     const MODULE_MAP& mods = m_cache->GetModules();
 
-
     for( MODULE_CITER it = mods.begin();  it != mods.end();  ++it )
     {
         ret.Add( FROM_UTF8( it->first.c_str() ) );
     }
-#else
-    wxString fpFileName;
-    wxString wildcard = wxT( "*." ) + KiCadFootprintFileExtension;
-
-    if( dir.GetFirst( &fpFileName, wildcard, wxDIR_FILES ) )
-    {
-        do
-        {
-            wxFileName fn( aLibraryPath, fpFileName );
-            ret.Add( fn.GetName() );
-        } while( dir.GetNext( &fpFileName ) );
-    }
-#endif
 
     return ret;
 }
@@ -1859,17 +1897,13 @@ MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 
     cacheLib( aLibraryPath, aFootprintName );
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( TO_UTF8( aFootprintName ) );
+    MODULE* module = m_cache->GetModule( TO_UTF8( aFootprintName ) );
 
-    if( it == mods.end() )
-    {
+    if( !module )
         return NULL;
-    }
 
     // copy constructor to clone the already loaded MODULE
-    return new MODULE( *it->second->GetModule() );
+    return new MODULE( *module );
 }
 
 
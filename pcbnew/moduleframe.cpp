@@ -879,6 +879,7 @@ void FOOTPRINT_EDIT_FRAME::ProcessPreferences( wxCommandEvent& event )
                     FILE_OUTPUTFORMATTER sf( FP_LIB_TABLE::GetGlobalTableFileName() );
 
                     GFootprintTable.Format( &sf, 0 );
+                    sf.Finish();
                     tableChanged = true;
                 }
                 catch( const IO_ERROR& ioe )
@@ -36,9 +36,6 @@
 #include <class_track.h>
 #include <wxBasePcbFrame.h>
 
-#include <functional>
-using namespace std::placeholders;
-
 const LAYER_NUM GAL_LAYER_ORDER[] =
 {
     ITEM_GAL_LAYER( GP_OVERLAY ),
@@ -131,41 +128,52 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( const BOARD* aBoard )
 {
     m_view->Clear();
 
+    AddBoardItems( m_view, aBoard );
+
+    // Ratsnest
+    if( m_ratsnest )
+    {
+        m_view->Remove( m_ratsnest );
+        delete m_ratsnest;
+    }
+
+    m_ratsnest = new KIGFX::RATSNEST_VIEWITEM( aBoard->GetRatsnest() );
+    m_view->Add( m_ratsnest );
+
+    // Display settings
+    UseColorScheme( aBoard->GetColorsSettings() );
+}
+
+
+void PCB_DRAW_PANEL_GAL::AddBoardItems( KIGFX::VIEW* aView, const BOARD* aBoard )
+{
+    // The items are gathered first and added in one go, which is much faster for large boards
+    std::vector<KIGFX::VIEW_ITEM*> items;
+
     // Load zones
     for( int i = 0; i < aBoard->GetAreaCount(); ++i )
-        m_view->Add( (KIGFX::VIEW_ITEM*) ( aBoard->GetArea( i ) ) );
+        items.push_back( (KIGFX::VIEW_ITEM*) ( aBoard->GetArea( i ) ) );
 
     // Load drawings
     for( BOARD_ITEM* drawing = aBoard->m_Drawings; drawing; drawing = drawing->Next() )
-        m_view->Add( drawing );
+        items.push_back( drawing );
 
     // Load tracks
     for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
-        m_view->Add( track );
+        items.push_back( track );
 
     // Load modules and its additional elements
     for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
     {
-        module->RunOnChildren( std::bind( &KIGFX::VIEW::Add, m_view, _1 ) );
-        m_view->Add( module );
+        module->RunOnChildren( [&items]( BOARD_ITEM* aItem ) { items.push_back( aItem ); } );
+        items.push_back( module );
     }
 
     // Segzones (equivalent of ZONE_CONTAINER for legacy boards)
     for( SEGZONE* zone = aBoard->m_Zone; zone; zone = zone->Next() )
-        m_view->Add( zone );
+        items.push_back( zone );
 
-    // Ratsnest
-    if( m_ratsnest )
-    {
-        m_view->Remove( m_ratsnest );
-        delete m_ratsnest;
-    }
-
-    m_ratsnest = new KIGFX::RATSNEST_VIEWITEM( aBoard->GetRatsnest() );
-    m_view->Add( m_ratsnest );
-
-    // Display settings
-    UseColorScheme( aBoard->GetColorsSettings() );
+    aView->AddItems( items );
 }
 
 
@@ -293,27 +301,33 @@ void PCB_DRAW_PANEL_GAL::SetTopLayer( LAYER_ID aLayer )
 
 
 void PCB_DRAW_PANEL_GAL::SyncLayersVisibility( const BOARD* aBoard )
+{
+    SyncLayersVisibility( m_view, aBoard );
+}
+
+
+void PCB_DRAW_PANEL_GAL::SyncLayersVisibility( KIGFX::VIEW* aView, const BOARD* aBoard )
 {
     // Load layer & elements visibility settings
     for( LAYER_NUM i = 0; i < LAYER_ID_COUNT; ++i )
     {
-        m_view->SetLayerVisible( i, aBoard->IsLayerVisible( LAYER_ID( i ) ) );
+        aView->SetLayerVisible( i, aBoard->IsLayerVisible( LAYER_ID( i ) ) );
 
         // Synchronize netname layers as well
         if( IsCopperLayer( i ) )
-            m_view->SetLayerVisible( GetNetnameLayer( i ), aBoard->IsLayerVisible( LAYER_ID( i ) ) );
+            aView->SetLayerVisible( GetNetnameLayer( i ), aBoard->IsLayerVisible( LAYER_ID( i ) ) );
     }
 
     for( LAYER_NUM i = 0; i < END_PCB_VISIBLE_LIST; ++i )
     {
-        m_view->SetLayerVisible( ITEM_GAL_LAYER( i ), aBoard->IsElementVisible( i ) );
+        aView->SetLayerVisible( ITEM_GAL_LAYER( i ), aBoard->IsElementVisible( i ) );
     }
 
     // Enable some layers that are GAL specific
-    m_view->SetLayerVisible( ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ), true );
-    m_view->SetLayerVisible( ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ), true );
-    m_view->SetLayerVisible( ITEM_GAL_LAYER( WORKSHEET ), true );
-    m_view->SetLayerVisible( ITEM_GAL_LAYER( GP_OVERLAY ), true );
+    aView->SetLayerVisible( ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ), true );
+    aView->SetLayerVisible( ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ), true );
+    aView->SetLayerVisible( ITEM_GAL_LAYER( WORKSHEET ), true );
+    aView->SetLayerVisible( ITEM_GAL_LAYER( GP_OVERLAY ), true );
 }
 
 
@@ -369,13 +383,19 @@ void PCB_DRAW_PANEL_GAL::OnShow()
 
 
 void PCB_DRAW_PANEL_GAL::setDefaultLayerOrder()
+{
+    SetDefaultLayerOrder( m_view );
+}
+
+
+void PCB_DRAW_PANEL_GAL::SetDefaultLayerOrder( KIGFX::VIEW* aView )
 {
     for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
     {
         LAYER_NUM layer = GAL_LAYER_ORDER[i];
         wxASSERT( layer < KIGFX::VIEW::VIEW_MAX_LAYERS );
 
-        m_view->SetLayerOrder( layer, i );
+        aView->SetLayerOrder( layer, i );
     }
 }
 
@@ -389,6 +409,12 @@ bool PCB_DRAW_PANEL_GAL::SwitchBackend( GAL_TYPE aGalType )
 
 
 void PCB_DRAW_PANEL_GAL::setDefaultLayerDeps()
+{
+    SetDefaultLayerDeps( m_view, m_backend );
+}
+
+
+void PCB_DRAW_PANEL_GAL::SetDefaultLayerDeps( KIGFX::VIEW* aView, GAL_TYPE aGalType )
 {
     for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
     {
@@ -398,59 +424,59 @@ void PCB_DRAW_PANEL_GAL::setDefaultLayerDeps()
         // Set layer display dependencies & targets
         if( IsCopperLayer( layer ) )
         {
-            m_view->SetRequired( GetNetnameLayer( layer ), layer );
-            m_view->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
+            aView->SetRequired( GetNetnameLayer( layer ), layer );
+            aView->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
         }
         else if( IsNetnameLayer( layer ) )
         {
-            m_view->SetLayerDisplayOnly( layer );
-            m_view->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
+            aView->SetLayerDisplayOnly( layer );
+            aView->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
         }
     }
 
     // caching makes no sense for Cairo and other software renderers
-    if ( m_backend != GAL_TYPE_OPENGL )
+    if ( aGalType != GAL_TYPE_OPENGL )
     {
         for( int i = 0; i < KIGFX::VIEW::VIEW_MAX_LAYERS; i++ )
-           m_view->SetLayerTarget( i, KIGFX::TARGET_NONCACHED );
+           aView->SetLayerTarget( i, KIGFX::TARGET_NONCACHED );
     }
 
-    m_view->SetLayerTarget( ITEM_GAL_LAYER( ANCHOR_VISIBLE ), KIGFX::TARGET_NONCACHED );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( ANCHOR_VISIBLE ) );
+    aView->SetLayerTarget( ITEM_GAL_LAYER( ANCHOR_VISIBLE ), KIGFX::TARGET_NONCACHED );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( ANCHOR_VISIBLE ) );
 
     // Some more required layers settings
-    m_view->SetRequired( ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ), ITEM_GAL_LAYER( VIA_THROUGH_VISIBLE ) );
-    m_view->SetRequired( ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
-    m_view->SetRequired( NETNAMES_GAL_LAYER( PADS_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ), ITEM_GAL_LAYER( VIA_THROUGH_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
+    aView->SetRequired( NETNAMES_GAL_LAYER( PADS_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
 
     // Front modules
-    m_view->SetRequired( ITEM_GAL_LAYER( PAD_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( NETNAMES_GAL_LAYER( PAD_FR_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Adhes, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Paste, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Mask, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_CrtYd, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Fab, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( F_SilkS, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( PAD_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( NETNAMES_GAL_LAYER( PAD_FR_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_Adhes, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_Paste, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_Mask, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_CrtYd, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( F_Fab, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( F_SilkS, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
 
     // Back modules
-    m_view->SetRequired( ITEM_GAL_LAYER( PAD_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( NETNAMES_GAL_LAYER( PAD_BK_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Adhes, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Paste, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Mask, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_CrtYd, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Fab, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( B_SilkS, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-
-    m_view->SetLayerTarget( ITEM_GAL_LAYER( GP_OVERLAY ), KIGFX::TARGET_OVERLAY );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( GP_OVERLAY ) );
-    m_view->SetLayerTarget( ITEM_GAL_LAYER( RATSNEST_VISIBLE ), KIGFX::TARGET_OVERLAY );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( RATSNEST_VISIBLE ) );
-
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( WORKSHEET ) );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( GRID_VISIBLE ) );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( DRC_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( PAD_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( NETNAMES_GAL_LAYER( PAD_BK_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_Adhes, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_Paste, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_Mask, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_CrtYd, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( B_Fab, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( B_SilkS, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+
+    aView->SetLayerTarget( ITEM_GAL_LAYER( GP_OVERLAY ), KIGFX::TARGET_OVERLAY );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( GP_OVERLAY ) );
+    aView->SetLayerTarget( ITEM_GAL_LAYER( RATSNEST_VISIBLE ), KIGFX::TARGET_OVERLAY );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( RATSNEST_VISIBLE ) );
+
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( WORKSHEET ) );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( GRID_VISIBLE ) );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( DRC_VISIBLE ) );
 }
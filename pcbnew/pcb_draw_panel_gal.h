@@ -33,6 +33,7 @@ namespace KIGFX
     class RATSNEST_VIEWITEM;
 }
 class COLORS_DESIGN_SETTINGS;
+class BOARD;
 
 class PCB_DRAW_PANEL_GAL : public EDA_DRAW_PANEL_GAL
 {
@@ -86,6 +87,37 @@ public:
 
     bool SwitchBackend( GAL_TYPE aGalType ) override;
 
+    /**
+     * Function AddBoardItems
+     * adds all items of a BOARD, except the ratsnest, to a VIEW.
+     * @param aView is the VIEW to be filled.
+     * @param aBoard is the PCB to be loaded.
+     */
+    static void AddBoardItems( KIGFX::VIEW* aView, const BOARD* aBoard );
+
+    /**
+     * Function SetDefaultLayerOrder
+     * sets the PCB layer rendering order in a VIEW.
+     * @param aView is the VIEW to be configured.
+     */
+    static void SetDefaultLayerOrder( KIGFX::VIEW* aView );
+
+    /**
+     * Function SetDefaultLayerDeps
+     * sets the rendering targets and dependencies of PCB layers in a VIEW.
+     * @param aView is the VIEW to be configured.
+     * @param aGalType is the type of the GAL used by the VIEW.
+     */
+    static void SetDefaultLayerDeps( KIGFX::VIEW* aView, GAL_TYPE aGalType );
+
+    /**
+     * Function SyncLayersVisibility
+     * sets "visibility" property of each layer in a VIEW from a given BOARD.
+     * @param aView is the VIEW to be configured.
+     * @param aBoard contains layers visibility settings to be applied.
+     */
+    static void SyncLayersVisibility( KIGFX::VIEW* aView, const BOARD* aBoard );
+
 protected:
     ///> Reassigns layer order to the initial settings.
     void setDefaultLayerOrder();
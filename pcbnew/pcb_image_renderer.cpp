@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcb_image_renderer.cpp
+ */
+
+#include <pcb_image_renderer.h>
+#include <pcb_draw_panel_gal.h>
+#include <pcb_painter.h>
+#include <view/view.h>
+#include <gal/cairo/cairo_gal.h>
+#include <convert_to_biu.h>
+#include <class_board.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+
+PCB_IMAGE_RENDERER::PCB_IMAGE_RENDERER( BOARD* aBoard ) :
+    m_board( aBoard ), m_dpi( 300.0 )
+{
+}
+
+
+EDA_RECT PCB_IMAGE_RENDERER::GetViewport() const
+{
+    if( m_viewport.GetWidth() != 0 && m_viewport.GetHeight() != 0 )
+    {
+        EDA_RECT viewport( m_viewport );
+        viewport.Normalize();
+        return viewport;
+    }
+
+    return m_board->ComputeBoundingBox( false );
+}
+
+
+wxSize PCB_IMAGE_RENDERER::GetImageSize() const
+{
+    EDA_RECT viewport = GetViewport();
+    double pixelsPerIU = m_dpi / ( IU_PER_MILS * 1000.0 );
+
+    return wxSize( KiROUND( viewport.GetWidth() * pixelsPerIU ),
+                   KiROUND( viewport.GetHeight() * pixelsPerIU ) );
+}
+
+
+bool PCB_IMAGE_RENDERER::Render( const wxString& aFileName )
+{
+    EDA_RECT viewport = GetViewport();
+    wxSize   size = GetImageSize();
+
+    if( size.x <= 0 || size.y <= 0 || size.x > MAX_IMAGE_SIZE || size.y > MAX_IMAGE_SIZE )
+        return false;
+
+    if( (int64_t) size.x * size.y > MAX_IMAGE_PIXELS )
+        return false;
+
+    // An item belongs to a single view.  Render a copy of the board, so the items of a board
+    // shown in an editor are not taken away from the view of the editor.
+    std::unique_ptr<BOARD> board( m_board->Snapshot() );
+
+    KIGFX::CAIRO_IMAGE_GAL gal( size.x, size.y );
+    KIGFX::PCB_PAINTER painter( &gal );
+    KIGFX::VIEW view( true );
+
+    view.SetPainter( &painter );
+    view.SetGAL( &gal );
+
+    PCB_DRAW_PANEL_GAL::SetDefaultLayerOrder( &view );
+    PCB_DRAW_PANEL_GAL::SetDefaultLayerDeps( &view, EDA_DRAW_PANEL_GAL::GAL_TYPE_CAIRO );
+    PCB_DRAW_PANEL_GAL::SyncLayersVisibility( &view, board.get() );
+    PCB_DRAW_PANEL_GAL::AddBoardItems( &view, board.get() );
+
+    KIGFX::PCB_RENDER_SETTINGS* settings = painter.GetSettings();
+    settings->ImportLegacyColors( m_board->GetColorsSettings() );
+
+    // BeginDrawing() fills the image with the background color
+    gal.SetBackgroundColor( settings->GetBackgroundColor() );
+
+    // The image size follows the viewport, so the scale is only limited by the DPI
+    view.SetScaleLimits( std::numeric_limits<double>::max(), 0.0 );
+    view.SetViewport( BOX2D( VECTOR2D( viewport.GetOrigin() ), VECTOR2D( viewport.GetSize() ) ) );
+    view.UpdateItems();
+
+    gal.BeginDrawing();
+    view.ClearTargets();
+    view.Redraw();
+    gal.EndDrawing();
+
+    return gal.SaveImage( aFileName );
+}
@@ -0,0 +1,103 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcb_image_renderer.h
+ */
+
+#ifndef PCB_IMAGE_RENDERER_H_
+#define PCB_IMAGE_RENDERER_H_
+
+#include <class_eda_rect.h>
+
+class BOARD;
+
+
+/**
+ * Batch board renderer. Draws a board with the same painter as the GAL canvas to a PNG file,
+ * without a window or a running event loop.
+ * Especially useful for generating board previews in command line tools and Python scripts.
+ *
+ * Every renderer uses its own view and graphics context, and draws a copy of the board, so
+ * a board shown in an editor may be rendered, and several boards may be rendered at the same
+ * time on different threads. A board must not be modified while it is being copied.
+ */
+class PCB_IMAGE_RENDERER
+{
+public:
+    PCB_IMAGE_RENDERER( BOARD* aBoard );
+
+    /**
+     * Function SetDPI
+     * sets the resolution of the rendered image.
+     * @param aDPI is the number of pixels per inch of the board.
+     */
+    void SetDPI( double aDPI ) { m_dpi = aDPI; }
+    double GetDPI() const { return m_dpi; }
+
+    /**
+     * Function SetViewport
+     * sets the board area to be rendered. By default the whole board is rendered.
+     * @param aViewport is the area in board internal units, an empty rectangle resets
+     * the viewport to the board bounding box.
+     */
+    void SetViewport( const EDA_RECT& aViewport ) { m_viewport = aViewport; }
+
+    /**
+     * @return the board area that is going to be rendered.
+     */
+    EDA_RECT GetViewport() const;
+
+    /**
+     * @return the size of the rendered image in pixels.
+     */
+    wxSize GetImageSize() const;
+
+    /**
+     * Function Render
+     * draws the board and saves the image to a PNG file.
+     * @param aFileName is the name of the file to be written.
+     * @return true on success, false if the image could not be rendered (e.g. it is too large)
+     * or the file could not be written.
+     */
+    bool Render( const wxString& aFileName );
+
+    ///> Maximal size of the image side in pixels
+    static const int MAX_IMAGE_SIZE = 32767;
+
+    ///> Maximal number of pixels of the image, its 32 bit buffer size must fit in an int
+    ///> (cairo and pixman index the buffer with ints) even with the padding of the rows
+    static const int MAX_IMAGE_PIXELS = 256 * 1024 * 1024;
+
+private:
+    /// The board to be rendered
+    BOARD* m_board;
+
+    /// Board area to be rendered, empty for the whole board
+    EDA_RECT m_viewport;
+
+    /// Resolution of the image in pixels per inch
+    double m_dpi;
+};
+
+#endif
@@ -77,6 +77,7 @@
 #endif
 
 #include <pcb_draw_panel_gal.h>
+#include <board_save_job.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <functional>
 
@@ -103,6 +104,7 @@ BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
     EVT_CHOICE( ID_ON_GRID_SELECT, PCB_EDIT_FRAME::OnSelectGrid )
 
     EVT_CLOSE( PCB_EDIT_FRAME::OnCloseWindow )
+    EVT_COMMAND( wxID_ANY, EVT_BOARD_SAVE_DONE, PCB_EDIT_FRAME::onBoardSaveDone )
     EVT_SIZE( PCB_EDIT_FRAME::OnSize )
 
     EVT_TOOL( ID_LOAD_FILE, PCB_EDIT_FRAME::Files_io )
@@ -631,6 +633,9 @@ void PCB_EDIT_FRAME::OnCloseWindow( wxCloseEvent& Event )
         }
     }
 
+    // Wait for the board file or the auto save file being written in background.
+    finishBoardSave();
+
     if( IsGalCanvasActive() )
     {
         // On Windows 7 / 32 bits, on OpenGL mode only, Pcbnew crashes
@@ -64,6 +64,7 @@ class BASE_SET {};
 #include <pcbnew_scripting_helpers.h>
 
 #include <plotcontroller.h>
+#include <pcb_image_renderer.h>
 #include <pcb_plot_params.h>
 #include <exporters/gendrill_Excellon_writer.h>
 
@@ -100,6 +101,7 @@ HANDLE_EXCEPTIONS(PLUGIN::FootprintDelete)
 
 
 %include <plotcontroller.h>
+%include <pcb_image_renderer.h>
 %include <pcb_plot_params.h>
 %include <plot_common.h>
 %include <exporters/gendrill_Excellon_writer.h>
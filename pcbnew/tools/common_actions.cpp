@@ -548,6 +548,14 @@ TOOL_ACTION COMMON_ACTIONS::showHelp( "pcbnew.Control.showHelp",
         AS_GLOBAL, TOOL_ACTION::LegacyHotKey( HK_HELP ),
         "", "" );
 
+TOOL_ACTION COMMON_ACTIONS::renderStats( "pcbnew.Control.renderStats",
+        AS_GLOBAL, MD_CTRL + MD_SHIFT + WXK_F12,
+        _( "Show Rendering Statistics" ), _( "Display frame times and item counts on the canvas" ) );
+
+TOOL_ACTION COMMON_ACTIONS::exportRenderStats( "pcbnew.Control.exportRenderStats",
+        AS_GLOBAL, MD_CTRL + MD_ALT + WXK_F12,
+        _( "Export Rendering Statistics" ), _( "Save the rendering statistics to a CSV file" ) );
+
 TOOL_ACTION COMMON_ACTIONS::toBeDone( "pcbnew.Control.toBeDone",
         AS_GLOBAL, 0,           // dialog saying it is not implemented yet
         "", "" );               // so users are aware of that
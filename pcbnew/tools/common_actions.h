@@ -324,6 +324,8 @@ public:
     static TOOL_ACTION crossProbeSchToPcb;
     static TOOL_ACTION appendBoard;
     static TOOL_ACTION showHelp;
+    static TOOL_ACTION renderStats;
+    static TOOL_ACTION exportRenderStats;
     static TOOL_ACTION toBeDone;
 
     /// Find an item
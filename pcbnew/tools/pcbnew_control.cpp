@@ -47,6 +47,7 @@
 #include <ratsnest_data.h>
 #include <tool/tool_manager.h>
 #include <gal/graphics_abstraction_layer.h>
+#include <view/view.h>
 #include <view/view_controls.h>
 #include <pcb_painter.h>
 #include <origin_viewitem.h>
@@ -904,6 +905,46 @@ int PCBNEW_CONTROL::ShowHelp( const TOOL_EVENT& aEvent )
 }
 
 
+int PCBNEW_CONTROL::RenderStats( const TOOL_EVENT& aEvent )
+{
+    EDA_DRAW_PANEL_GAL* canvas = m_frame->GetGalCanvas();
+
+    canvas->ShowRenderStats( !canvas->IsRenderStatsShown() );
+
+    return 0;
+}
+
+
+int PCBNEW_CONTROL::ExportRenderStats( const TOOL_EVENT& aEvent )
+{
+    const KIGFX::RENDER_STATS& stats = getView()->GetRenderStats();
+
+    if( stats.GetHistory().empty() )
+    {
+        DisplayInfoMessage( m_frame, _( "No rendering statistics have been collected yet." ) );
+        return 0;
+    }
+
+    wxFileDialog dlg( m_frame, _( "Export Rendering Statistics" ), wxEmptyString,
+                      wxT( "render_stats.csv" ), _( "CSV files (*.csv)|*.csv" ),
+                      wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( dlg.ShowModal() == wxID_CANCEL )
+        return 0;
+
+    try
+    {
+        stats.ExportCSV( dlg.GetPath() );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        DisplayError( m_frame, ioe.What() );
+    }
+
+    return 0;
+}
+
+
 int PCBNEW_CONTROL::ToBeDone( const TOOL_EVENT& aEvent )
 {
     DisplayInfoMessage( m_frame, _( "Not available in OpenGL/Cairo canvases." ) );
@@ -983,6 +1024,8 @@ void PCBNEW_CONTROL::SetTransitions()
     Go( &PCBNEW_CONTROL::DeleteItemCursor,   COMMON_ACTIONS::deleteItemCursor.MakeEvent() );
     Go( &PCBNEW_CONTROL::AppendBoard,        COMMON_ACTIONS::appendBoard.MakeEvent() );
     Go( &PCBNEW_CONTROL::ShowHelp,           COMMON_ACTIONS::showHelp.MakeEvent() );
+    Go( &PCBNEW_CONTROL::RenderStats,        COMMON_ACTIONS::renderStats.MakeEvent() );
+    Go( &PCBNEW_CONTROL::ExportRenderStats,  COMMON_ACTIONS::exportRenderStats.MakeEvent() );
     Go( &PCBNEW_CONTROL::ToBeDone,           COMMON_ACTIONS::toBeDone.MakeEvent() );
 }
 
@@ -90,6 +90,8 @@ public:
     int DeleteItemCursor( const TOOL_EVENT& aEvent );
     int AppendBoard( const TOOL_EVENT& aEvent );
     int ShowHelp( const TOOL_EVENT& aEvent );
+    int RenderStats( const TOOL_EVENT& aEvent );
+    int ExportRenderStats( const TOOL_EVENT& aEvent );
     int ToBeDone( const TOOL_EVENT& aEvent );
 
     ///> Sets up handlers for various events.
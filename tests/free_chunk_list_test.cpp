@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <gal/opengl/free_chunk_list.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace KIGFX;
+
+BOOST_AUTO_TEST_SUITE( FreeChunkList )
+
+/**
+ * Checks that adjacent chunks are merged, whatever the order they are released in.
+ */
+BOOST_AUTO_TEST_CASE( MergeAdjacent )
+{
+    const unsigned int  chunkSize = 16;
+    std::vector<unsigned int> offsets;
+    std::mt19937        rng( 1 );
+    FREE_CHUNK_LIST     list;
+
+    for( unsigned int ii = 0; ii < 1000; ++ii )
+        offsets.push_back( ii * chunkSize );
+
+    std::shuffle( offsets.begin(), offsets.end(), rng );
+
+    for( unsigned int offset : offsets )
+    {
+        list.Add( offset, chunkSize );
+        BOOST_REQUIRE( list.Check() );
+    }
+
+    BOOST_CHECK_EQUAL( list.GetChunkCount(), 1 );
+    BOOST_CHECK_EQUAL( list.GetFreeSpace(), 1000 * chunkSize );
+    BOOST_CHECK_EQUAL( list.GetFragmentation(), 0.0 );
+
+    unsigned int offset, size;
+
+    BOOST_CHECK( list.Take( 100, offset, size ) );
+    BOOST_CHECK_EQUAL( offset, 0 );
+    BOOST_CHECK_EQUAL( size, 1000 * chunkSize );
+    BOOST_CHECK( !list.Take( 1, offset, size ) );
+}
+
+/**
+ * Simulates a long editing session the way CACHED_CONTAINER uses the list: items are
+ * repeatedly removed and stored again with different sizes. The free space must stay usable,
+ * so no compaction (and the frame time spike it causes) is ever needed.
+ */
+BOOST_AUTO_TEST_CASE( LongSession )
+{
+    const unsigned int  bufferSize = 1 << 20;
+    const unsigned int  maxItemSize = 2000;
+    std::mt19937        rng( 1 );
+    FREE_CHUNK_LIST     list;
+    unsigned int        failures = 0;
+
+    // Stored items, as offset & size
+    std::vector< std::pair<unsigned int, unsigned int> > items;
+
+    auto store = [&]()
+    {
+        unsigned int size = 1 + rng() % maxItemSize;
+        unsigned int offset, chunkSize;
+
+        if( !list.Take( size, offset, chunkSize ) )
+        {
+            ++failures;
+            return;
+        }
+
+        // Return the unused part of the chunk, as CACHED_CONTAINER::FinishItem() does
+        if( chunkSize > size )
+            list.Add( offset + size, chunkSize - size );
+
+        items.push_back( std::make_pair( offset, size ) );
+    };
+
+    list.Add( 0, bufferSize );
+
+    // Fill about a half of the buffer
+    while( list.GetFreeSpace() > bufferSize / 2 )
+        store();
+
+    for( unsigned int ii = 0; ii < 200000; ++ii )
+    {
+        unsigned int idx = rng() % items.size();
+
+        list.Add( items[idx].first, items[idx].second );
+        items[idx] = items.back();
+        items.pop_back();
+
+        store();
+
+        if( ii % 10000 == 0 )
+            BOOST_REQUIRE( list.Check() );
+    }
+
+    BOOST_CHECK( list.Check() );
+    BOOST_CHECK_EQUAL( failures, 0 );
+    BOOST_CHECK_GE( list.GetLargestChunk(), maxItemSize );
+
+    // Releasing everything leaves a single chunk
+    for( const auto& item : items )
+        list.Add( item.first, item.second );
+
+    BOOST_CHECK_EQUAL( list.GetChunkCount(), 1 );
+    BOOST_CHECK_EQUAL( list.GetFreeSpace(), bufferSize );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
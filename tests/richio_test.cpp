@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <richio.h>
+
+#include <wx/filename.h>
+#include <wx/ffile.h>
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+
+BOOST_AUTO_TEST_SUITE( OutputFormatter )
+
+/**
+ * Checks that the printf() free path of OUTPUTFORMATTER::Print() gives the
+ * same text as vsnprintf(), and that other formats still work.
+ */
+BOOST_AUTO_TEST_CASE( PrintMatchesPrintf )
+{
+    STRING_FORMATTER sf;
+
+    sf.Print( 0, "(at %s %s %d)\n", "12.7", "-3.81", 90 );
+    sf.Print( 2, "%d %d %d%c%%\n", 0, INT_MIN, INT_MAX, 'x' );
+    sf.Print( 1, "(width %.4f) (%-4s)\n", 0.15, "a" );
+
+    BOOST_CHECK_EQUAL( sf.GetString(),
+                       "(at 12.7 -3.81 90)\n"
+                       "    0 -2147483648 2147483647x%\n"
+                       "  (width 0.1500) (a   )\n" );
+}
+
+/**
+ * Writes a board sized s-expression stream through FILE_OUTPUTFORMATTER and
+ * checks the file content.  The save throughput is reported as a test message,
+ * run with --log_level=message to see it.
+ */
+BOOST_AUTO_TEST_CASE( FileSaveThroughput )
+{
+    const int   itemCount = 200000;
+    wxString    fileName = wxFileName::CreateTempFileName( wxT( "richio" ) );
+    size_t      expected = 0;
+    auto        start = std::chrono::steady_clock::now();
+
+    {
+        FILE_OUTPUTFORMATTER formatter( fileName );
+
+        for( int i = 0;  i < itemCount;  ++i )
+        {
+            expected += formatter.Print( 1, "(segment (start %s %s) (end %s %s) (width %s) "
+                                         "(layer %s) (net %d))\n",
+                                         "125.73", "-84.455", "128.27", "-84.455", "0.25",
+                                         formatter.Quotes( "F.Cu" ).c_str(), i );
+        }
+
+        formatter.Finish();
+    }
+
+    auto   stop = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>( stop - start ).count();
+
+    wxFFile file( fileName, wxT( "rb" ) );
+
+    BOOST_CHECK( file.IsOpened() );
+    BOOST_CHECK_EQUAL( (size_t) file.Length(), expected );
+
+    file.Close();
+    wxRemoveFile( fileName );
+
+    BOOST_TEST_MESSAGE( "FILE_OUTPUTFORMATTER: " << expected / ( 1024.0 * 1024.0 ) / seconds
+                        << " MiB/s" );
+}
+
+#ifdef __linux__
+/**
+ * Checks that a failed write is reported, both when the buffer fills up and when
+ * Finish() writes the last block.  /dev/full fails every write with ENOSPC.
+ */
+BOOST_AUTO_TEST_CASE( WriteErrorsAreReported )
+{
+    {
+        FILE_OUTPUTFORMATTER formatter( wxT( "/dev/full" ) );
+
+        formatter.Print( 0, "(kicad_pcb)\n" );
+        BOOST_CHECK_THROW( formatter.Finish(), IO_ERROR );
+    }
+
+    {
+        FILE_OUTPUTFORMATTER formatter( wxT( "/dev/full" ) );
+        std::string block( FILE_OUTPUTFMTBUFZ / 4, 'x' );
+
+        auto fill = [&]()
+        {
+            for( int i = 0;  i < 8;  ++i )
+                formatter.Print( 0, "%s", block.c_str() );
+        };
+
+        BOOST_CHECK_THROW( fill(), IO_ERROR );
+    }
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <geometry/rtree.h>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+typedef RTree<void*, int, 2, float> TEST_RTREE;
+
+/**
+ * Collects the data of the entries found by a search.
+ */
+struct COLLECTOR
+{
+    bool operator()( void* aData )
+    {
+        found.insert( aData );
+        return true;
+    }
+
+    std::set<void*> found;
+};
+
+/**
+ * Random boxes used to fill the trees.
+ */
+struct RANDOM_BOXES
+{
+    RANDOM_BOXES( int aCount ) :
+        mins( aCount * 2 ), maxs( aCount * 2 ), ids( aCount )
+    {
+        std::mt19937 rng( 1 );
+
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            mins[2 * ii]     = rng() % 1000000;
+            mins[2 * ii + 1] = rng() % 1000000;
+            maxs[2 * ii]     = mins[2 * ii] + rng() % 5000;
+            maxs[2 * ii + 1] = mins[2 * ii + 1] + rng() % 5000;
+            ids[ii]          = reinterpret_cast<void*>( (intptr_t) ii + 1 );
+        }
+    }
+
+    std::vector<int>   mins;
+    std::vector<int>   maxs;
+    std::vector<void*> ids;
+};
+
+
+/**
+ * Checks that a packed tree and a tree built by inserting the same entries one by one
+ * find the same entries.
+ */
+static void checkSameResults( TEST_RTREE& aTree, TEST_RTREE& aReference )
+{
+    std::mt19937 rng( 2 );
+
+    for( int ii = 0; ii < 500; ++ii )
+    {
+        int qmin[2] = { int( rng() % 1000000 ), int( rng() % 1000000 ) };
+        int qmax[2] = { qmin[0] + int( rng() % 50000 ), qmin[1] + int( rng() % 50000 ) };
+        COLLECTOR result, expected;
+
+        aTree.Search( qmin, qmax, result );
+        aReference.Search( qmin, qmax, expected );
+
+        BOOST_REQUIRE( result.found == expected.found );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( RTreeBulkLoad )
+
+/**
+ * Checks searching a packed tree, also after removing half of its entries.
+ */
+BOOST_AUTO_TEST_CASE( PackedTree )
+{
+    const int       count = 20000;
+    RANDOM_BOXES    boxes( count );
+    TEST_RTREE      packed, reference;
+
+    packed.BulkLoad( boxes.mins.data(), boxes.maxs.data(), boxes.ids.data(), count );
+
+    for( int ii = 0; ii < count; ++ii )
+        reference.Insert( &boxes.mins[2 * ii], &boxes.maxs[2 * ii], boxes.ids[ii] );
+
+    BOOST_CHECK_EQUAL( packed.Count(), count );
+    checkSameResults( packed, reference );
+
+    for( int ii = 0; ii < count; ii += 2 )
+    {
+        packed.Remove( &boxes.mins[2 * ii], &boxes.maxs[2 * ii], boxes.ids[ii] );
+        reference.Remove( &boxes.mins[2 * ii], &boxes.maxs[2 * ii], boxes.ids[ii] );
+    }
+
+    BOOST_CHECK_EQUAL( packed.Count(), count / 2 );
+    checkSameResults( packed, reference );
+}
+
+/**
+ * Checks that entries loaded into a tree that is not empty are added to the existing ones.
+ */
+BOOST_AUTO_TEST_CASE( LoadIntoFilledTree )
+{
+    const int       count = 1000;
+    RANDOM_BOXES    boxes( count );
+    TEST_RTREE      tree, reference;
+
+    tree.BulkLoad( boxes.mins.data(), boxes.maxs.data(), boxes.ids.data(), 5 );
+    tree.BulkLoad( &boxes.mins[10], &boxes.maxs[10], &boxes.ids[5], count - 5 );
+
+    for( int ii = 0; ii < count; ++ii )
+        reference.Insert( &boxes.mins[2 * ii], &boxes.maxs[2 * ii], boxes.ids[ii] );
+
+    BOOST_CHECK_EQUAL( tree.Count(), count );
+    checkSameResults( tree, reference );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <eda_search_index.h>
+#include <eda_pattern_match.h>
+
+#include <memory>
+#include <random>
+
+BOOST_AUTO_TEST_SUITE( SearchIndex )
+
+/**
+ * Checks the strings taken from the patterns to narrow the search.
+ */
+BOOST_AUTO_TEST_CASE( RequiredStrings )
+{
+    std::vector<std::wstring> strings;
+
+    EDA_SEARCH_INDEX::RequiredStrings( wxT( "soic*8?w" ), EDA_SEARCH_INDEX::MATCH_WILDCARD,
+                                       strings );
+    BOOST_CHECK( strings == std::vector<std::wstring>( { L"soic", L"8", L"w" } ) );
+
+    EDA_SEARCH_INDEX::RequiredStrings( wxT( "^sot-23x?.*_5\\.0+" ),
+                                       EDA_SEARCH_INDEX::MATCH_REGEX, strings );
+    BOOST_CHECK( strings == std::vector<std::wstring>( { L"sot-23", L"_5.0" } ) );
+
+    EDA_SEARCH_INDEX::RequiredStrings( wxT( "qfn(32|48)" ), EDA_SEARCH_INDEX::MATCH_REGEX,
+                                       strings );
+    BOOST_CHECK( strings.empty() );
+
+    EDA_SEARCH_INDEX::RequiredStrings( wxT( "r\\d+" ), EDA_SEARCH_INDEX::MATCH_REGEX,
+                                       strings );
+    BOOST_CHECK( strings.empty() );
+}
+
+/**
+ * Checks on random names and patterns that the candidates include all the names
+ * the matchers find the pattern in.
+ */
+BOOST_AUTO_TEST_CASE( CandidatesIncludeMatches )
+{
+    const wxString      alphabet = wxT( "abc01_-" );
+    const wxString      specials = wxT( "*?.+^$\\{}" );
+    std::mt19937        rng( 1 );
+    std::vector<wxString> names;
+    EDA_SEARCH_INDEX    index;
+
+    auto randomString = [&]( const wxString& aChars, int aMaxLength )
+    {
+        wxString str;
+        int      length = rng() % ( aMaxLength + 1 );
+
+        for( int ii = 0; ii < length; ++ii )
+            str += aChars[ rng() % aChars.length() ];
+
+        return str;
+    };
+
+    for( unsigned ii = 0; ii < 2000; ++ii )
+    {
+        names.push_back( randomString( alphabet, 12 ) );
+        index.AddText( ii, names.back() );
+    }
+
+    for( int test = 0; test < 500; ++test )
+    {
+        wxString pattern = randomString( alphabet + specials, 6 );
+
+        for( int type = EDA_SEARCH_INDEX::MATCH_SUBSTR; type <= EDA_SEARCH_INDEX::MATCH_REGEX;
+             ++type )
+        {
+            std::unique_ptr<EDA_PATTERN_MATCH> matcher;
+
+            switch( type )
+            {
+            case EDA_SEARCH_INDEX::MATCH_SUBSTR:
+                matcher.reset( new EDA_PATTERN_MATCH_SUBSTR() );
+                break;
+
+            case EDA_SEARCH_INDEX::MATCH_WILDCARD:
+                matcher.reset( new EDA_PATTERN_MATCH_WILDCARD() );
+                break;
+
+            default:
+                matcher.reset( new EDA_PATTERN_MATCH_REGEX() );
+                break;
+            }
+
+            if( !matcher->SetPattern( pattern ) )
+                continue;
+
+            std::vector<unsigned> candidates;
+
+            if( !index.FindCandidates( pattern, EDA_SEARCH_INDEX::MATCH_TYPE( type ),
+                                       candidates ) )
+                continue;
+
+            for( unsigned ii = 0; ii < names.size(); ++ii )
+            {
+                if( matcher->Find( names[ii] ) == EDA_PATTERN_NOT_FOUND )
+                    continue;
+
+                BOOST_CHECK_MESSAGE( std::binary_search( candidates.begin(), candidates.end(),
+                                                         ii ),
+                                     "'" << pattern << "' found in '" << names[ii]
+                                     << "' which is not a candidate" );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <base_struct.h>
+#include <painter.h>
+#include <view/view.h>
+#include <gal/graphics_abstraction_layer.h>
+
+#include <memory>
+#include <vector>
+
+using namespace KIGFX;
+
+/**
+ * GAL which, like the OpenGL one, may create groups only between BeginUpdate() and
+ * EndUpdate(). It counts the groups created and drawn.
+ */
+class UPDATE_CHECK_GAL : public GAL
+{
+public:
+    UPDATE_CHECK_GAL() :
+        updating( false ), groups( 0 ), groupsOutsideUpdate( 0 ), drawnGroups( 0 )
+    {
+        screenSize = VECTOR2I( 1000, 1000 );
+    }
+
+    void BeginUpdate() override { updating = true; }
+    void EndUpdate() override { updating = false; }
+
+    int BeginGroup() override
+    {
+        if( !updating )
+            groupsOutsideUpdate++;
+
+        return groups++;
+    }
+
+    void DrawGroup( int aGroupNumber ) override { drawnGroups++; }
+
+    bool updating;
+    int  groups;
+    int  groupsOutsideUpdate;
+    int  drawnGroups;
+};
+
+
+class NULL_PAINTER : public PAINTER
+{
+public:
+    NULL_PAINTER( GAL* aGal ) : PAINTER( aGal ) {}
+
+    void ApplySettings( const RENDER_SETTINGS* aSettings ) override {}
+    RENDER_SETTINGS* GetSettings() override { return NULL; }
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override { return true; }
+};
+
+
+/**
+ * Item shown on two layers.
+ */
+class TEST_ITEM : public EDA_ITEM
+{
+public:
+    TEST_ITEM( const BOX2I& aBox ) : EDA_ITEM( NOT_USED ), m_box( aBox ) {}
+
+    wxString GetClass() const override { return wxT( "TEST_ITEM" ); }
+
+    const BOX2I ViewBBox() const override { return m_box; }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 1;
+        aLayers[1] = 2;
+        aCount = 2;
+    }
+
+#if defined(DEBUG)
+    void Show( int nestLevel, std::ostream& os ) const override {}
+#endif
+
+private:
+    BOX2I m_box;
+};
+
+
+BOOST_AUTO_TEST_SUITE( ViewBulkAdd )
+
+/**
+ * Checks that the items added at once are cached by UpdateItems(), and not while redrawing,
+ * when the GAL cannot accept new groups.
+ */
+BOOST_AUTO_TEST_CASE( CachedByUpdateItems )
+{
+    const int           count = 100;
+    UPDATE_CHECK_GAL    gal;
+    NULL_PAINTER        painter( &gal );
+    VIEW                view( true );
+
+    view.SetPainter( &painter );
+    view.SetGAL( &gal );
+    view.SetLODThreshold( 0.0 );
+    view.SetScaleLimits( 1e9, 1e-9 );
+    view.SetViewport( BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( 1000000, 1000000 ) ) );
+
+    // Destroyed before the view, which they remove themselves from
+    std::vector< std::unique_ptr<TEST_ITEM> > items;
+    std::vector<VIEW_ITEM*>                   viewItems;
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        VECTOR2I origin( ( ii % 10 ) * 100000, ( ii / 10 ) * 100000 );
+
+        items.emplace_back( new TEST_ITEM( BOX2I( origin, VECTOR2I( 50000, 50000 ) ) ) );
+        viewItems.push_back( items.back().get() );
+    }
+
+    view.AddItems( viewItems );
+    view.UpdateItems();
+
+    BOOST_CHECK_EQUAL( gal.groups, 2 * count );
+
+    view.Redraw();
+
+    BOOST_CHECK_EQUAL( gal.groupsOutsideUpdate, 0 );
+    BOOST_CHECK_EQUAL( gal.groups, 2 * count );
+    BOOST_CHECK_EQUAL( gal.drawnGroups, 2 * count );
+}
+
+BOOST_AUTO_TEST_SUITE_END()